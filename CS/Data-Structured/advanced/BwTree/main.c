@@ -1,434 +1,1409 @@
 /*
  * Bw Tree Demo
  *
- * 이 예제는 실무에서 바로 사용할 수 있도록 고도화된 Bw Tree의 
- * 단순화된 시뮬레이션 구현 예제입니다.
+ * 이 예제는 실무에서 바로 사용할 수 있도록 고도화된 Bw Tree의
+ * 락-프리(latch-free) 구현 예제입니다.
  *
  * Bw Tree는 락-프리 B-트리 계열 인덱스 구조로, 매핑 테이블과 델타 레코드를
  * 활용하여 동시성을 극대화하고, 업데이트를 비파괴적으로 기록합니다.
  *
- * 본 데모에서는 단일 스레드 환경에서 기본 노드(Base Node)와 델타 레코드 체인을
- * 통해 삽입, 삭제, 업데이트, 검색 및 주기적 병합(consolidation) 기능을 시뮬레이션합니다.
+ * 구조:
+ *  - 매핑 테이블 (Mapping Table): 논리 페이지 ID(PID) → 페이지의 최신 물리 포인터(델타 체인의 맨 앞).
+ *      노드 사이의 링크(자식, 오른쪽 형제)는 모두 PID로 표현되므로, 페이지 갱신은
+ *      매핑 테이블 한 칸에 대한 CAS(compare-and-swap) 한 번으로 원자적으로 이루어집니다.
+ *  - 페이지 = 기본 노드(Base Node) + 델타 레코드 체인. 한 번 공개된 노드는 절대 수정되지 않습니다.
+ *      * 리프: DELTA_INSERT / DELTA_UPDATE / DELTA_DELETE
+ *      * 구조 변경(SMO): DELTA_SPLIT, DELTA_INDEX_ENTRY(부모에 분할 반영),
+ *        DELTA_REMOVE_NODE, DELTA_MERGE, DELTA_INDEX_DELETE(부모에 병합 반영)
+ *  - B-link 구조: 모든 노드는 key 범위 [low, high)와 오른쪽 형제 PID를 가지므로,
+ *      분할이 부모에 반영되기 전에도 오른쪽으로 이동하여 올바른 노드에 도달합니다.
+ *  - 도움(helping): 미완료 SMO를 발견한 스레드는 대기하지 않고 남은 단계를 대신 완료합니다.
+ *  - 에포크 기반 메모리 회수 (Epoch-Based Reclamation): 병합(consolidation)으로 교체된 델타 체인은
+ *      즉시 해제하지 않고, 그 시점에 진행 중이던 모든 스레드가 연산을 마친 뒤에 해제합니다.
+ *      스레드는 트리마다 에포크 슬롯을 하나 빌려 쓰고 종료할 때 반납하므로, BW_MAX_THREADS는
+ *      동시에 트리를 사용하는 스레드 수의 제한입니다.
  *
  * 주요 기능:
- *  - bw_tree_insert(): 새 키-값 쌍을 델타 레코드로 기록합니다.
+ *  - bw_tree_insert(): 새 키-값 쌍을 델타 레코드로 기록합니다. (이미 있으면 덮어씀)
  *  - bw_tree_delete(): 키 삭제 연산을 델타 레코드로 기록합니다.
- *  - bw_tree_update(): 키 업데이트 연산을 델타 레코드로 기록합니다.
- *  - bw_tree_search(): 기본 노드와 델타 레코드 체인을 적용하여 최신 값을 반환합니다.
- *  - consolidate_bw_tree(): 누적된 델타 레코드들을 기본 노드에 병합하여, 
- *       델타 체인을 초기화하고 검색 효율성을 회복합니다.
+ *  - bw_tree_update(): 키가 존재할 때만 업데이트 연산을 델타 레코드로 기록합니다.
+ *  - bw_tree_search(): 매핑 테이블을 따라 리프를 찾고, 델타 체인과 기본 노드에서 최신 값을 반환합니다.
+ *  - consolidate_bw_tree(): 모든 페이지의 델타 체인을 새 기본 노드로 병합합니다.
+ *       (델타 체인이 페이지별 임계치에 도달하면 연산을 수행한 스레드가 자동으로 병합)
  *
- * 주의: 이 예제는 단순화를 위한 시뮬레이션 코드이며, 
- * 실제 락-프리 구현 및 동시성 제어, 원자적 연산, 메모리 관리 등은 별도로 구현되어야 합니다.
+ * 긴 델타 체인 대응:
+ *  - 적응형 consolidation: 페이지마다 최근 읽기/쓰기 횟수를 세어, 읽기 위주 페이지는 체인을 짧게
+ *      (DELTA_MIN_THRESHOLD), 쓰기 위주 페이지는 길게(DELTA_MAX_THRESHOLD) 허용하여 병합 비용을 분산합니다.
+ *  - 체인 요약(summary): 리프 델타가 SUMMARY_STRIDE개 쌓일 때마다 새 델타에 "아래 델타들의 key별 최신 기록"을
+ *      정렬된 배열로 붙입니다. 검색은 최대 SUMMARY_STRIDE - 1개의 델타만 순서대로 보고, 이후는 이진 탐색으로
+ *      처리하므로 쓰기가 몰리는 페이지에서도 O(log n)에 가깝게 유지됩니다.
+ *      요약도 델타와 함께 CAS 전에 만들어지는 불변 데이터이므로 reader는 여전히 락 없이 진행합니다.
+ *
+ * 컴파일 예시: gcc -Wall -O2 -pthread main.c -o bwtree
+ *
+ * 주의: 이 예제는 교육 목적의 구현이며, 단순화를 위해 다음을 생략합니다.
+ *  - 내부 노드 병합 (리프 병합만 지원), PID 재사용
+ *  - 병합으로 제거된 페이지의 REMOVE 델타는 오래된 경로로 도착한 스레드를 안내하기 위해 트리 해제 시까지 유지
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DELTA_MIN_THRESHOLD 4    // 읽기 위주 페이지(및 내부 노드)의 consolidation 임계치
+#define DELTA_MAX_THRESHOLD 64   // 쓰기 위주 페이지의 consolidation 임계치
+#define SUMMARY_STRIDE 8         // 요약 없는 리프 델타가 이만큼 쌓이면 새 델타에 정렬된 요약을 붙임
+#define PAGE_STATS_WINDOW 1024   // 페이지별 읽기/쓰기 횟수가 이만큼 쌓이면 절반으로 줄여 최근 경향을 반영
+#define LEAF_MAX_ITEMS 8         // 병합 결과가 이보다 크면 리프 분할 (데모용으로 작게 설정)
+#define LEAF_MIN_ITEMS 2         // 병합 결과가 이보다 작으면 왼쪽 형제와 리프 병합
+#define INNER_MAX_ENTRIES 8      // 내부 노드 분할 임계치
+#define MAPPING_TABLE_SIZE (1 << 20)
+#define BW_MAX_DEPTH 32
+#define BW_MAX_THREADS 64        // 한 트리를 동시에 사용할 수 있는 스레드 수 (에포크 슬롯 수)
+#define BW_THREAD_TREES 8        // 스레드마다 슬롯을 기억해 두는 트리 수 (넘으면 다른 트리의 슬롯을 반납하고 재사용)
+#define EPOCH_RECLAIM_INTERVAL 64 // 스레드별로 이 수만큼 회수 대상이 쌓이면 에포크를 올리고 회수 시도
 
-#define INITIAL_BASE_CAPACITY 8
-#define DELTA_THRESHOLD 4   // 델타 레코드 누적 임계치에 도달하면 병합(consolidation) 수행
+typedef uint32_t PID;
+#define INVALID_PID UINT32_MAX
 
-/* 델타 레코드 타입 */
+/* 노드(기본 노드 및 델타 레코드) 타입 */
 typedef enum {
+    NODE_LEAF_BASE,
+    NODE_INNER_BASE,
     DELTA_INSERT,
     DELTA_DELETE,
-    DELTA_UPDATE
-} DeltaType;
+    DELTA_UPDATE,
+    DELTA_SPLIT,        // 이 노드의 [key, high) 범위가 오른쪽 형제(right)로 이동됨
+    DELTA_INDEX_ENTRY,  // 부모: [key, key2) 범위는 child로
+    DELTA_REMOVE_NODE,  // 이 페이지는 왼쪽 형제로 병합되는 중 (더 이상 갱신 불가)
+    DELTA_MERGE,        // 왼쪽 형제: [key, high) 범위의 내용은 merged에 있음
+    DELTA_INDEX_DELETE  // 부모: [key, key2) 범위는 (병합을 흡수한) child로
+} NodeType;
+
+/* 델타 체인 요약의 항목: key별 최신 기록 */
+typedef struct {
+    int key;
+    int value;
+    bool deleted;
+} SummaryEntry;
 
-/* 델타 레코드 구조체: 모든 수정 연산을 기록 */
-typedef struct DeltaRecord {
-    DeltaType type;
+/*
+ * 노드 구조체: 기본 노드와 델타 레코드를 하나의 구조체로 표현
+ * 페이지의 범위/형제/높이 정보는 모든 노드에 복사해 두므로, 체인의 맨 앞 노드만 보고 알 수 있음
+ */
+typedef struct BwNode {
+    NodeType type;
+    int level;              // 0 = 리프
+    int chain_length;       // 이 노드 아래 델타 레코드 수 (기본 노드는 0)
+    int low_key;            // 페이지 범위의 하한 (has_low가 false이면 -∞)
+    int high_key;           // 페이지 범위의 상한 (has_high가 false이면 +∞)
+    bool has_low;
+    bool has_high;
+    PID right;              // 오른쪽 형제 페이지
+    struct BwNode *next;    // 델타가 덧붙여진 아래 노드 (기본 노드는 NULL)
+
+    // 델타 레코드 필드
     int key;
-    int value;  // INSERT/UPDATE시 사용, DELETE시 무시
-    struct DeltaRecord *next;
-} DeltaRecord;
+    int value;
+    int key2;               // INDEX_ENTRY/INDEX_DELETE: 범위 상한
+    bool has_key2;
+    PID child;              // INDEX_ENTRY/INDEX_DELETE: 대상 자식 페이지
+    PID old_child;          // INDEX_DELETE: 제거된 자식 페이지
+    struct BwNode *merged;  // MERGE: 흡수한 오른쪽 페이지의 내용 (REMOVE 델타 아래 체인)
 
-/* 기본 노드(Base Node) 구조체: 안정적인, 정렬된 키-값 배열 */
-typedef struct BaseNode {
+    // 리프 델타(INSERT/UPDATE/DELETE) 체인 요약
+    int unsummarized;             // 이 노드를 포함하여 가장 가까운 요약 이후 쌓인 리프 델타 수
+    int summary_count;
+    SummaryEntry *summary;        // key 오름차순. 이 노드부터 summary_next 전까지의 최신 기록
+    struct BwNode *summary_next;  // 요약에 없는 key를 이어서 찾을 노드 (SPLIT/MERGE 델타 또는 기본 노드)
+
+    // 기본 노드 필드: keys는 정렬되어 있음
+    // 내부 노드는 keys[i]가 children[i]의 하한 (keys[0]은 노드의 하한)
+    int count;
     int *keys;
     int *values;
-    int count;
-    int capacity;
-} BaseNode;
+    PID *children;
+} BwNode;
+
+/* 에포크 슬롯: 스레드별 현재 에포크와 회수 대기 목록 (캐시 라인 공유를 피하기 위해 패딩) */
+typedef struct Garbage {
+    BwNode *node;
+    uint64_t epoch;
+    struct Garbage *next;
+} Garbage;
+
+typedef struct {
+    _Atomic uint64_t epoch;  // 0이면 연산 중이 아님
+    atomic_bool in_use;      // 슬롯을 빌려 쓰는 스레드가 있음
+    int depth;               // 중첩된 연산 깊이 (도움 연산 포함)
+    Garbage *garbage;        // 이 스레드가 교체한 체인 (소유 스레드만 접근, 반납하면 다음 소유자가 이어서 회수)
+    int retired;             // 마지막 회수 시도 이후 추가된 회수 대상 수
+    char pad[64];
+} EpochSlot;
+
+/* 통계 */
+typedef struct {
+    atomic_llong consolidations;
+    atomic_llong splits;
+    atomic_llong merges;
+    atomic_llong cas_failures;
+    atomic_llong reclaimed;
+    atomic_llong summaries;
+} BwStats;
 
-/* Bw Tree 구조체: 하나의 기본 노드와 델타 레코드 체인을 관리 */
+/* 페이지별 최근 읽기/쓰기 횟수 (적응형 consolidation 임계치 계산용, 근사값) */
+typedef struct {
+    atomic_uint reads;
+    atomic_uint writes;
+} PageStats;
+
+/* Bw Tree 구조체: 매핑 테이블, 루트 PID, 에포크 관리 */
 typedef struct BwTree {
-    BaseNode *base;         // 정렬된 기본 노드
-    DeltaRecord *delta;     // 델타 레코드 체인 (최신 레코드가 앞쪽에 위치)
+    _Atomic(BwNode *) *mapping;   // PID → 페이지의 최신 노드
+    PageStats *page_stats;        // PID별 읽기/쓰기 횟수
+    atomic_uint next_pid;
+    _Atomic PID root;
+    _Atomic uint64_t global_epoch;
+    EpochSlot slots[BW_MAX_THREADS];
+    atomic_int num_slots;         // 한 번이라도 사용된 슬롯 수 (회수 시 이만큼만 확인)
+    uint64_t id;                  // 트리마다 고유한 번호 (해제된 트리와 같은 주소에 만들어져도 구별)
+    struct BwTree *next_live;     // 살아 있는 트리 목록 (bw_registry_lock으로 보호)
+    BwStats stats;
 } BwTree;
 
 /* 함수 프로토타입 */
 BwTree* create_bw_tree();
 void free_bw_tree(BwTree *tree);
-BaseNode* create_base_node(int capacity);
-void free_base_node(BaseNode *base);
-void base_node_insert(BaseNode *base, int key, int value);
-int base_node_search(BaseNode *base, int key, bool *found);
-void base_node_delete(BaseNode *base, int key);
 void consolidate_bw_tree(BwTree *tree);
 void bw_tree_insert(BwTree *tree, int key, int value);
-void bw_tree_delete(BwTree *tree, int key);
-void bw_tree_update(BwTree *tree, int key, int value);
+bool bw_tree_delete(BwTree *tree, int key);
+bool bw_tree_update(BwTree *tree, int key, int value);
 bool bw_tree_search(BwTree *tree, int key, int *value);
 void bw_tree_print(BwTree *tree);
 
-/* --- Base Node Functions --- */
+static PID bw_find(BwTree *tree, int key, int level, PID *path, int *depth, BwNode **top);
+static PID complete_merge(BwTree *tree, PID rpid, BwNode *rm);
+static void try_consolidate(BwTree *tree, PID pid, BwNode *top, PID *path, int depth);
+
+/* --- 에포크 기반 메모리 회수 --- */
+
+/* 살아 있는 트리 목록: 스레드가 종료하며 슬롯을 반납할 때 트리가 아직 있는지 확인 */
+static pthread_mutex_t bw_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static BwTree *bw_live_trees = NULL;
+static uint64_t bw_next_tree_id = 1;
+
+/* 스레드별 슬롯 캐시: (트리 주소, 트리 번호) → 빌려 쓰는 슬롯. 스레드가 종료하면 모두 반납 */
+typedef struct {
+    struct {
+        BwTree *tree;
+        uint64_t id;
+        int slot;
+    } entries[BW_THREAD_TREES];
+    int count;
+    int victim;   // 캐시가 가득 찼을 때 다음에 반납할 항목
+} EpochCache;
+
+static pthread_key_t bw_cache_key;
+static pthread_once_t bw_cache_once = PTHREAD_ONCE_INIT;
+static _Thread_local EpochCache *tls_cache = NULL;
+
+/* 슬롯 반납: 트리가 이미 해제되었으면 슬롯도 함께 사라졌으므로 할 일이 없음.
+ * 그 트리의 연산 도중이면(중첩) 반납할 수 없으므로 false */
+static bool release_slot(BwTree *tree, uint64_t id, int slot) {
+    bool released = true;
+    pthread_mutex_lock(&bw_registry_lock);
+    BwTree *t = bw_live_trees;
+    while (t && t != tree)
+        t = t->next_live;
+    if (t && t->id == id) {
+        if (tree->slots[slot].depth > 0)
+            released = false;
+        else
+            atomic_store_explicit(&tree->slots[slot].in_use, false, memory_order_release);
+    }
+    pthread_mutex_unlock(&bw_registry_lock);
+    return released;
+}
+
+static void epoch_cache_destroy(void *arg) {
+    EpochCache *cache = (EpochCache *)arg;
+    for (int i = 0; i < cache->count; i++)
+        release_slot(cache->entries[i].tree, cache->entries[i].id, cache->entries[i].slot);
+    free(cache);
+}
+
+static void epoch_cache_key_init(void) {
+    if (pthread_key_create(&bw_cache_key, epoch_cache_destroy) != 0) {
+        fprintf(stderr, "Bw Tree: pthread_key_create 실패\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* 비어 있는 슬롯을 빌림 (반납된 슬롯 재사용) */
+static int acquire_slot(BwTree *tree) {
+    for (int i = 0; i < BW_MAX_THREADS; i++) {
+        bool expected = false;
+        if (atomic_load_explicit(&tree->slots[i].in_use, memory_order_relaxed) ||
+            !atomic_compare_exchange_strong(&tree->slots[i].in_use, &expected, true))
+            continue;
+        int used = atomic_load(&tree->num_slots);
+        while (used < i + 1 && !atomic_compare_exchange_weak(&tree->num_slots, &used, i + 1))
+            ;
+        return i;
+    }
+    fprintf(stderr, "Bw Tree: 동시에 사용하는 스레드 수가 BW_MAX_THREADS(%d)를 초과했습니다\n", BW_MAX_THREADS);
+    exit(EXIT_FAILURE);
+}
+
+/* 캐시에 없는 트리: 슬롯을 빌려 캐시에 기록 */
+static EpochSlot* epoch_register(BwTree *tree) {
+    EpochCache *cache = tls_cache;
+    if (!cache) {
+        pthread_once(&bw_cache_once, epoch_cache_key_init);
+        cache = (EpochCache *)calloc(1, sizeof(EpochCache));
+        if (!cache || pthread_setspecific(bw_cache_key, cache) != 0) {
+            fprintf(stderr, "EpochCache 메모리 할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+        tls_cache = cache;
+    }
+    // 같은 주소의 항목은 해제된 트리의 것이므로 그대로 덮어씀
+    int e = -1;
+    for (int i = 0; i < cache->count && e < 0; i++)
+        if (cache->entries[i].tree == tree)
+            e = i;
+    if (e < 0 && cache->count < BW_THREAD_TREES)
+        e = cache->count++;
+    for (int tries = 0; e < 0 && tries < BW_THREAD_TREES; tries++) {
+        int v = cache->victim;
+        cache->victim = (v + 1) % BW_THREAD_TREES;
+        if (release_slot(cache->entries[v].tree, cache->entries[v].id, cache->entries[v].slot))
+            e = v;
+    }
+    if (e < 0) {
+        fprintf(stderr, "Bw Tree: 한 스레드에서 중첩된 트리 연산이 BW_THREAD_TREES(%d)를 초과했습니다\n",
+                BW_THREAD_TREES);
+        exit(EXIT_FAILURE);
+    }
+    cache->entries[e].tree = tree;
+    cache->entries[e].id = tree->id;
+    cache->entries[e].slot = acquire_slot(tree);
+    return &tree->slots[cache->entries[e].slot];
+}
+
+/* 현재 스레드가 사용하는 에포크 슬롯 (트리별로 처음 사용할 때 빌림) */
+static EpochSlot* epoch_slot(BwTree *tree) {
+    EpochCache *cache = tls_cache;
+    if (cache) {
+        for (int i = 0; i < cache->count; i++)
+            if (cache->entries[i].tree == tree && cache->entries[i].id == tree->id)
+                return &tree->slots[cache->entries[i].slot];
+    }
+    return epoch_register(tree);
+}
+
+/* 연산 시작: 현재 전역 에포크를 공개하여, 이후 교체되는 노드가 해제되지 않도록 보호 */
+static void epoch_enter(BwTree *tree) {
+    EpochSlot *slot = epoch_slot(tree);
+    if (slot->depth++ == 0) {
+        // 공개하는 사이에 전역 에포크가 바뀌었다면 다시 공개 (회수 스레드가 옛 값을 보지 않도록)
+        uint64_t e;
+        do {
+            e = atomic_load(&tree->global_epoch);
+            atomic_store(&slot->epoch, e);
+        } while (atomic_load(&tree->global_epoch) != e);
+    }
+}
+
+static void epoch_exit(BwTree *tree) {
+    EpochSlot *slot = epoch_slot(tree);
+    if (--slot->depth == 0)
+        atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+}
+
+/* 체인 해제: 기본 노드까지 내려가며 해제 (MERGE는 흡수한 체인도 소유, REMOVE는 자기 자신만 소유) */
+static void free_chain(BwNode *node) {
+    while (node) {
+        BwNode *next = node->next;
+        if (node->type == DELTA_MERGE)
+            free_chain(node->merged);
+        free(node->summary);
+        if (node->type == NODE_LEAF_BASE || node->type == NODE_INNER_BASE) {
+            free(node->keys);
+            free(node->values);
+            free(node->children);
+            next = NULL;
+        } else if (node->type == DELTA_REMOVE_NODE) {
+            next = NULL;
+        }
+        free(node);
+        node = next;
+    }
+}
+
+/* 회수: 회수 시점의 에포크가 모든 진행 중인 스레드의 에포크보다 작으면 더 이상 접근하는 스레드가 없음 */
+static void epoch_reclaim(BwTree *tree, EpochSlot *slot) {
+    uint64_t min_epoch = atomic_fetch_add(&tree->global_epoch, 1) + 1;
+    int num_slots = atomic_load(&tree->num_slots);
+    for (int i = 0; i < num_slots && i < BW_MAX_THREADS; i++) {
+        uint64_t e = atomic_load(&tree->slots[i].epoch);
+        if (e != 0 && e < min_epoch)
+            min_epoch = e;
+    }
+    Garbage **pp = &slot->garbage;
+    while (*pp) {
+        Garbage *g = *pp;
+        if (g->epoch < min_epoch) {
+            *pp = g->next;
+            free_chain(g->node);
+            free(g);
+            atomic_fetch_add_explicit(&tree->stats.reclaimed, 1, memory_order_relaxed);
+        } else {
+            pp = &g->next;
+        }
+    }
+}
+
+/* 매핑 테이블에서 떼어낸 체인을 회수 대기 목록에 추가 */
+static void epoch_retire(BwTree *tree, BwNode *node) {
+    EpochSlot *slot = epoch_slot(tree);
+    Garbage *g = (Garbage *)malloc(sizeof(Garbage));
+    if (!g) {
+        fprintf(stderr, "Garbage 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    g->node = node;
+    g->epoch = atomic_load(&tree->global_epoch);
+    g->next = slot->garbage;
+    slot->garbage = g;
+    if (++slot->retired >= EPOCH_RECLAIM_INTERVAL) {
+        slot->retired = 0;
+        epoch_reclaim(tree, slot);
+    }
+}
+
+/* --- 매핑 테이블 --- */
+
+static BwNode* load_page(BwTree *tree, PID pid) {
+    return atomic_load_explicit(&tree->mapping[pid], memory_order_acquire);
+}
+
+/* 페이지의 맨 앞 노드를 expected → desired로 교체 (실패하면 다른 스레드가 먼저 갱신한 것) */
+static bool cas_page(BwTree *tree, PID pid, BwNode *expected, BwNode *desired) {
+    if (atomic_compare_exchange_strong_explicit(&tree->mapping[pid], &expected, desired,
+                                                memory_order_acq_rel, memory_order_acquire))
+        return true;
+    atomic_fetch_add_explicit(&tree->stats.cas_failures, 1, memory_order_relaxed);
+    return false;
+}
+
+static PID alloc_pid(BwTree *tree, BwNode *node) {
+    PID pid = atomic_fetch_add(&tree->next_pid, 1);
+    if (pid >= MAPPING_TABLE_SIZE) {
+        fprintf(stderr, "Bw Tree: 매핑 테이블이 가득 찼습니다\n");
+        exit(EXIT_FAILURE);
+    }
+    atomic_store_explicit(&tree->mapping[pid], node, memory_order_release);
+    return pid;
+}
+
+/* --- 적응형 consolidation --- */
+
+/* 페이지 접근 기록: 합이 PAGE_STATS_WINDOW를 넘으면 둘 다 절반으로 줄임 (동시 갱신으로 약간 부정확해도 무방) */
+static void page_stats_note(BwTree *tree, PID pid, bool write) {
+    PageStats *ps = &tree->page_stats[pid];
+    unsigned reads = atomic_load_explicit(&ps->reads, memory_order_relaxed);
+    unsigned writes = atomic_load_explicit(&ps->writes, memory_order_relaxed);
+    if (reads + writes >= PAGE_STATS_WINDOW) {
+        atomic_store_explicit(&ps->reads, reads / 2, memory_order_relaxed);
+        atomic_store_explicit(&ps->writes, writes / 2, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(write ? &ps->writes : &ps->reads, 1, memory_order_relaxed);
+}
+
+/*
+ * 페이지의 consolidation 임계치: 쓰기 비율에 비례하여 DELTA_MIN_THRESHOLD ~ DELTA_MAX_THRESHOLD
+ *  - 읽기 위주: 체인을 짧게 유지하여 검색 비용을 줄임
+ *  - 쓰기 위주: 병합(페이지 전체 복사)을 미뤄 여러 쓰기에 분산. 긴 체인의 검색은 요약이 보완
+ * 내부 노드는 모든 탐색이 지나가므로 항상 최소 임계치 사용
+ */
+static int consolidate_threshold(BwTree *tree, PID pid, const BwNode *top) {
+    if (top->level > 0)
+        return DELTA_MIN_THRESHOLD;
+    PageStats *ps = &tree->page_stats[pid];
+    unsigned reads = atomic_load_explicit(&ps->reads, memory_order_relaxed);
+    unsigned writes = atomic_load_explicit(&ps->writes, memory_order_relaxed);
+    return DELTA_MIN_THRESHOLD +
+           (int)((unsigned long long)(DELTA_MAX_THRESHOLD - DELTA_MIN_THRESHOLD) * writes / (reads + writes + 1));
+}
 
-/* 새 기본 노드 생성 */
-BaseNode* create_base_node(int capacity) {
-    BaseNode *base = (BaseNode *)malloc(sizeof(BaseNode));
-    if (!base) {
-        fprintf(stderr, "BaseNode 메모리 할당 실패\n");
+/* --- 노드 생성 --- */
+
+static BwNode* alloc_node(NodeType type) {
+    BwNode *node = (BwNode *)calloc(1, sizeof(BwNode));
+    if (!node) {
+        fprintf(stderr, "BwNode 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    base->keys = (int *)malloc(sizeof(int) * capacity);
-    base->values = (int *)malloc(sizeof(int) * capacity);
-    if (!base->keys || !base->values) {
+    node->type = type;
+    node->right = INVALID_PID;
+    node->child = INVALID_PID;
+    node->old_child = INVALID_PID;
+    return node;
+}
+
+/* top 위에 덧붙일 델타 생성: 페이지 정보(범위, 형제, 높이)를 그대로 복사 */
+static BwNode* create_delta(NodeType type, BwNode *top) {
+    BwNode *d = alloc_node(type);
+    d->level = top->level;
+    d->chain_length = top->chain_length + 1;
+    d->low_key = top->low_key;
+    d->has_low = top->has_low;
+    d->high_key = top->high_key;
+    d->has_high = top->has_high;
+    d->right = top->right;
+    d->next = top;
+    return d;
+}
+
+/* 기본 노드 생성: 배열은 복사하여 소유 */
+static BwNode* create_base(NodeType type, int level, const int *keys, const int *values, const PID *children,
+                           int count, const BwNode *range) {
+    BwNode *node = alloc_node(type);
+    node->level = level;
+    node->count = count;
+    node->low_key = range->low_key;
+    node->has_low = range->has_low;
+    node->high_key = range->high_key;
+    node->has_high = range->has_high;
+    node->right = range->right;
+    int capacity = count > 0 ? count : 1;
+    node->keys = (int *)malloc(sizeof(int) * capacity);
+    if (!node->keys) {
         fprintf(stderr, "BaseNode 배열 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    base->count = 0;
-    base->capacity = capacity;
-    return base;
+    if (count > 0)
+        memcpy(node->keys, keys, sizeof(int) * count);
+    if (type == NODE_LEAF_BASE) {
+        node->values = (int *)malloc(sizeof(int) * capacity);
+        if (!node->values) {
+            fprintf(stderr, "BaseNode 배열 메모리 할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+        if (count > 0)
+            memcpy(node->values, values, sizeof(int) * count);
+    } else {
+        node->children = (PID *)malloc(sizeof(PID) * capacity);
+        if (!node->children) {
+            fprintf(stderr, "BaseNode 배열 메모리 할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(node->children, children, sizeof(PID) * count);
+    }
+    return node;
 }
 
-/* 기본 노드 메모리 해제 */
-void free_base_node(BaseNode *base) {
-    if (base) {
-        free(base->keys);
-        free(base->values);
-        free(base);
+/* --- 논리적 페이지 내용 --- */
+
+/* 기본 노드에서 키 검색 (이진 탐색) */
+static int base_lower_bound(const BwNode *base, int key) {
+    int low = 0, high = base->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (base->keys[mid] < key)
+            low = mid + 1;
+        else
+            high = mid;
     }
+    return low;
 }
 
-/* 기본 노드에 키-값 삽입 (정렬된 순서 유지) */
-void base_node_insert(BaseNode *base, int key, int value) {
-    // 이진 탐색으로 삽입 위치 결정 (단순 선형 탐색 사용)
-    int i = 0;
-    while (i < base->count && base->keys[i] < key) {
-        i++;
+/* --- 델타 체인 요약 --- */
+
+static bool is_leaf_record(const BwNode *node) {
+    return node->type == DELTA_INSERT || node->type == DELTA_UPDATE || node->type == DELTA_DELETE;
+}
+
+/* 요약에서 key의 위치 (이진 탐색, 없으면 -1) */
+static int summary_find(const BwNode *node, int key) {
+    int low = 0, high = node->summary_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (node->summary[mid].key < key)
+            low = mid + 1;
+        else
+            high = mid;
     }
-    // 키 중복이 있으면 업데이트
-    if (i < base->count && base->keys[i] == key) {
-        base->values[i] = value;
+    return low < node->summary_count && node->summary[low].key == key ? low : -1;
+}
+
+/*
+ * 새 리프 델타 d(아직 공개 전)의 요약 정보 설정
+ * 요약 없이 쌓인 리프 델타가 SUMMARY_STRIDE개가 되면, 그 델타들의 기록(최신 우선, key별 하나)을
+ * 바로 아래 요약과 병합하여 d에 붙임. 따라서 검색은 요약을 만나기 전까지 SUMMARY_STRIDE - 1개의 델타만 봄
+ */
+static void attach_summary(BwTree *tree, BwNode *d) {
+    d->unsummarized = is_leaf_record(d->next) ? d->next->unsummarized + 1 : 1;
+    if (d->unsummarized < SUMMARY_STRIDE)
         return;
+
+    // 요약이 없는 델타들의 기록: 최신 것부터 삽입 정렬 (같은 key는 먼저 들어간 최신 기록만 유지)
+    SummaryEntry fresh[SUMMARY_STRIDE];
+    int n = 0;
+    const BwNode *node = d;
+    while (is_leaf_record(node) && node->summary == NULL) {
+        int pos = n;
+        while (pos > 0 && fresh[pos - 1].key > node->key)
+            pos--;
+        if (pos == 0 || fresh[pos - 1].key != node->key) {
+            memmove(&fresh[pos + 1], &fresh[pos], sizeof(SummaryEntry) * (n - pos));
+            fresh[pos] = (SummaryEntry){ node->key, node->value, node->type == DELTA_DELETE };
+            n++;
+        }
+        node = node->next;
     }
-    // 배열 확장이 필요하면 재할당
-    if (base->count == base->capacity) {
-        base->capacity *= 2;
-        base->keys = (int *)realloc(base->keys, sizeof(int) * base->capacity);
-        base->values = (int *)realloc(base->values, sizeof(int) * base->capacity);
-        if (!base->keys || !base->values) {
-            fprintf(stderr, "BaseNode 재할당 실패\n");
-            exit(EXIT_FAILURE);
+
+    // 아래 요약(더 오래된 기록)과 병합: 같은 key는 새 기록이 우선
+    const SummaryEntry *older = NULL;
+    int older_count = 0;
+    if (is_leaf_record(node)) {
+        older = node->summary;
+        older_count = node->summary_count;
+        d->summary_next = node->summary_next;
+    } else {
+        d->summary_next = (BwNode *)node;
+    }
+    d->summary = (SummaryEntry *)malloc(sizeof(SummaryEntry) * (n + older_count));
+    if (!d->summary) {
+        fprintf(stderr, "Summary 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    int i = 0, j = 0, k = 0;
+    while (i < n || j < older_count) {
+        if (j == older_count || (i < n && fresh[i].key <= older[j].key)) {
+            if (j < older_count && fresh[i].key == older[j].key)
+                j++;
+            d->summary[k++] = fresh[i++];
+        } else {
+            d->summary[k++] = older[j++];
+        }
+    }
+    d->summary_count = k;
+    d->unsummarized = 0;
+    atomic_fetch_add_explicit(&tree->stats.summaries, 1, memory_order_relaxed);
+}
+
+/* 공개되지 못한(CAS 실패) 델타 하나를 해제 */
+static void free_delta(BwNode *d) {
+    free(d->summary);
+    free(d);
+}
+
+/*
+ * 리프 페이지에서 key의 최신 상태를 찾음: 델타 체인(최신이 앞쪽)을 따라가다 처음 만나는 기록이 정답
+ * 요약이 붙은 델타를 만나면 요약을 이진 탐색하고, 없으면 요약이 덮는 델타들을 건너뜀
+ */
+static bool leaf_lookup(const BwNode *node, int key, int *value) {
+    while (node) {
+        if (node->summary) {
+            int i = summary_find(node, key);
+            if (i >= 0) {
+                *value = node->summary[i].value;
+                return !node->summary[i].deleted;
+            }
+            node = node->summary_next;
+            continue;
+        }
+        switch (node->type) {
+        case DELTA_INSERT:
+        case DELTA_UPDATE:
+            if (node->key == key) {
+                *value = node->value;
+                return true;
+            }
+            break;
+        case DELTA_DELETE:
+            if (node->key == key)
+                return false;
+            break;
+        case DELTA_MERGE:
+            // 병합 지점 이상의 key는 흡수한 오른쪽 페이지의 내용에서 찾음
+            if (key >= node->key) {
+                node = node->merged;
+                continue;
+            }
+            break;
+        case NODE_LEAF_BASE: {
+            int i = base_lower_bound(node, key);
+            if (i < node->count && node->keys[i] == key) {
+                *value = node->values[i];
+                return true;
+            }
+            return false;
+        }
+        default:   // SPLIT: 범위 밖 key는 이미 오른쪽으로 이동했으므로 그대로 통과
+            break;
+        }
+        node = node->next;
+    }
+    return false;
+}
+
+/* 내부 페이지에서 key가 속한 자식 PID를 찾음 */
+static PID inner_route(const BwNode *node, int key) {
+    while (node) {
+        if (node->type == DELTA_INDEX_ENTRY || node->type == DELTA_INDEX_DELETE) {
+            if (key >= node->key && (!node->has_key2 || key < node->key2))
+                return node->child;
+        } else if (node->type == NODE_INNER_BASE) {
+            int i = base_lower_bound(node, key);
+            if (i == node->count || node->keys[i] > key)
+                i--;
+            return node->children[i < 0 ? 0 : i];
         }
+        node = node->next;
     }
-    // 삽입: 오른쪽으로 shift
-    for (int j = base->count; j > i; j--) {
-        base->keys[j] = base->keys[j-1];
-        base->values[j] = base->values[j-1];
+    return INVALID_PID;
+}
+
+/* 병합(consolidation)용 임시 배열 */
+typedef struct {
+    int *keys;
+    int *values;   // 리프
+    PID *children; // 내부 노드
+    int count;
+    int capacity;
+} ItemArray;
+
+static void items_reserve(ItemArray *a, int capacity) {
+    if (capacity <= a->capacity)
+        return;
+    while (a->capacity < capacity)
+        a->capacity = a->capacity ? a->capacity * 2 : 16;
+    a->keys = (int *)realloc(a->keys, sizeof(int) * a->capacity);
+    a->values = (int *)realloc(a->values, sizeof(int) * a->capacity);
+    a->children = (PID *)realloc(a->children, sizeof(PID) * a->capacity);
+    if (!a->keys || !a->values || !a->children) {
+        fprintf(stderr, "병합 배열 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
     }
-    base->keys[i] = key;
-    base->values[i] = value;
-    base->count++;
 }
 
-/* 기본 노드에서 키 검색 */
-int base_node_search(BaseNode *base, int key, bool *found) {
-    int low = 0, high = base->count - 1;
-    while (low <= high) {
+static void items_free(ItemArray *a) {
+    free(a->keys);
+    free(a->values);
+    free(a->children);
+}
+
+static int items_lower_bound(const ItemArray *a, int key) {
+    int low = 0, high = a->count;
+    while (low < high) {
         int mid = low + (high - low) / 2;
-        if (base->keys[mid] == key) {
-            *found = true;
-            return base->values[mid];
-        } else if (base->keys[mid] < key) {
+        if (a->keys[mid] < key)
             low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+static void items_insert_at(ItemArray *a, int pos, int key, int value, PID child) {
+    items_reserve(a, a->count + 1);
+    memmove(&a->keys[pos + 1], &a->keys[pos], sizeof(int) * (a->count - pos));
+    memmove(&a->values[pos + 1], &a->values[pos], sizeof(int) * (a->count - pos));
+    memmove(&a->children[pos + 1], &a->children[pos], sizeof(PID) * (a->count - pos));
+    a->keys[pos] = key;
+    a->values[pos] = value;
+    a->children[pos] = child;
+    a->count++;
+}
+
+static void items_remove_at(ItemArray *a, int pos) {
+    memmove(&a->keys[pos], &a->keys[pos + 1], sizeof(int) * (a->count - pos - 1));
+    memmove(&a->values[pos], &a->values[pos + 1], sizeof(int) * (a->count - pos - 1));
+    memmove(&a->children[pos], &a->children[pos + 1], sizeof(PID) * (a->count - pos - 1));
+    a->count--;
+}
+
+/* 페이지의 논리적 내용 수집: 아래(오래된 것)부터 위(최신)로 델타를 적용 */
+static void collect_items(const BwNode *node, ItemArray *out) {
+    if (node->type == NODE_LEAF_BASE || node->type == NODE_INNER_BASE) {
+        out->count = node->count;
+        if (node->count == 0)
+            return;
+        items_reserve(out, node->count);
+        memcpy(out->keys, node->keys, sizeof(int) * node->count);
+        if (node->values)
+            memcpy(out->values, node->values, sizeof(int) * node->count);
+        if (node->children)
+            memcpy(out->children, node->children, sizeof(PID) * node->count);
+        return;
+    }
+    collect_items(node->next, out);
+    int pos = items_lower_bound(out, node->key);
+    bool exists = pos < out->count && out->keys[pos] == node->key;
+    switch (node->type) {
+    case DELTA_INSERT:
+    case DELTA_UPDATE:
+        if (exists)
+            out->values[pos] = node->value;
+        else
+            items_insert_at(out, pos, node->key, node->value, INVALID_PID);
+        break;
+    case DELTA_DELETE:
+        if (exists)
+            items_remove_at(out, pos);
+        break;
+    case DELTA_SPLIT:
+        out->count = pos;   // [key, high)는 오른쪽 형제로 이동
+        break;
+    case DELTA_MERGE: {
+        ItemArray right = {0};
+        collect_items(node->merged, &right);
+        items_reserve(out, out->count + right.count);
+        memcpy(&out->keys[out->count], right.keys, sizeof(int) * right.count);
+        memcpy(&out->values[out->count], right.values, sizeof(int) * right.count);
+        memcpy(&out->children[out->count], right.children, sizeof(PID) * right.count);
+        out->count += right.count;
+        items_free(&right);
+        break;
+    }
+    case DELTA_INDEX_ENTRY:
+        if (exists)
+            out->children[pos] = node->child;
+        else
+            items_insert_at(out, pos, node->key, 0, node->child);
+        break;
+    case DELTA_INDEX_DELETE: {
+        // 제거된 페이지로 가던 범위를 모두 흡수한 페이지로 돌리고, 이웃과 같은 자식을 가리키는 항목은 합침
+        for (int i = 0; i < out->count; i++)
+            if (out->children[i] == node->old_child && out->keys[i] >= node->key &&
+                (!node->has_key2 || out->keys[i] < node->key2))
+                out->children[i] = node->child;
+        for (int i = out->count - 1; i > 0; i--)
+            if (out->children[i] == out->children[i - 1])
+                items_remove_at(out, i);
+        break;
+    }
+    default:   // REMOVE_NODE: 내용은 아래 체인과 같음
+        break;
+    }
+}
+
+/* --- 구조 변경 (SMO: Structure Modification Operation) --- */
+
+/* 새 루트 설치: 분할된 루트와 그 오른쪽 형제를 자식으로 갖는 내부 노드를 만들고 루트 PID를 CAS로 교체 */
+static bool install_new_root(BwTree *tree, PID split_pid, int level, int sep, PID right_pid) {
+    int keys[2] = { INT_MIN, sep };
+    PID children[2] = { split_pid, right_pid };
+    BwNode range;
+    memset(&range, 0, sizeof(range));
+    range.right = INVALID_PID;   // 루트는 범위 제한이 없음
+    BwNode *root = create_base(NODE_INNER_BASE, level + 1, keys, NULL, children, 2, &range);
+    PID new_pid = alloc_pid(tree, root);
+    PID expected = split_pid;
+    if (atomic_compare_exchange_strong(&tree->root, &expected, new_pid))
+        return true;
+    atomic_store(&tree->mapping[new_pid], NULL);
+    epoch_retire(tree, root);
+    return false;
+}
+
+/*
+ * 분할 완료 (도움 포함): 부모 페이지에 [sep, 오른쪽 페이지의 high) → right_pid 항목(INDEX_ENTRY)을 추가
+ * path[depth-1]을 부모로 사용하며, 경로가 없으면 루트부터 level + 1 높이의 페이지를 찾음
+ * 이미 부모가 sep을 right_pid로 안내하고 있으면 아무것도 하지 않음 (여러 스레드가 동시에 도와도 한 번만 반영)
+ */
+static void complete_split(BwTree *tree, PID *path, int depth, PID split_pid, int level, int sep, PID right_pid) {
+    for (;;) {
+        PID ppid;
+        if (depth > 0) {
+            ppid = path[depth - 1];
         } else {
-            high = mid - 1;
+            if (atomic_load(&tree->root) == split_pid) {
+                if (install_new_root(tree, split_pid, level, sep, right_pid))
+                    return;
+                continue;
+            }
+            ppid = bw_find(tree, sep, level + 1, NULL, NULL, NULL);
+            if (ppid == INVALID_PID)
+                return;   // 아직 새 루트가 설치되지 않음: 루트를 지나는 다음 스레드가 완료
+        }
+        BwNode *ptop = load_page(tree, ppid);
+        while (ptop->has_high && sep >= ptop->high_key) {
+            // 부모도 분할됨: 오른쪽 형제가 sep을 담당
+            ppid = ptop->right;
+            ptop = load_page(tree, ppid);
         }
+        BwNode *rtop = load_page(tree, right_pid);
+        if (rtop == NULL || rtop->type == DELTA_REMOVE_NODE)
+            return;
+        if (inner_route(ptop, sep) == right_pid)
+            return;
+        BwNode *d = create_delta(DELTA_INDEX_ENTRY, ptop);
+        d->key = sep;
+        d->key2 = rtop->high_key;
+        d->has_key2 = rtop->has_high;
+        d->child = right_pid;
+        if (cas_page(tree, ppid, ptop, d)) {
+            if (d->chain_length >= DELTA_MIN_THRESHOLD)
+                try_consolidate(tree, ppid, d, path, depth > 0 ? depth - 1 : 0);
+            return;
+        }
+        free(d);
+        depth = 0;   // 부모가 바뀌었으므로 다시 찾음
     }
-    *found = false;
-    return -1;
 }
 
-/* 기본 노드에서 키 삭제 */
-void base_node_delete(BaseNode *base, int key) {
-    int i = 0;
-    while (i < base->count && base->keys[i] != key) {
-        i++;
+/*
+ * 병합 완료 (도움 포함): REMOVE 델타가 붙은 페이지 rpid의 내용을 왼쪽 이웃에 MERGE 델타로 붙이고,
+ * 부모에서 rpid로 가던 범위를 왼쪽 이웃으로 돌림(INDEX_DELETE). 내용을 흡수한 왼쪽 이웃의 PID를 반환
+ * 왼쪽 이웃은 "high == 제거된 페이지의 low이고 오른쪽 형제가 rpid인 리프"이므로, low - 1로 찾을 수 있음
+ */
+static PID complete_merge(BwTree *tree, PID rpid, BwNode *rm) {
+    PID lpid;
+    for (;;) {
+        BwNode *ltop;
+        lpid = bw_find(tree, rm->low_key - 1, 0, NULL, NULL, &ltop);
+        if (ltop->right != rpid || !ltop->has_high || ltop->high_key != rm->low_key)
+            break;   // 이미 다른 스레드가 MERGE를 붙였음
+        BwNode *m = create_delta(DELTA_MERGE, ltop);
+        m->key = rm->low_key;
+        m->merged = rm->next;
+        m->high_key = rm->high_key;
+        m->has_high = rm->has_high;
+        m->right = rm->right;
+        if (cas_page(tree, lpid, ltop, m)) {
+            if (m->chain_length >= consolidate_threshold(tree, lpid, m))
+                try_consolidate(tree, lpid, m, NULL, 0);
+            break;
+        }
+        free(m);
     }
-    if (i == base->count)
-        return; // 키 없음
-    // Shift left
-    for (int j = i; j < base->count - 1; j++) {
-        base->keys[j] = base->keys[j+1];
-        base->values[j] = base->values[j+1];
+
+    for (;;) {
+        BwNode *ptop;
+        PID ppid = bw_find(tree, rm->low_key, 1, NULL, NULL, &ptop);
+        if (ppid == INVALID_PID || inner_route(ptop, rm->low_key) != rpid)
+            break;   // 부모 갱신도 이미 완료됨
+        BwNode *d = create_delta(DELTA_INDEX_DELETE, ptop);
+        d->key = rm->low_key;
+        d->key2 = rm->high_key;
+        d->has_key2 = rm->has_high;
+        d->child = lpid;
+        d->old_child = rpid;
+        if (cas_page(tree, ppid, ptop, d)) {
+            if (d->chain_length >= DELTA_MIN_THRESHOLD)
+                try_consolidate(tree, ppid, d, NULL, 0);
+            break;
+        }
+        free(d);
     }
-    base->count--;
+    return lpid;
+}
+
+/*
+ * 페이지 병합(consolidation): 델타 체인을 적용한 새 기본 노드를 만들어 CAS로 교체
+ *  - 항목 수가 최대치를 넘으면 대신 분할: 위쪽 절반으로 새 페이지를 만들고 SPLIT 델타를 붙인 뒤 부모에 반영
+ *  - 리프 항목 수가 최소치보다 작으면 REMOVE 델타를 붙이고 왼쪽 이웃과 병합
+ * CAS에 실패하면(다른 스레드가 먼저 갱신) 만든 노드를 버리고 그대로 반환 (reader는 어떤 경우에도 기다리지 않음)
+ */
+static void try_consolidate(BwTree *tree, PID pid, BwNode *top, PID *path, int depth) {
+    if (top->type == DELTA_REMOVE_NODE)
+        return;
+    bool leaf = top->level == 0;
+    NodeType base_type = leaf ? NODE_LEAF_BASE : NODE_INNER_BASE;
+    ItemArray items = {0};
+    collect_items(top, &items);
+
+    if (items.count > (leaf ? LEAF_MAX_ITEMS : INNER_MAX_ENTRIES)) {
+        int mid = items.count / 2;
+        int sep = items.keys[mid];
+        BwNode range = *top;
+        range.low_key = sep;
+        range.has_low = true;
+        BwNode *q = create_base(base_type, top->level, &items.keys[mid], &items.values[mid],
+                                &items.children[mid], items.count - mid, &range);
+        PID qpid = alloc_pid(tree, q);
+        BwNode *split = create_delta(DELTA_SPLIT, top);
+        split->key = sep;
+        split->high_key = sep;
+        split->has_high = true;
+        split->right = qpid;
+        items_free(&items);
+        if (cas_page(tree, pid, top, split)) {
+            atomic_fetch_add_explicit(&tree->stats.splits, 1, memory_order_relaxed);
+            complete_split(tree, path, depth, pid, top->level, sep, qpid);
+            // 남은 왼쪽 절반도 새 기본 노드로 정리
+            top = load_page(tree, pid);
+            if (top == split)
+                try_consolidate(tree, pid, split, path, depth);
+        } else {
+            atomic_store(&tree->mapping[qpid], NULL);
+            epoch_retire(tree, q);
+            free(split);
+        }
+        return;
+    }
+
+    if (leaf && items.count < LEAF_MIN_ITEMS && top->has_low) {
+        items_free(&items);
+        BwNode *rm = create_delta(DELTA_REMOVE_NODE, top);
+        if (cas_page(tree, pid, top, rm)) {
+            atomic_fetch_add_explicit(&tree->stats.merges, 1, memory_order_relaxed);
+            complete_merge(tree, pid, rm);
+        } else {
+            free(rm);
+        }
+        return;
+    }
+
+    if (top->chain_length > 0) {
+        BwNode *base = create_base(base_type, top->level, items.keys, items.values, items.children,
+                                   items.count, top);
+        if (cas_page(tree, pid, top, base)) {
+            atomic_fetch_add_explicit(&tree->stats.consolidations, 1, memory_order_relaxed);
+            // 교체된 체인은 이 시점에 체인을 읽고 있는 스레드가 모두 끝난 뒤에 해제
+            epoch_retire(tree, top);
+        } else {
+            free_chain(base);
+        }
+    }
+    items_free(&items);
+}
+
+/* --- 탐색 --- */
+
+/*
+ * key가 속한 level 높이의 페이지를 찾아 PID를 반환 (top에는 읽은 시점의 맨 앞 노드)
+ *  - 페이지 범위 밖의 key이면 오른쪽 형제로 이동하고, 부모에 반영되지 않은 분할이면 도와서 완료
+ *  - 제거 중인 페이지를 만나면 병합을 도와서 완료하고, 내용을 흡수한 왼쪽 페이지에서 계속
+ * path가 NULL이 아니면 거쳐 온 상위 페이지들을 기록 (depth에 개수)
+ * 트리 높이가 level보다 낮으면 INVALID_PID
+ */
+static PID bw_find(BwTree *tree, int key, int level, PID *path, int *depth, BwNode **top) {
+    PID local_path[BW_MAX_DEPTH];
+    if (path == NULL)
+        path = local_path;
+    int d = 0;
+    PID pid = atomic_load(&tree->root);
+    BwNode *node = load_page(tree, pid);
+    if (node->level < level)
+        return INVALID_PID;
+    for (;;) {
+        node = load_page(tree, pid);
+        if (node->type == DELTA_REMOVE_NODE) {
+            pid = complete_merge(tree, pid, node);
+            continue;
+        }
+        if (node->has_high && key >= node->high_key) {
+            PID right = node->right;
+            complete_split(tree, path, d, pid, node->level, node->high_key, right);
+            pid = right;
+            continue;
+        }
+        if (node->level == level)
+            break;
+        if (d < BW_MAX_DEPTH)
+            path[d++] = pid;
+        pid = inner_route(node, key);
+    }
+    if (depth)
+        *depth = d;
+    if (top)
+        *top = node;
+    return pid;
 }
 
 /* --- Bw Tree Functions --- */
 
-/* 새 Bw Tree 생성 */
+/* 새 Bw Tree 생성: 빈 리프 하나가 루트 */
 BwTree* create_bw_tree() {
-    BwTree *tree = (BwTree *)malloc(sizeof(BwTree));
+    BwTree *tree = (BwTree *)calloc(1, sizeof(BwTree));
     if (!tree) {
         fprintf(stderr, "BwTree 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    tree->base = create_base_node(INITIAL_BASE_CAPACITY);
-    tree->delta = NULL; // 델타 레코드 체인은 초기 비어 있음
+    tree->mapping = (_Atomic(BwNode *) *)calloc(MAPPING_TABLE_SIZE, sizeof(_Atomic(BwNode *)));
+    tree->page_stats = (PageStats *)calloc(MAPPING_TABLE_SIZE, sizeof(PageStats));
+    if (!tree->mapping || !tree->page_stats) {
+        fprintf(stderr, "매핑 테이블 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    atomic_init(&tree->next_pid, 0);
+    atomic_init(&tree->global_epoch, 1);
+    atomic_init(&tree->num_slots, 0);
+    pthread_mutex_lock(&bw_registry_lock);
+    tree->id = bw_next_tree_id++;
+    tree->next_live = bw_live_trees;
+    bw_live_trees = tree;
+    pthread_mutex_unlock(&bw_registry_lock);
+    BwNode range;
+    memset(&range, 0, sizeof(range));
+    range.right = INVALID_PID;
+    BwNode *root = create_base(NODE_LEAF_BASE, 0, NULL, NULL, NULL, 0, &range);
+    atomic_init(&tree->root, alloc_pid(tree, root));
     return tree;
 }
 
-/* Bw Tree 메모리 해제 */
+/* Bw Tree 메모리 해제 (다른 스레드가 사용 중이지 않을 때 호출) */
 void free_bw_tree(BwTree *tree) {
     if (!tree)
         return;
-    // Free 델타 체인
-    DeltaRecord *dr = tree->delta;
-    while (dr) {
-        DeltaRecord *tmp = dr;
-        dr = dr->next;
-        free(tmp);
-    }
-    free_base_node(tree->base);
+    // 목록에서 빼면 이후 종료하는 스레드는 이 트리의 슬롯을 건드리지 않음
+    pthread_mutex_lock(&bw_registry_lock);
+    BwTree **pp = &bw_live_trees;
+    while (*pp != tree)
+        pp = &(*pp)->next_live;
+    *pp = tree->next_live;
+    pthread_mutex_unlock(&bw_registry_lock);
+    PID num_pids = atomic_load(&tree->next_pid);
+    for (PID pid = 0; pid < num_pids; pid++) {
+        BwNode *node = atomic_load(&tree->mapping[pid]);
+        if (node)
+            free_chain(node);
+    }
+    for (int i = 0; i < BW_MAX_THREADS; i++) {
+        Garbage *g = tree->slots[i].garbage;
+        while (g) {
+            Garbage *next = g->next;
+            free_chain(g->node);
+            free(g);
+            g = next;
+        }
+    }
+    free(tree->mapping);
+    free(tree->page_stats);
     free(tree);
 }
 
-/* 새 델타 레코드 생성 */
-DeltaRecord* create_delta_record(DeltaType type, int key, int value) {
-    DeltaRecord *dr = (DeltaRecord *)malloc(sizeof(DeltaRecord));
-    if (!dr) {
-        fprintf(stderr, "DeltaRecord 메모리 할당 실패\n");
-        exit(EXIT_FAILURE);
+/* 리프 연산 공통: 델타를 만들어 CAS로 페이지 맨 앞에 붙임 (실패하면 최신 상태를 다시 읽고 재시도) */
+static bool leaf_apply(BwTree *tree, NodeType type, int key, int value) {
+    PID path[BW_MAX_DEPTH];
+    int depth;
+    bool applied = true;
+    epoch_enter(tree);
+    for (;;) {
+        BwNode *top;
+        PID pid = bw_find(tree, key, 0, path, &depth, &top);
+        page_stats_note(tree, pid, true);
+        if (type != DELTA_INSERT) {
+            // 존재 여부 확인과 CAS가 같은 top을 기준으로 하므로, 확인 이후의 변경은 CAS 실패로 드러남
+            int old;
+            if (!leaf_lookup(top, key, &old)) {
+                applied = false;
+                break;
+            }
+        }
+        BwNode *d = create_delta(type, top);
+        d->key = key;
+        d->value = value;
+        attach_summary(tree, d);
+        if (cas_page(tree, pid, top, d)) {
+            if (d->chain_length >= consolidate_threshold(tree, pid, d))
+                try_consolidate(tree, pid, d, path, depth);
+            break;
+        }
+        free_delta(d);
     }
-    dr->type = type;
-    dr->key = key;
-    dr->value = value;
-    dr->next = NULL;
-    return dr;
+    epoch_exit(tree);
+    return applied;
+}
+
+/* bw_tree_insert: 델타 레코드로 삽입 연산 기록 (이미 존재하는 키는 새 값으로 덮어씀) */
+void bw_tree_insert(BwTree *tree, int key, int value) {
+    leaf_apply(tree, DELTA_INSERT, key, value);
+}
+
+/* bw_tree_delete: 델타 레코드로 삭제 연산 기록. 키가 없으면 false */
+bool bw_tree_delete(BwTree *tree, int key) {
+    return leaf_apply(tree, DELTA_DELETE, key, 0);
 }
 
-/* 델타 레코드를 델타 체인 앞에 추가 */
-void add_delta_record(BwTree *tree, DeltaRecord *dr) {
-    dr->next = tree->delta;
-    tree->delta = dr;
+/* bw_tree_update: 델타 레코드로 업데이트 연산 기록. 키가 없으면 false */
+bool bw_tree_update(BwTree *tree, int key, int value) {
+    return leaf_apply(tree, DELTA_UPDATE, key, value);
 }
 
-/* 
- * bw_tree_insert: 델타 레코드로 삽입 연산 기록
- * 실제 삽입은 기본 노드에 직접 반영하지 않고, 델타 체인에 기록합니다.
- * 일정 임계치(DELTA_THRESHOLD) 이상 누적되면 consolidate_bw_tree()를 호출합니다.
+/*
+ * bw_tree_search: 루트부터 매핑 테이블을 따라 리프 페이지를 찾고,
+ * 델타 체인(최신이 앞쪽, 요약은 이진 탐색)과 기본 노드에서 최신 값을 찾음. 어떤 락도 잡지 않음
+ * 읽기 위주로 바뀐 페이지의 체인이 임계치를 넘으면 reader도 병합을 시도 (CAS 한 번, 실패해도 기다리지 않음)
  */
-void bw_tree_insert(BwTree *tree, int key, int value) {
-    DeltaRecord *dr = create_delta_record(DELTA_INSERT, key, value);
-    add_delta_record(tree, dr);
-    
-    // 병합 조건 체크
-    int delta_count = 0;
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        delta_count++;
-        curr = curr->next;
+bool bw_tree_search(BwTree *tree, int key, int *value) {
+    BwNode *top;
+    epoch_enter(tree);
+    PID pid = bw_find(tree, key, 0, NULL, NULL, &top);
+    page_stats_note(tree, pid, false);
+    bool found = leaf_lookup(top, key, value);
+    if (top->chain_length >= consolidate_threshold(tree, pid, top))
+        try_consolidate(tree, pid, top, NULL, 0);
+    epoch_exit(tree);
+    return found;
+}
+
+/* consolidate_bw_tree: 델타 체인이 있는 모든 페이지를 병합 (필요하면 분할/병합도 수행) */
+void consolidate_bw_tree(BwTree *tree) {
+    int pages = 0;
+    epoch_enter(tree);
+    PID num_pids = atomic_load(&tree->next_pid);
+    for (PID pid = 0; pid < num_pids; pid++) {
+        BwNode *top = load_page(tree, pid);
+        if (top && top->type != DELTA_REMOVE_NODE && top->chain_length > 0) {
+            try_consolidate(tree, pid, top, NULL, 0);
+            pages++;
+        }
+    }
+    epoch_exit(tree);
+    printf("Consolidation completed. %d개 페이지의 델타 체인을 병합했습니다.\n", pages);
+}
+
+/* bw_tree_print: 레벨별로 왼쪽부터 오른쪽 형제를 따라가며 페이지 상태 출력 (단일 스레드에서 호출) */
+void bw_tree_print(BwTree *tree) {
+    PID first = atomic_load(&tree->root);
+    printf("\n--- Bw Tree State (root: P%u) ---\n", first);
+    while (first != INVALID_PID) {
+        BwNode *node = load_page(tree, first);
+        int level = node->level;
+        printf("Level %d: ", level);
+        for (PID pid = first; pid != INVALID_PID; pid = node->right) {
+            node = load_page(tree, pid);
+            ItemArray items = {0};
+            collect_items(node, &items);
+            printf("[P%u Δ%d |", pid, node->chain_length);
+            for (int i = 0; i < items.count; i++) {
+                if (level == 0)
+                    printf(" %d:%d", items.keys[i], items.values[i]);
+                else if (i == 0)
+                    printf(" P%u", items.children[i]);
+                else
+                    printf(" <%d> P%u", items.keys[i], items.children[i]);
+            }
+            printf(" ] ");
+            items_free(&items);
+        }
+        printf("\n");
+        node = load_page(tree, first);
+        first = level > 0 ? inner_route(node, node->has_low ? node->low_key : INT_MIN) : INVALID_PID;
+    }
+}
+
+/* --- 멀티스레드 데모 --- */
+
+#define DEMO_THREADS 4
+#define DEMO_KEYS_PER_THREAD 20000
+
+typedef struct {
+    BwTree *tree;
+    int id;
+    long long errors;
+} DemoArgs;
+
+/* writer: 자신의 key(key % DEMO_THREADS == id)를 삽입한 뒤, 8의 배수가 아닌 key는 삭제(리프 병합 유발), 나머지는 갱신 */
+static void* writer_main(void *arg) {
+    DemoArgs *args = (DemoArgs *)arg;
+    for (int i = 0; i < DEMO_KEYS_PER_THREAD; i++) {
+        int key = i * DEMO_THREADS + args->id;
+        bw_tree_insert(args->tree, key, key * 10);
     }
-    if (delta_count >= DELTA_THRESHOLD) {
-        consolidate_bw_tree(tree);
+    for (int i = 0; i < DEMO_KEYS_PER_THREAD; i++) {
+        int key = i * DEMO_THREADS + args->id;
+        if (key % 8 != 0) {
+            if (!bw_tree_delete(args->tree, key))
+                args->errors++;
+        } else if (!bw_tree_update(args->tree, key, key * 10 + 1)) {
+            args->errors++;
+        }
     }
+    return NULL;
 }
 
-/* bw_tree_delete: 델타 레코드로 삭제 연산 기록 */
-void bw_tree_delete(BwTree *tree, int key) {
-    DeltaRecord *dr = create_delta_record(DELTA_DELETE, key, 0);
-    add_delta_record(tree, dr);
-    
-    int delta_count = 0;
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        delta_count++;
-        curr = curr->next;
+/* reader: writer와 동시에 검색. 값이 보이면 항상 key * 10 또는 key * 10 + 1이어야 함 */
+static void* reader_main(void *arg) {
+    DemoArgs *args = (DemoArgs *)arg;
+    int total = DEMO_THREADS * DEMO_KEYS_PER_THREAD;
+    unsigned int seed = (unsigned int)args->id * 7919u + 1;
+    for (int i = 0; i < 200000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int key = (int)((seed >> 8) % (unsigned int)total);
+        int value;
+        if (bw_tree_search(args->tree, key, &value) && value != key * 10 && value != key * 10 + 1)
+            args->errors++;
+    }
+    return NULL;
+}
+
+static void run_concurrent_demo(void) {
+    BwTree *tree = create_bw_tree();
+    pthread_t writers[DEMO_THREADS], readers[DEMO_THREADS];
+    DemoArgs wargs[DEMO_THREADS], rargs[DEMO_THREADS];
+    printf("\n=== Concurrent Demo: writer %d개 + reader %d개 ===\n", DEMO_THREADS, DEMO_THREADS);
+    for (int t = 0; t < DEMO_THREADS; t++) {
+        wargs[t] = (DemoArgs){ tree, t, 0 };
+        rargs[t] = (DemoArgs){ tree, t, 0 };
+        if (pthread_create(&writers[t], NULL, writer_main, &wargs[t]) != 0 ||
+            pthread_create(&readers[t], NULL, reader_main, &rargs[t]) != 0) {
+            fprintf(stderr, "스레드 생성 실패\n");
+            exit(EXIT_FAILURE);
+        }
     }
-    if (delta_count >= DELTA_THRESHOLD) {
-        consolidate_bw_tree(tree);
+    long long errors = 0;
+    for (int t = 0; t < DEMO_THREADS; t++) {
+        pthread_join(writers[t], NULL);
+        pthread_join(readers[t], NULL);
+        errors += wargs[t].errors + rargs[t].errors;
     }
+
+    // 최종 상태 검증: 8의 배수 key는 갱신된 값, 나머지는 삭제됨
+    int total = DEMO_THREADS * DEMO_KEYS_PER_THREAD;
+    for (int key = 0; key < total; key++) {
+        int value;
+        bool found = bw_tree_search(tree, key, &value);
+        if (key % 8 != 0 ? found : (!found || value != key * 10 + 1))
+            errors++;
+    }
+    printf("검증 오류: %lld\n", errors);
+    printf("consolidation %lld회, split %lld회, merge %lld회, CAS 실패 %lld회, 회수된 체인 %lld개, 사용한 PID %u개\n",
+           (long long)tree->stats.consolidations, (long long)tree->stats.splits,
+           (long long)tree->stats.merges, (long long)tree->stats.cas_failures,
+           (long long)tree->stats.reclaimed, atomic_load(&tree->next_pid));
+    free_bw_tree(tree);
 }
 
-/* bw_tree_update: 델타 레코드로 업데이트 연산 기록 */
-void bw_tree_update(BwTree *tree, int key, int value) {
-    DeltaRecord *dr = create_delta_record(DELTA_UPDATE, key, value);
-    add_delta_record(tree, dr);
-    
-    int delta_count = 0;
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        delta_count++;
-        curr = curr->next;
+/* --- 핫 키 데모: 한 페이지에 쓰기가 몰리는 경우 --- */
+
+#define HOT_KEYS 8
+#define HOT_OPS 400000
+
+/* hot writer: HOT_KEYS개의 key만 계속 갱신. 값은 항상 value % HOT_KEYS == key */
+static void* hot_writer_main(void *arg) {
+    DemoArgs *args = (DemoArgs *)arg;
+    for (int i = 0; i < HOT_OPS; i++) {
+        int key = i % HOT_KEYS;
+        bw_tree_insert(args->tree, key, key + HOT_KEYS * (i + args->id));
     }
-    if (delta_count >= DELTA_THRESHOLD) {
-        consolidate_bw_tree(tree);
+    return NULL;
+}
+
+static void* hot_reader_main(void *arg) {
+    DemoArgs *args = (DemoArgs *)arg;
+    for (int i = 0; i < HOT_OPS; i++) {
+        int key = (i * 7 + args->id) % HOT_KEYS;
+        int value;
+        if (!bw_tree_search(args->tree, key, &value) || value % HOT_KEYS != key)
+            args->errors++;
     }
+    return NULL;
 }
 
-/*
- * bw_tree_search: 기본 노드와 델타 체인을 순차적으로 적용하여 최신 값을 반환
- * - 기본 노드에서 검색한 결과를 시작으로, 델타 체인(최신이 먼저)을 순회하며
- *   INSERT/UPDATE/DELETE 연산을 반영합니다.
- */
-bool bw_tree_search(BwTree *tree, int key, int *value) {
-    bool found;
-    int base_val = base_node_search(tree->base, key, &found);
-    // 초기 값: 기본 노드에 값이 있으면 그 값, 없으면 -1 (없음)
-    int result = base_val;
-    bool exists = found;
-    
-    // 델타 체인을 최신순으로 적용 (체인은 최신이 앞쪽에 위치)
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        if (curr->key == key) {
-            if (curr->type == DELTA_INSERT || curr->type == DELTA_UPDATE) {
-                result = curr->value;
-                exists = true;
-                // 최신 연산이 UPDATE/INSERT이면, 결과를 덮어씀
-                break;
-            } else if (curr->type == DELTA_DELETE) {
-                exists = false;
-                break;
-            }
+static void run_hot_key_demo(void) {
+    BwTree *tree = create_bw_tree();
+    for (int key = 0; key < HOT_KEYS; key++)
+        bw_tree_insert(tree, key, key);
+    pthread_t writers[2], readers[2];
+    DemoArgs wargs[2], rargs[2];
+    struct timespec start, end;
+    printf("\n=== Hot Key Demo: key %d개에 writer 2개 + reader 2개 ===\n", HOT_KEYS);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < 2; t++) {
+        wargs[t] = (DemoArgs){ tree, t, 0 };
+        rargs[t] = (DemoArgs){ tree, t, 0 };
+        if (pthread_create(&writers[t], NULL, hot_writer_main, &wargs[t]) != 0 ||
+            pthread_create(&readers[t], NULL, hot_reader_main, &rargs[t]) != 0) {
+            fprintf(stderr, "스레드 생성 실패\n");
+            exit(EXIT_FAILURE);
         }
-        curr = curr->next;
     }
-    
-    if (exists) {
-        *value = result;
-        return true;
+    long long errors = 0;
+    for (int t = 0; t < 2; t++) {
+        pthread_join(writers[t], NULL);
+        pthread_join(readers[t], NULL);
+        errors += rargs[t].errors;
     }
-    return false;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    BwNode *top = load_page(tree, atomic_load(&tree->root));
+    printf("검증 오류: %lld, %.2f Mops/s\n", errors, 4.0 * HOT_OPS / elapsed / 1e6);
+    printf("consolidation %lld회, 요약 생성 %lld회, 현재 체인 길이 %d (임계치 %d)\n",
+           (long long)tree->stats.consolidations, (long long)tree->stats.summaries,
+           top->chain_length, consolidate_threshold(tree, atomic_load(&tree->root), top));
+    free_bw_tree(tree);
 }
 
-/*
- * consolidate_bw_tree: 델타 체인을 기본 노드에 병합(consolidation)
- * - 기본 노드의 데이터를 시작으로, 델타 체인에 기록된 모든 연산을 적용하여
- *   새로운 기본 노드를 재구성합니다.
- * - 병합 후, 델타 체인을 초기화합니다.
- */
-void consolidate_bw_tree(BwTree *tree) {
-    // 임시 배열로 기존 기본 데이터 복사
-    int capacity = tree->base->capacity;
-    int *temp_keys = (int *)malloc(sizeof(int) * capacity);
-    int *temp_values = (int *)malloc(sizeof(int) * capacity);
-    int count = tree->base->count;
-    for (int i = 0; i < count; i++) {
-        temp_keys[i] = tree->base->keys[i];
-        temp_values[i] = tree->base->values[i];
-    }
-    
-    // 적용할 델타 레코드는 최신 순서가 앞쪽에 있으므로, 역순으로 적용하여 올바른 순서를 만듦
-    // 먼저 델타 레코드를 배열에 저장
-    int delta_count = 0;
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        delta_count++;
-        curr = curr->next;
-    }
-    DeltaRecord **deltas = (DeltaRecord **)malloc(sizeof(DeltaRecord *) * delta_count);
-    curr = tree->delta;
-    for (int i = 0; i < delta_count; i++) {
-        deltas[i] = curr;
-        curr = curr->next;
-    }
-    // 역순 적용: 가장 오래된 델타부터 최신까지
-    for (int i = delta_count - 1; i >= 0; i--) {
-        DeltaRecord *dr = deltas[i];
-        bool found;
-        int pos = 0;
-        // 선형 탐색으로 기존 배열에서 key 위치 찾기
-        while (pos < count && temp_keys[pos] < dr->key) pos++;
-        
-        if (dr->type == DELTA_INSERT) {
-            // 중복 체크: 이미 존재하면 업데이트, 아니면 삽입
-            if (pos < count && temp_keys[pos] == dr->key) {
-                temp_values[pos] = dr->value;
-            } else {
-                // 배열 확장 필요 시 처리 (단순화를 위해 capacity 고정)
-                // 오른쪽 shift 후 삽입
-                for (int j = count; j > pos; j--) {
-                    temp_keys[j] = temp_keys[j-1];
-                    temp_values[j] = temp_values[j-1];
-                }
-                temp_keys[pos] = dr->key;
-                temp_values[pos] = dr->value;
-                count++;
-            }
-        } else if (dr->type == DELTA_UPDATE) {
-            if (pos < count && temp_keys[pos] == dr->key) {
-                temp_values[pos] = dr->value;
-            }
-            // 만약 존재하지 않으면, UPDATE를 INSERT로 간주할 수 있음
-        } else if (dr->type == DELTA_DELETE) {
-            if (pos < count && temp_keys[pos] == dr->key) {
-                // 삭제: 오른쪽 shift로 삭제
-                for (int j = pos; j < count - 1; j++) {
-                    temp_keys[j] = temp_keys[j+1];
-                    temp_values[j] = temp_values[j+1];
-                }
-                count--;
+/* --- 스레드 교체 데모: 짧게 사는 스레드가 여러 트리를 번갈아 사용 --- */
+
+#define CHURN_ROUNDS 40
+#define CHURN_THREADS 4
+#define CHURN_KEYS 500
+
+typedef struct {
+    BwTree *shared;   // 모든 라운드가 함께 쓰는 트리
+    BwTree *round;    // 라운드마다 새로 만드는 트리 (해제된 트리와 같은 주소일 수 있음)
+    int id;
+} ChurnArgs;
+
+static void* churn_main(void *arg) {
+    ChurnArgs *args = (ChurnArgs *)arg;
+    for (int i = 0; i < CHURN_KEYS; i++) {
+        int key = i * CHURN_THREADS + args->id;
+        bw_tree_insert(args->shared, key, key);
+        bw_tree_insert(args->round, key, key + 1);
+    }
+    return NULL;
+}
+
+static void run_thread_churn_demo(void) {
+    BwTree *shared = create_bw_tree();
+    long long errors = 0;
+    int max_slots = 0;
+    printf("\n=== Thread Churn Demo: 라운드 %d개 x 스레드 %d개 (총 %d개, BW_MAX_THREADS = %d) ===\n",
+           CHURN_ROUNDS, CHURN_THREADS, CHURN_ROUNDS * CHURN_THREADS, BW_MAX_THREADS);
+    for (int r = 0; r < CHURN_ROUNDS; r++) {
+        BwTree *round = create_bw_tree();
+        pthread_t threads[CHURN_THREADS];
+        ChurnArgs args[CHURN_THREADS];
+        for (int t = 0; t < CHURN_THREADS; t++) {
+            args[t] = (ChurnArgs){ shared, round, t };
+            if (pthread_create(&threads[t], NULL, churn_main, &args[t]) != 0) {
+                fprintf(stderr, "스레드 생성 실패\n");
+                exit(EXIT_FAILURE);
             }
         }
+        for (int t = 0; t < CHURN_THREADS; t++)
+            pthread_join(threads[t], NULL);
+        // main 스레드도 이번 라운드 트리를 사용 (앞 라운드 트리와 주소가 같아도 새 슬롯을 빌림)
+        for (int key = 0; key < CHURN_KEYS * CHURN_THREADS; key++) {
+            int value;
+            if (!bw_tree_search(round, key, &value) || value != key + 1)
+                errors++;
+        }
+        if (atomic_load(&round->num_slots) > max_slots)
+            max_slots = atomic_load(&round->num_slots);
+        free_bw_tree(round);
     }
-    free(deltas);
-    
-    // 새로운 기본 노드 생성 및 교체
-    BaseNode *new_base = create_base_node(capacity);
-    for (int i = 0; i < count; i++) {
-        base_node_insert(new_base, temp_keys[i], temp_values[i]);
-    }
-    free(temp_keys);
-    free(temp_values);
-    
-    // Free 기존 기본 노드 and 델타 체인
-    free_base_node(tree->base);
-    tree->base = new_base;
-    
-    // Free 델타 체인
-    curr = tree->delta;
-    while (curr) {
-        DeltaRecord *tmp = curr;
-        curr = curr->next;
-        free(tmp);
-    }
-    tree->delta = NULL;
-    
-    printf("Consolidation completed. New base node count: %d\n", tree->base->count);
-}
-
-/* bw_tree_print: 기본 노드와 델타 체인 상태 출력 */
-void bw_tree_print(BwTree *tree) {
-    printf("\n--- Bw Tree State ---\n");
-    printf("Base Node (count = %d): ", tree->base->count);
-    for (int i = 0; i < tree->base->count; i++) {
-        printf("[%d:%d] ", tree->base->keys[i], tree->base->values[i]);
-    }
-    printf("\nDelta Chain: ");
-    DeltaRecord *curr = tree->delta;
-    while (curr) {
-        if (curr->type == DELTA_INSERT)
-            printf("(I %d:%d) -> ", curr->key, curr->value);
-        else if (curr->type == DELTA_UPDATE)
-            printf("(U %d:%d) -> ", curr->key, curr->value);
-        else if (curr->type == DELTA_DELETE)
-            printf("(D %d) -> ", curr->key);
-        curr = curr->next;
+    for (int key = 0; key < CHURN_KEYS * CHURN_THREADS; key++) {
+        int value;
+        if (!bw_tree_search(shared, key, &value) || value != key)
+            errors++;
     }
-    printf("NULL\n");
+    printf("검증 오류: %lld, 공유 트리가 사용한 슬롯 %d개, 라운드 트리가 사용한 슬롯 최대 %d개\n",
+           errors, atomic_load(&shared->num_slots), max_slots);
+    free_bw_tree(shared);
 }
 
 /* --- main 함수 --- */
 int main(void) {
     BwTree *tree = create_bw_tree();
-    
+
     printf("=== Bw Tree Demo ===\n");
-    
+
     // 삽입 테스트
     bw_tree_insert(tree, 50, 500);
     bw_tree_insert(tree, 30, 300);
@@ -438,40 +1413,66 @@ int main(void) {
     bw_tree_insert(tree, 60, 600);
     bw_tree_insert(tree, 80, 800);
     bw_tree_print(tree);
-    
+
     // 검색 테스트
     int val;
     if (bw_tree_search(tree, 40, &val))
         printf("\nSearch: Key 40 found with value %d\n", val);
     else
         printf("\nSearch: Key 40 not found\n");
-    
+
     if (bw_tree_search(tree, 90, &val))
         printf("Search: Key 90 found with value %d\n", val);
     else
         printf("Search: Key 90 not found\n");
-    
+
     // 업데이트 테스트
     bw_tree_update(tree, 70, 750);
     bw_tree_print(tree);
-    
+
     // 삭제 테스트
     bw_tree_delete(tree, 30);
     bw_tree_delete(tree, 60);
     bw_tree_print(tree);
-    
-    // 강제 consolidation (만약 델타가 누적되었으면 자동 호출되지만, 수동으로도 호출)
+
+    // 강제 consolidation (델타가 누적되면 자동 호출되지만, 수동으로도 호출)
     consolidate_bw_tree(tree);
     bw_tree_print(tree);
-    
+
     // 최종 검색 테스트
     if (bw_tree_search(tree, 70, &val))
         printf("\nFinal Search: Key 70 found with value %d\n", val);
     else
         printf("\nFinal Search: Key 70 not found\n");
-    
+
+    // 분할 테스트: 리프가 LEAF_MAX_ITEMS를 넘으면 분할되고, 루트가 분할되면 트리 높이가 늘어남
+    for (int key = 1; key <= 60; key++)
+        bw_tree_insert(tree, key * 5 + 1, key);
+    consolidate_bw_tree(tree);
+    printf("\n60개 삽입 후:");
+    bw_tree_print(tree);
+
+    // 병합 테스트: 리프가 LEAF_MIN_ITEMS보다 작아지면 왼쪽 형제와 병합됨
+    for (int key = 1; key <= 55; key++)
+        bw_tree_delete(tree, key * 5 + 1);
+    consolidate_bw_tree(tree);
+    printf("\n55개 삭제 후:");
+    bw_tree_print(tree);
+    printf("consolidation %lld회, split %lld회, merge %lld회\n",
+           (long long)tree->stats.consolidations, (long long)tree->stats.splits,
+           (long long)tree->stats.merges);
+
     // 메모리 해제
     free_bw_tree(tree);
-    
+
+    // 여러 스레드가 락 없이 동시에 삽입/삭제/갱신/검색
+    run_concurrent_demo();
+
+    // 쓰기가 몰리는 페이지: 체인을 길게 허용하되 요약으로 검색 비용을 제한
+    run_hot_key_demo();
+
+    // BW_MAX_THREADS보다 많은 스레드가 차례로 사용: 종료한 스레드의 슬롯을 재사용
+    run_thread_churn_demo();
+
     return 0;
-}
\ No newline at end of file
+}
@@ -1,416 +1,2287 @@
 /*
  * LSM Tree Demo
  *
- * 이 예제는 LSM Tree의 기본 동작을 시뮬레이션합니다.
- * 메모테이블(Memtable)에 삽입된 데이터를 일정 임계치(MEMTABLE_THRESHOLD) 이상 모으면,
- * 디스크 기반 SSTable로 플러시하여 저장합니다.
+ * 이 예제는 LSM Tree의 기본 동작을 디스크 기반으로 구현합니다.
+ * 메모테이블(Memtable)에 삽입된 데이터를 일정 임계치(MEMTABLE_THRESHOLD/MEMTABLE_MAX_BYTES) 이상 모으면,
+ * 불변(immutable)의 정렬된 SSTable 파일로 플러시하여 저장합니다.
  *
  * 주요 기능:
- *  - 삽입 (Insertion): 메모테이블에 키-값 쌍을 정렬된 상태로 저장.
- *  - 플러시 (Flush): 메모테이블이 가득 차면 SSTable로 데이터를 이동.
- *  - 검색 (Search): 메모테이블 우선, 이후 SSTable들을 순차적으로 검색.
+ *  - WAL (Write-Ahead Log): 모든 삽입/삭제는 메모테이블에 반영되기 전에 로그 파일에 먼저 기록.
+ *  - 삽입 (Insertion): 메모테이블(아레나 기반 스킵 리스트)에 O(log n)으로 삽입. 모든 쓰기는 시퀀스 번호를 부여받음.
+ *      메모테이블 검색은 락 없이 진행되며, 플러시는 정렬 순서를 그대로 따르는 반복자로 수행.
+ *  - 플러시 (Flush): 메모테이블이 가득 차면 블록 인덱스와 푸터를 가진 SSTable 파일을 L0에 생성.
+ *  - 검색 (Search): 메모테이블 우선, 이후 L0(최신 순) → L1 → ... 순서로 mmap된 파일을 직접 검색.
+ *      SSTable마다 key 범위(min/max), 블룸 필터, 펜스 포인터(블록별 first/last key)를 차례로 확인하여
+ *      key가 있을 수 없는 SSTable과 블록은 데이터 블록을 읽지 않고 건너뜀.
  *  - 삭제 (Deletion): tombstone(삭제 표시)을 메모테이블에 기록하여 삭제 처리.
- *  - 컴팩션 (Compaction): 여러 SSTable을 병합하여 중복 및 삭제된 항목 제거 (시뮬레이션).
+ *  - 범위 스캔 (Range Scan): lsmScanOpen으로 [lo, hi)를 key 순서로 순회. 메모테이블과 모든 SSTable의 커서를
+ *      최소 힙으로 병합하며, 덮어쓴 이전 버전과 삭제된 key는 숨김. 열린 시점의 스냅샷을 보며,
+ *      SSTable 커서는 다음 블록을 미리 읽도록 요청(madvise/prefetch).
+ *  - 컴팩션 (Compaction): 정렬된 SSTable들을 최소 힙 기반 k-way 병합으로 스트리밍하여 다음 레벨로 내림.
+ *      * Leveled: L1 이상은 레벨 내 key 범위가 겹치지 않으며, 레벨 크기 한도를 넘으면 SSTable 하나를
+ *                 골라 다음 레벨의 겹치는 SSTable들과 병합.
+ *      * Tiered : 레벨마다 겹치는 run을 최대 TIER_MAX_RUNS개까지 쌓아 두었다가 한꺼번에 다음 레벨로 병합.
+ *      같은 key는 시퀀스 번호가 가장 큰 버전만 남기며, tombstone은 더 깊은 곳에 같은 key가 있을 수 없을 때만 제거.
+ *  - 복구 (Recovery): MANIFEST로 레벨별 SSTable 목록을 복원하고, 남아 있는 WAL을 재생하여 L0로 복구.
+ *  - 백그라운드 작업 (Background): 메모테이블을 이중 버퍼(active + immutable)로 운영.
+ *      활성 메모테이블이 가득 차면 immutable로 전환하고 즉시 새 메모테이블(과 새 WAL)에 쓰기를 계속하며,
+ *      플러시 스레드가 immutable을 SSTable로 기록. 컴팩션은 COMPACTION_THREADS개의 스레드가
+ *      서로 겹치지 않는 입력을 골라 병렬로 수행.
+ *  - 쓰기 제어 (Write Stall): L0가 L0_SLOWDOWN_WRITES_TRIGGER개 이상이면 쓰기를 조금씩 지연하고,
+ *      L0_STOP_WRITES_TRIGGER개 이상이거나 immutable 플러시가 밀려 있으면 쓰기를 잠시 멈춰
+ *      컴팩션이 쓰기 속도를 따라오도록 함.
  *
- * 주의: 이 코드는 교육 및 데모 목적으로 작성된 간단한 시뮬레이션이며,
+ * 동기화:
+ *  - tree->mutex       : 메모테이블, 레벨 구성 변경, 파일 번호/시퀀스 번호, 백그라운드 작업 상태를 보호
+ *  - tree->version_lock: 레벨 리스트에 대한 읽기/쓰기 락. 검색은 읽기 락만 잡고 SSTable을 읽으므로
+ *                        플러시/컴팩션의 파일 I/O와 동시에 진행되며, 리스트 교체 순간에만 배제됨
+ *
+ * SSTable 파일 포맷:
+ *  [Data Block 0][Data Block 1]...[Data Block N-1][Filter Block][Index Block][Footer]
+ *  - Data Block  : key 오름차순으로 정렬된 DiskEntry 레코드 (최대 SSTABLE_BLOCK_ENTRIES개)
+ *  - Filter Block: 파일 내 모든 key에 대한 블룸 필터 비트 배열
+ *  - Index Block : 블록마다 (첫 번째 key, 마지막 key, 오프셋, 엔트리 수)를 저장하는 펜스 포인터 배열
+ *  - Footer      : 인덱스/필터 위치, key 범위, 최대 시퀀스 번호, 블록 수, 엔트리 수, 매직 넘버
+ *
+ * 컴파일 예시: gcc -Wall -O2 -pthread main.c -o lsm
+ *
+ * 주의: 이 코드는 교육 및 데모 목적으로 작성된 구현이며,
  * 실제 LSM Tree 구현에서는 더 복잡한 동기화, 에러 처리, 디스크 I/O 최적화 등이 필요합니다.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define MEMTABLE_THRESHOLD 5        // 메모테이블 플러시 임계치 (엔트리 수, 데모용으로 작게 설정)
+#define MEMTABLE_MAX_BYTES (64u << 20) // 메모테이블 플러시 임계치 (아레나 사용량, 둘 중 먼저 도달한 쪽 적용)
+#define MEMTABLE_MAX_HEIGHT 12      // 스킵 리스트 최대 높이 (4^12 ≈ 1600만 엔트리까지 O(log n) 유지)
+#define MEMTABLE_BRANCHING 4        // 레벨이 하나 올라갈 확률 = 1/4
+#define ARENA_BLOCK_SIZE 4096       // 메모테이블 아레나 블록 크기
+#define SSTABLE_BLOCK_ENTRIES 4     // 데이터 블록당 엔트리 수 (데모용으로 작게 설정, 실제로는 4KB 단위)
+#define SSTABLE_MAGIC 0x334D534Cu   // "LSM3" (little-endian)
+#define BLOOM_BITS_PER_KEY 10       // key당 블룸 필터 비트 수 (약 1% 거짓 양성률)
+#define WAL_SYNC 1                  // 1이면 WAL 기록마다 fdatasync를 호출하여 내구성 보장
+#define LSM_DIR_MAX 256
+#define LSM_PATH_MAX 512
 
-#define MEMTABLE_THRESHOLD 5    // 메모테이블 플러시 임계치
+// 컴팩션 파라미터 (데모용으로 작게 설정)
+#define LSM_NUM_LEVELS 4            // L0 ~ L3
+#define L0_COMPACTION_TRIGGER 2     // L0의 SSTable 수가 이 값 이상이면 L0 → L1 컴팩션 (leveled)
+#define LEVEL1_MAX_ENTRIES 8        // L1의 최대 엔트리 수 (leveled)
+#define LEVEL_SIZE_MULTIPLIER 4     // L(i+1)의 한도 = L(i)의 한도 * multiplier (leveled)
+#define SSTABLE_TARGET_ENTRIES 6    // 컴팩션 출력 SSTable 파일당 최대 엔트리 수 (leveled)
+#define TIER_MAX_RUNS 3             // 레벨의 run 수가 이 값 이상이면 다음 레벨로 병합 (tiered)
 
-// 개별 엔트리: key, value, 삭제 여부를 표시하는 tombstone
+// 백그라운드 작업 및 쓰기 제어 파라미터
+#define COMPACTION_THREADS 2        // 컴팩션 스레드 수
+#define L0_SLOWDOWN_WRITES_TRIGGER 4 // L0 SSTable 수가 이 값 이상이면 쓰기마다 1ms 지연
+#define L0_STOP_WRITES_TRIGGER 6    // L0 SSTable 수가 이 값 이상이면 컴팩션이 따라올 때까지 쓰기 정지
+
+#define MANIFEST_FILE_NAME "MANIFEST"
+
+// 개별 엔트리: key, value, 삭제 여부를 표시하는 tombstone, 쓰기 순서를 나타내는 시퀀스 번호
 typedef struct {
     int key;
     int value;
     bool tombstone;  // true이면 삭제된 항목임을 의미
+    uint64_t seq;    // 클수록 최신 버전
 } Entry;
 
-// 메모테이블: 동적 배열로 구현
+// 아레나: 메모테이블 노드를 큰 블록에서 잘라 쓰고, 메모테이블과 함께 한꺼번에 해제
 typedef struct {
-    Entry *entries;
-    int size;
-    int capacity;
+    char *ptr;               // 현재 블록의 다음 할당 위치
+    size_t remaining;        // 현재 블록의 남은 바이트
+    char **blocks;
+    int num_blocks;
+    int block_capacity;
+    size_t memory_usage;     // 할당된 블록 바이트 합계
+} Arena;
+
+// 스킵 리스트 노드: 높이만큼의 forward 포인터가 노드 뒤에 이어서 할당됨
+typedef struct MemNode {
+    Entry entry;
+    _Atomic(struct MemNode *) next[];
+} MemNode;
+
+// 메모테이블: 아레나 기반 스킵 리스트 (같은 key의 여러 버전을 seq 내림차순으로 보관)
+typedef struct {
+    Arena arena;
+    MemNode *head;
+    atomic_int max_height;   // 현재 사용 중인 최대 높이 (reader는 락 없이 읽음)
+    int size;                // 노드(버전) 수
+    uint32_t rng;            // 레벨 결정용 난수 상태
+    atomic_int refs;         // 참조 수: 트리 + 락 없이 검색 중인 reader
 } MemTable;
 
-// SSTable: 플러시된 메모테이블 데이터를 저장 (여러 SSTable을 연결 리스트로 관리)
+// 메모테이블 반복자: 플러시와 출력에서 정렬 순서대로 순회
+typedef struct {
+    const MemTable *mt;
+    const MemNode *node;
+} MemTableIterator;
+
+// SSTable 파일에 기록되는 고정 크기 레코드
+typedef struct {
+    uint64_t seq;
+    int32_t key;
+    int32_t value;
+    uint8_t tombstone;
+    uint8_t pad[7];
+} DiskEntry;
+
+// 블록 인덱스 엔트리 (펜스 포인터): 각 데이터 블록의 key 범위와 위치
+// last_key까지 저장하므로, 블록 사이의 빈 구간에 속하는 key는 데이터 블록을 읽지 않고 배제 가능
+typedef struct {
+    int32_t first_key;
+    int32_t last_key;
+    uint32_t offset;   // 파일 내 블록 시작 오프셋 (바이트)
+    uint32_t count;    // 블록 내 엔트리 수
+} IndexEntry;
+
+// SSTable 푸터: 파일 끝에 위치하며 인덱스/필터 블록의 위치와 key 범위를 알려줌
+typedef struct {
+    uint64_t index_offset;
+    uint64_t filter_offset;
+    uint64_t max_seq;      // 파일 내 가장 큰 시퀀스 번호 (복구 시 시퀀스 카운터 복원용)
+    int32_t min_key;
+    int32_t max_key;
+    uint32_t filter_bits;  // 블룸 필터 비트 수 (m)
+    uint32_t num_hashes;   // 블룸 필터 해시 함수 수 (k)
+    uint32_t num_blocks;
+    uint32_t num_entries;
+    uint32_t magic;
+    uint32_t pad;
+} Footer;
+
+// SSTable: mmap된 불변 파일 (레벨별 연결 리스트로 관리)
 typedef struct SSTableNode {
-    Entry *entries;
-    int size;
-    int capacity;
+    uint32_t file_number;
+    int fd;
+    size_t file_size;
+    const unsigned char *base;   // mmap 시작 주소
+    const IndexEntry *index;     // mmap 영역 내 인덱스 블록
+    const unsigned char *filter; // mmap 영역 내 블룸 필터 비트 배열
+    uint32_t filter_bits;
+    int num_hashes;
+    int num_blocks;
+    int size;                    // 총 엔트리 수
+    int32_t min_key;             // 파일 내 가장 작은 key
+    int32_t max_key;             // 파일 내 가장 큰 key
+    uint64_t max_seq;
+    bool being_compacted;        // 컴팩션 입력으로 선택됨 (tree->mutex로 보호)
+    bool obsolete;               // 컴팩션으로 대체됨: 마지막 참조가 반환될 때 파일 삭제
+    atomic_int refs;             // 참조 수: 레벨 리스트 + 진행 중인 범위 스캔
     struct SSTableNode *next;
 } SSTable;
 
+// SSTable 빌더: 정렬된 엔트리를 한 개씩 받아 블록 단위로 파일에 스트리밍 기록
+typedef struct {
+    int fd;
+    uint32_t file_number;
+    char tmp[LSM_PATH_MAX + 8];
+    DiskEntry block[SSTABLE_BLOCK_ENTRIES];
+    int block_count;
+    IndexEntry *index;
+    int num_blocks;
+    int index_capacity;
+    uint64_t offset;
+    uint32_t num_entries;
+    uint64_t max_seq;
+    int32_t min_key;
+    int32_t max_key;
+    uint64_t *key_hashes;        // 블룸 필터 구성을 위해 모아 두는 key 해시 (엔트리 수는 완료 시점에 확정)
+    int hash_capacity;
+} SSTableBuilder;
+
+// 검색 통계: 각 단계에서 건너뛴 SSTable/블록 수 (필터 효과 확인용)
+// 여러 reader가 읽기 락만 잡고 동시에 갱신하므로 원자적 카운터 사용
+typedef struct {
+    atomic_llong range_skips;   // key 범위(min/max) 밖이라 건너뛴 SSTable 수
+    atomic_llong bloom_skips;   // 블룸 필터가 "없음"이라 답해 건너뛴 SSTable 수
+    atomic_llong fence_skips;   // 펜스 포인터로 블록 사이 빈 구간임이 확인된 수
+    atomic_llong block_reads;   // 실제로 데이터 블록을 이진 검색한 수
+} LookupStats;
+
+// WAL 레코드: checksum은 나머지 필드에 대해 계산 (찢어진 쓰기 감지용)
+typedef struct {
+    uint32_t checksum;
+    int32_t key;
+    int32_t value;
+    uint8_t op;        // WAL_OP_PUT 또는 WAL_OP_DELETE
+    uint8_t pad[3];
+    uint64_t seq;
+} WalRecord;
+
+enum { WAL_OP_PUT = 1, WAL_OP_DELETE = 2 };
+
+// 컴팩션 정책
+typedef enum {
+    COMPACTION_LEVELED = 0,  // 읽기/공간 증폭 최소화 (LevelDB, RocksDB 기본값)
+    COMPACTION_TIERED = 1    // 쓰기 증폭 최소화 (Cassandra STCS 계열)
+} CompactionPolicy;
+
+// LSM Tree: 데이터 디렉터리, 메모테이블, 레벨별 SSTable 목록, WAL, 백그라운드 스레드를 하나로 묶음
+//  - L0: 플러시된 SSTable, key 범위가 서로 겹칠 수 있으며 최신 SSTable이 리스트 앞쪽
+//  - L1+: leveled에서는 key 범위가 겹치지 않도록 min_key 순으로 정렬,
+//         tiered에서는 겹치는 run들이 최신 순으로 정렬
+typedef struct {
+    char dir[LSM_DIR_MAX];
+    MemTable *active;                         // 쓰기를 받는 메모테이블
+    MemTable *imm;                            // 플러시 대기/진행 중인 immutable 메모테이블 (없으면 NULL)
+    SSTable *levels[LSM_NUM_LEVELS];
+    int wal_fd;                               // 활성 메모테이블의 WAL
+    uint32_t wal_number;
+    uint32_t imm_wal_number;                  // immutable 메모테이블의 WAL (플러시 완료 후 삭제)
+    uint32_t next_file_number;
+    uint64_t last_seq;                        // 마지막으로 부여한 시퀀스 번호
+    CompactionPolicy policy;
+    int32_t compact_pointer[LSM_NUM_LEVELS];  // leveled: 레벨별 다음 컴팩션 시작 key (라운드 로빈)
+    bool has_compact_pointer[LSM_NUM_LEVELS];
+    LookupStats stats;
+
+    pthread_mutex_t mutex;
+    pthread_rwlock_t version_lock;            // 레벨 리스트 보호 (검색: 읽기, 설치: 쓰기)
+    pthread_cond_t flush_cv;                  // immutable 메모테이블 생성 알림 → 플러시 스레드
+    pthread_cond_t compact_cv;                // 레벨 구성 변경 알림 → 컴팩션 스레드
+    pthread_cond_t done_cv;                   // 플러시/컴팩션 완료 알림 → 대기 중인 writer
+    pthread_t flush_thread;
+    pthread_t compaction_threads[COMPACTION_THREADS];
+    bool shutting_down;
+    int running_compactions;
+    bool level_busy[LSM_NUM_LEVELS];          // L0 및 tiered 레벨은 동시에 하나의 컴팩션만 허용
+    bool verbose;                             // 백그라운드 작업 로그 출력 여부
+    long long slowdown_writes;                // 지연된 쓰기 수
+    long long stalled_writes;                 // 대기한 쓰기 수
+} LSMTree;
+
+// 범위 스캔의 입력 하나: 메모테이블 반복자 또는 SSTable 커서
+typedef struct {
+    MemTable *mt;                // 메모테이블 입력이면 참조 중인 메모테이블
+    MemTableIterator mem;
+    SSTable *table;              // SSTable 입력이면 참조 중인 SSTable (아니면 NULL)
+    int pos;                     // 파일 내 엔트리 인덱스
+    int block;                   // pos가 속한 블록
+    int block_end;               // 현재 블록의 끝 엔트리 인덱스
+    size_t prefetched_until;     // 미리 읽기를 요청한 파일 오프셋
+    Entry current;               // 커서가 가리키는 엔트리
+} ScanSource;
+
+// 범위 스캔 반복자: 메모테이블과 모든 레벨의 SSTable을 병합하여 [lo, hi)를 key 순서로 순회
+typedef struct {
+    LSMTree *tree;
+    ScanSource *sources;
+    int num_sources;
+    int *heap;                   // sources 인덱스의 최소 힙
+    int heap_size;
+    int hi;
+    uint64_t snapshot;           // 스캔을 연 시점의 시퀀스 번호 (이후의 쓰기는 보이지 않음)
+    bool has_last;
+    int32_t last_key;            // 마지막으로 처리한 key (이전 버전 건너뛰기용)
+    bool valid;
+    Entry current;
+} LSMIterator;
+
 // 함수 선언
 void initMemTable(MemTable *mt);
 void freeMemTable(MemTable *mt);
-void insertMemTable(MemTable *mt, int key, int value, bool tombstone);
-void sortMemTable(MemTable *mt);
+void insertMemTable(MemTable *mt, int key, int value, bool tombstone, uint64_t seq);
+size_t memTableMemoryUsage(const MemTable *mt);
+void memIterInit(MemTableIterator *it, const MemTable *mt);
+void memIterSeekToFirst(MemTableIterator *it);
+void memIterSeek(MemTableIterator *it, int key);
+bool memIterValid(const MemTableIterator *it);
+const Entry* memIterEntry(const MemTableIterator *it);
+void memIterNext(MemTableIterator *it);
 void printMemTable(MemTable *mt);
-SSTable* createSSTable(Entry *entries, int size);
-void appendSSTable(SSTable **head, SSTable *node);
-void printSSTables(SSTable *head);
-void flushMemTable(MemTable *mt, SSTable **sstables);
+void sstBuilderOpen(SSTableBuilder *b, const char *dir, uint32_t file_number);
+void sstBuilderAdd(SSTableBuilder *b, const DiskEntry *e);
+void sstBuilderFinish(SSTableBuilder *b, const char *dir);
+int writeMemTableFile(const char *dir, uint32_t file_number, const MemTable *mt);
+SSTable* openSSTable(const char *dir, uint32_t file_number);
+void closeSSTable(SSTable *table, const char *dir, bool remove_file);
+void refSSTable(SSTable *table);
+void unrefSSTable(SSTable *table, const char *dir);
+int searchSSTable(SSTable *table, int key, bool *found, bool *deleted, LookupStats *stats);
+void printSSTables(LSMTree *tree);
+void writeManifest(LSMTree *tree);
+void loadManifest(LSMTree *tree);
+void walAppend(LSMTree *tree, uint8_t op, int key, int value, uint64_t seq);
+void walReplay(LSMTree *tree);
+void resetLookupStats(LookupStats *stats);
+void openLSM(LSMTree *tree, const char *dir, CompactionPolicy policy);
+void closeLSM(LSMTree *tree);
+void destroyLSM(const char *dir);
+void flushMemTable(LSMTree *tree);
 int searchMemTable(MemTable *mt, int key, bool *found, bool *deleted);
-int binarySearch(Entry *arr, int size, int key, bool *found);
-int searchLSM(MemTable *mt, SSTable *sstables, int key, bool *found);
-void insertLSM(MemTable *mt, SSTable **sstables, int key, int value);
-void deleteLSM(MemTable *mt, SSTable **sstables, int key);
-void compactSSTables(SSTable **head);
+int searchLSM(LSMTree *tree, int key, bool *found);
+void insertLSM(LSMTree *tree, int key, int value);
+void deleteLSM(LSMTree *tree, int key);
+void compactSSTables(LSMTree *tree);
+void lsmScanOpen(LSMTree *tree, LSMIterator *it, int lo, int hi);
+bool lsmScanValid(const LSMIterator *it);
+int lsmScanKey(const LSMIterator *it);
+int lsmScanValue(const LSMIterator *it);
+void lsmScanNext(LSMIterator *it);
+void lsmScanClose(LSMIterator *it);
+
+// --- 공용 I/O 헬퍼 ---
+
+// 치명적인 I/O 오류: errno 메시지와 함께 종료
+static void die(const char *what, const char *path) {
+    fprintf(stderr, "%s 실패 (%s): %s\n", what, path, strerror(errno));
+    exit(EXIT_FAILURE);
+}
+
+// write()가 일부만 기록할 수 있으므로 모두 기록될 때까지 반복
+static void writeAll(int fd, const void *buf, size_t len, const char *path) {
+    const unsigned char *p = (const unsigned char *)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            die("write", path);
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+// rename 결과를 영속화하기 위해 디렉터리 자체를 fsync
+static void fsyncDir(const char *dir) {
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0)
+        die("디렉터리 open", dir);
+    fsync(fd);
+    close(fd);
+}
+
+static void sstablePath(char *buf, size_t len, const char *dir, uint32_t file_number) {
+    snprintf(buf, len, "%s/%06u.sst", dir, file_number);
+}
+
+// --- 블룸 필터 (CS/Data-Structured/BloomFilter 의 더블 해싱 방식) ---
+
+// 정수 key용 64비트 해시 (splitmix64 finalizer). 상위/하위 32비트를 두 개의 기본 해시로 사용
+static uint64_t bloomHash(int32_t key) {
+    uint64_t x = (uint64_t)(uint32_t)key + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// 더블 해싱: hash_i = (hash1 + i * hash2) mod m
+static void bloomSet(unsigned char *bits, uint32_t m, int k, uint64_t h) {
+    uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32);
+    for (int i = 0; i < k; i++) {
+        uint32_t pos = (h1 + (uint32_t)i * h2) % m;
+        bits[pos / 8] |= (unsigned char)(1 << (pos % 8));
+    }
+}
+
+static bool bloomMayContain(const unsigned char *bits, uint32_t m, int k, uint64_t h) {
+    uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32);
+    for (int i = 0; i < k; i++) {
+        uint32_t pos = (h1 + (uint32_t)i * h2) % m;
+        if ((bits[pos / 8] & (1 << (pos % 8))) == 0)
+            return false;
+    }
+    return true;
+}
 
 // --- MemTable Functions ---
+// 메모테이블은 CS/Data-Structured/SkipList 의 스킵 리스트를 다음과 같이 확장한 구조입니다.
+//  - 노드는 아레나에서 한 번에 할당하고, 메모테이블을 버릴 때 블록 단위로 한꺼번에 해제 (노드별 free 없음)
+//  - 노드는 (key 오름차순, seq 내림차순)으로 정렬되며 한 번 연결되면 수정/삭제되지 않음.
+//    같은 key를 다시 쓰면 덮어쓰지 않고 더 큰 seq의 노드를 앞에 추가하므로, 검색은 처음 만나는 노드가 최신 버전
+//  - writer는 tree->mutex로 직렬화되고, reader는 락 없이 탐색
+//    (새 노드는 forward 포인터를 모두 채운 뒤 release store로 연결하고, reader는 acquire load로 따라감)
 
-// 초기 메모테이블 생성: 초기 capacity를 10으로 설정
-void initMemTable(MemTable *mt) {
-    mt->capacity = 10;
-    mt->size = 0;
-    mt->entries = (Entry *)malloc(sizeof(Entry) * mt->capacity);
-    if (mt->entries == NULL) {
-        fprintf(stderr, "메모테이블 메모리 할당 실패\n");
+static void arenaInit(Arena *arena) {
+    arena->ptr = NULL;
+    arena->remaining = 0;
+    arena->blocks = NULL;
+    arena->num_blocks = 0;
+    arena->block_capacity = 0;
+    arena->memory_usage = 0;
+}
+
+static char* arenaNewBlock(Arena *arena, size_t bytes) {
+    if (arena->num_blocks == arena->block_capacity) {
+        arena->block_capacity = arena->block_capacity ? arena->block_capacity * 2 : 8;
+        arena->blocks = (char **)realloc(arena->blocks, sizeof(char *) * arena->block_capacity);
+        if (arena->blocks == NULL) {
+            fprintf(stderr, "아레나 블록 목록 메모리 할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    char *block = (char *)malloc(bytes);
+    if (block == NULL) {
+        fprintf(stderr, "아레나 블록 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
+    arena->blocks[arena->num_blocks++] = block;
+    arena->memory_usage += bytes;
+    return block;
+}
+
+// 8바이트 정렬된 bytes 크기의 메모리를 bump pointer 방식으로 할당
+// 블록의 1/4보다 큰 요청은 전용 블록을 받아 현재 블록의 남은 공간을 낭비하지 않음
+static void* arenaAllocate(Arena *arena, size_t bytes) {
+    bytes = (bytes + 7) & ~(size_t)7;
+    if (bytes > arena->remaining) {
+        if (bytes > ARENA_BLOCK_SIZE / 4)
+            return arenaNewBlock(arena, bytes);
+        arena->ptr = arenaNewBlock(arena, ARENA_BLOCK_SIZE);
+        arena->remaining = ARENA_BLOCK_SIZE;
+    }
+    void *result = arena->ptr;
+    arena->ptr += bytes;
+    arena->remaining -= bytes;
+    return result;
+}
+
+static void arenaFree(Arena *arena) {
+    for (int i = 0; i < arena->num_blocks; i++)
+        free(arena->blocks[i]);
+    free(arena->blocks);
+    arenaInit(arena);
+}
+
+// 높이 height의 노드를 아레나에서 할당 (forward 배열은 노드 뒤에 이어서 배치)
+static MemNode* newMemNode(MemTable *mt, int height, int key, int value, bool tombstone, uint64_t seq) {
+    MemNode *node = (MemNode *)arenaAllocate(&mt->arena,
+                                             sizeof(MemNode) + sizeof(_Atomic(MemNode *)) * height);
+    node->entry.key = key;
+    node->entry.value = value;
+    node->entry.tombstone = tombstone;
+    node->entry.seq = seq;
+    for (int i = 0; i < height; i++)
+        atomic_init(&node->next[i], NULL);
+    return node;
+}
+
+static MemNode* memNext(const MemNode *node, int level) {
+    return atomic_load_explicit(&((MemNode *)node)->next[level], memory_order_acquire);
 }
 
-// 메모테이블 메모리 해제
+// 노드의 (key, seq)가 찾는 위치보다 앞쪽인지: key 오름차순, 같은 key는 seq 내림차순
+static bool memNodeBefore(const MemNode *node, int key, uint64_t seq) {
+    return node->entry.key < key || (node->entry.key == key && node->entry.seq > seq);
+}
+
+// 스킵 리스트 레벨 결정: 1/MEMTABLE_BRANCHING 확률로 한 단계씩 증가 (xorshift, writer만 호출)
+static int memRandomHeight(MemTable *mt) {
+    int height = 1;
+    for (;;) {
+        uint32_t x = mt->rng;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        mt->rng = x;
+        if (height >= MEMTABLE_MAX_HEIGHT || x % MEMTABLE_BRANCHING != 0)
+            return height;
+        height++;
+    }
+}
+
+// 초기 메모테이블 생성: 헤더 노드는 최대 높이를 가지며 key를 사용하지 않음
+void initMemTable(MemTable *mt) {
+    arenaInit(&mt->arena);
+    mt->rng = 0x9E3779B9u;
+    mt->size = 0;
+    atomic_init(&mt->max_height, 1);
+    atomic_init(&mt->refs, 1);
+    mt->head = newMemNode(mt, MEMTABLE_MAX_HEIGHT, INT32_MIN, 0, false, 0);
+}
+
+// 메모테이블 메모리 해제 (아레나 블록만 해제하면 모든 노드가 함께 해제됨)
 void freeMemTable(MemTable *mt) {
-    free(mt->entries);
-    mt->entries = NULL;
+    arenaFree(&mt->arena);
+    mt->head = NULL;
     mt->size = 0;
-    mt->capacity = 0;
-}
-
-// 메모테이블에 새로운 엔트리 삽입 (정렬 상태 유지)
-// tombstone이 true이면 삭제 마커로 처리
-void insertMemTable(MemTable *mt, int key, int value, bool tombstone) {
-    // 메모테이블 확장 필요 시 capacity 증가
-    if (mt->size >= mt->capacity) {
-        mt->capacity *= 2;
-        mt->entries = (Entry *)realloc(mt->entries, sizeof(Entry) * mt->capacity);
-        if (mt->entries == NULL) {
-            fprintf(stderr, "메모테이블 재할당 실패\n");
-            exit(EXIT_FAILURE);
+}
+
+// 메모테이블이 아레나로 사용 중인 바이트 수 (플러시 임계치 판단용)
+size_t memTableMemoryUsage(const MemTable *mt) {
+    return mt->arena.memory_usage;
+}
+
+// (key, seq) 이상인 첫 노드를 찾음. prev가 NULL이 아니면 레벨별 직전 노드를 기록 (삽입용)
+static MemNode* memFindGreaterOrEqual(const MemTable *mt, int key, uint64_t seq, MemNode **prev) {
+    MemNode *x = mt->head;
+    int level = atomic_load_explicit(&mt->max_height, memory_order_relaxed) - 1;
+    for (;;) {
+        MemNode *next = memNext(x, level);
+        if (next != NULL && memNodeBefore(next, key, seq)) {
+            x = next;
+        } else {
+            if (prev != NULL)
+                prev[level] = x;
+            if (level == 0)
+                return next;
+            level--;
         }
     }
-    // 단순히 마지막에 추가 후 정렬 (작은 데이터셋이므로 효율 문제 없음)
-    mt->entries[mt->size].key = key;
-    mt->entries[mt->size].value = value;
-    mt->entries[mt->size].tombstone = tombstone;
-    mt->size++;
-    sortMemTable(mt);
 }
 
-// 간단한 버블 정렬로 메모테이블을 key 기준 오름차순 정렬
-void sortMemTable(MemTable *mt) {
-    for (int i = 0; i < mt->size - 1; i++) {
-        for (int j = 0; j < mt->size - i - 1; j++) {
-            if (mt->entries[j].key > mt->entries[j+1].key) {
-                Entry temp = mt->entries[j];
-                mt->entries[j] = mt->entries[j+1];
-                mt->entries[j+1] = temp;
-            }
-        }
+// 메모테이블에 새로운 버전 삽입: O(log n). tombstone이 true이면 삭제 마커
+// 호출자가 writer를 직렬화해야 하며(tree->mutex), 동시에 실행 중인 reader와는 안전하게 공존
+void insertMemTable(MemTable *mt, int key, int value, bool tombstone, uint64_t seq) {
+    MemNode *prev[MEMTABLE_MAX_HEIGHT];
+    memFindGreaterOrEqual(mt, key, seq, prev);
+
+    int height = memRandomHeight(mt);
+    int max_height = atomic_load_explicit(&mt->max_height, memory_order_relaxed);
+    if (height > max_height) {
+        for (int i = max_height; i < height; i++)
+            prev[i] = mt->head;
+        // reader가 새 높이를 먼저 보더라도 헤더의 해당 레벨이 NULL이므로 아래 레벨로 내려갈 뿐임
+        atomic_store_explicit(&mt->max_height, height, memory_order_relaxed);
+    }
+
+    MemNode *node = newMemNode(mt, height, key, value, tombstone, seq);
+    for (int i = 0; i < height; i++) {
+        // 노드의 forward를 먼저 채우고(아직 공개 전), release store로 연결하여 공개
+        atomic_store_explicit(&node->next[i], memNext(prev[i], i), memory_order_relaxed);
+        atomic_store_explicit(&prev[i]->next[i], node, memory_order_release);
     }
+    mt->size++;
+}
+
+// --- MemTable 반복자 ---
+// 노드를 (key 오름차순, seq 내림차순)으로 순회. 플러시는 key마다 첫 번째(최신) 버전만 사용
+
+void memIterInit(MemTableIterator *it, const MemTable *mt) {
+    it->mt = mt;
+    it->node = NULL;
+}
+
+void memIterSeekToFirst(MemTableIterator *it) {
+    it->node = memNext(it->mt->head, 0);
+}
+
+// key 이상인 첫 엔트리(해당 key의 최신 버전)로 이동
+void memIterSeek(MemTableIterator *it, int key) {
+    it->node = memFindGreaterOrEqual(it->mt, key, UINT64_MAX, NULL);
 }
 
-// 메모테이블 내용 출력 (key, value, tombstone 여부)
+bool memIterValid(const MemTableIterator *it) {
+    return it->node != NULL;
+}
+
+const Entry* memIterEntry(const MemTableIterator *it) {
+    return &it->node->entry;
+}
+
+void memIterNext(MemTableIterator *it) {
+    it->node = memNext(it->node, 0);
+}
+
+// 메모테이블 내용 출력 (key, value, seq, tombstone 여부)
 void printMemTable(MemTable *mt) {
     printf("=== MemTable (size: %d) ===\n", mt->size);
-    for (int i = 0; i < mt->size; i++) {
-        printf("[Key: %d, Value: %d, %s] ", 
-               mt->entries[i].key, 
-               mt->entries[i].value, 
-               mt->entries[i].tombstone ? "TOMBSTONE" : "VALID");
+    MemTableIterator it;
+    memIterInit(&it, mt);
+    for (memIterSeekToFirst(&it); memIterValid(&it); memIterNext(&it)) {
+        const Entry *e = memIterEntry(&it);
+        printf("[Key: %d, Value: %d, Seq: %llu, %s] ", e->key, e->value, (unsigned long long)e->seq,
+               e->tombstone ? "TOMBSTONE" : "VALID");
     }
     printf("\n");
 }
 
 // --- SSTable Functions ---
 
-// 새로운 SSTable 노드 생성: entries를 복사하여 저장
-SSTable* createSSTable(Entry *entries, int size) {
+// 빌더 시작: 임시 파일을 생성 (완료 시 rename되므로 부분적으로 기록된 SSTable은 보이지 않음)
+void sstBuilderOpen(SSTableBuilder *b, const char *dir, uint32_t file_number) {
+    char path[LSM_PATH_MAX];
+    sstablePath(path, sizeof(path), dir, file_number);
+    snprintf(b->tmp, sizeof(b->tmp), "%s.tmp", path);
+
+    b->fd = open(b->tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (b->fd < 0)
+        die("SSTable 생성", b->tmp);
+    b->file_number = file_number;
+    b->block_count = 0;
+    b->num_blocks = 0;
+    b->index_capacity = 16;
+    b->index = (IndexEntry *)malloc(sizeof(IndexEntry) * b->index_capacity);
+    if (b->index == NULL) {
+        fprintf(stderr, "SSTable 인덱스 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    b->offset = 0;
+    b->num_entries = 0;
+    b->max_seq = 0;
+    b->hash_capacity = 16;
+    b->key_hashes = (uint64_t *)malloc(sizeof(uint64_t) * b->hash_capacity);
+    if (b->key_hashes == NULL) {
+        fprintf(stderr, "SSTable 필터 버퍼 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// 현재 블록을 파일에 기록하고 인덱스 엔트리를 추가
+static void sstBuilderFlushBlock(SSTableBuilder *b) {
+    if (b->block_count == 0)
+        return;
+    if (b->num_blocks >= b->index_capacity) {
+        b->index_capacity *= 2;
+        b->index = (IndexEntry *)realloc(b->index, sizeof(IndexEntry) * b->index_capacity);
+        if (b->index == NULL) {
+            fprintf(stderr, "SSTable 인덱스 재할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    IndexEntry *ie = &b->index[b->num_blocks++];
+    ie->first_key = b->block[0].key;
+    ie->last_key = b->block[b->block_count - 1].key;
+    ie->offset = (uint32_t)b->offset;
+    ie->count = (uint32_t)b->block_count;
+    writeAll(b->fd, b->block, sizeof(DiskEntry) * b->block_count, b->tmp);
+    b->offset += sizeof(DiskEntry) * b->block_count;
+    b->block_count = 0;
+}
+
+// 엔트리 추가: 반드시 key 오름차순으로 호출해야 함
+void sstBuilderAdd(SSTableBuilder *b, const DiskEntry *e) {
+    if ((int)b->num_entries >= b->hash_capacity) {
+        b->hash_capacity *= 2;
+        b->key_hashes = (uint64_t *)realloc(b->key_hashes, sizeof(uint64_t) * b->hash_capacity);
+        if (b->key_hashes == NULL) {
+            fprintf(stderr, "SSTable 필터 버퍼 재할당 실패\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (b->num_entries == 0)
+        b->min_key = e->key;
+    b->max_key = e->key;
+    b->key_hashes[b->num_entries] = bloomHash(e->key);
+    b->block[b->block_count++] = *e;
+    b->num_entries++;
+    if (e->seq > b->max_seq)
+        b->max_seq = e->seq;
+    if (b->block_count == SSTABLE_BLOCK_ENTRIES)
+        sstBuilderFlushBlock(b);
+}
+
+// 빌더 완료: 남은 블록, 필터 블록, 인덱스 블록, 푸터를 기록한 뒤 fsync + rename
+void sstBuilderFinish(SSTableBuilder *b, const char *dir) {
+    sstBuilderFlushBlock(b);
+
+    // 블룸 필터: m = n * bits_per_key, k = bits_per_key * ln2 (거짓 양성률을 최소화하는 k)
+    uint32_t filter_bits = b->num_entries * BLOOM_BITS_PER_KEY;
+    // 8바이트 단위로 맞추어 뒤따르는 인덱스 블록이 mmap 영역에서 정렬된 주소에 오도록 함
+    filter_bits = (filter_bits + 63) / 64 * 64;
+    if (filter_bits < 64)
+        filter_bits = 64;
+    int num_hashes = (int)(BLOOM_BITS_PER_KEY * 0.69);
+    if (num_hashes < 1) num_hashes = 1;
+    if (num_hashes > 30) num_hashes = 30;
+    size_t filter_bytes = (filter_bits + 7) / 8;
+    unsigned char *filter = (unsigned char *)calloc(filter_bytes, 1);
+    if (filter == NULL) {
+        fprintf(stderr, "SSTable 필터 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < b->num_entries; i++)
+        bloomSet(filter, filter_bits, num_hashes, b->key_hashes[i]);
+    writeAll(b->fd, filter, filter_bytes, b->tmp);
+    free(filter);
+
+    Footer footer;
+    memset(&footer, 0, sizeof(footer));
+    footer.filter_offset = b->offset;
+    footer.index_offset = b->offset + filter_bytes;
+    footer.max_seq = b->max_seq;
+    footer.min_key = b->min_key;
+    footer.max_key = b->max_key;
+    footer.filter_bits = filter_bits;
+    footer.num_hashes = (uint32_t)num_hashes;
+    footer.num_blocks = (uint32_t)b->num_blocks;
+    footer.num_entries = b->num_entries;
+    footer.magic = SSTABLE_MAGIC;
+    writeAll(b->fd, b->index, sizeof(IndexEntry) * b->num_blocks, b->tmp);
+    writeAll(b->fd, &footer, sizeof(footer), b->tmp);
+
+    if (fsync(b->fd) < 0)
+        die("SSTable fsync", b->tmp);
+    close(b->fd);
+    free(b->index);
+    b->index = NULL;
+    free(b->key_hashes);
+    b->key_hashes = NULL;
+
+    char path[LSM_PATH_MAX];
+    sstablePath(path, sizeof(path), dir, b->file_number);
+    if (rename(b->tmp, path) < 0)
+        die("SSTable rename", path);
+    fsyncDir(dir);
+}
+
+// 메모테이블을 반복자로 정렬 순서대로 읽어 불변 SSTable 파일로 기록
+// 같은 key의 여러 버전 중 첫 번째(최신) 버전만 기록하며, 기록한 엔트리 수를 반환
+int writeMemTableFile(const char *dir, uint32_t file_number, const MemTable *mt) {
+    SSTableBuilder builder;
+    sstBuilderOpen(&builder, dir, file_number);
+    MemTableIterator it;
+    bool has_last = false;
+    int32_t last_key = 0;
+    memIterInit(&it, mt);
+    for (memIterSeekToFirst(&it); memIterValid(&it); memIterNext(&it)) {
+        const Entry *entry = memIterEntry(&it);
+        if (has_last && entry->key == last_key)
+            continue;
+        has_last = true;
+        last_key = entry->key;
+        DiskEntry e;
+        memset(&e, 0, sizeof(e));
+        e.seq = entry->seq;
+        e.key = entry->key;
+        e.value = entry->value;
+        e.tombstone = entry->tombstone ? 1 : 0;
+        sstBuilderAdd(&builder, &e);
+    }
+    int written = (int)builder.num_entries;
+    sstBuilderFinish(&builder, dir);
+    return written;
+}
+
+// SSTable 파일을 열고 전체를 읽기 전용으로 mmap
+// 검색은 mmap된 영역을 직접 참조하므로, 페이지 캐시가 작업 집합을 관리함 (RAM 크기 제한 없음)
+SSTable* openSSTable(const char *dir, uint32_t file_number) {
+    char path[LSM_PATH_MAX];
+    sstablePath(path, sizeof(path), dir, file_number);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        die("SSTable open", path);
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+        die("SSTable fstat", path);
+    size_t file_size = (size_t)st.st_size;
+    if (file_size < sizeof(Footer)) {
+        fprintf(stderr, "손상된 SSTable (%s): 푸터가 없습니다.\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    void *base = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED)
+        die("SSTable mmap", path);
+
+    Footer footer;
+    memcpy(&footer, (const unsigned char *)base + file_size - sizeof(Footer), sizeof(Footer));
+    if (footer.magic != SSTABLE_MAGIC || footer.num_entries == 0 ||
+        footer.index_offset + (uint64_t)footer.num_blocks * sizeof(IndexEntry) + sizeof(Footer) != file_size ||
+        footer.filter_offset + (footer.filter_bits + 7) / 8 > footer.index_offset) {
+        fprintf(stderr, "손상된 SSTable (%s): 잘못된 푸터입니다.\n", path);
+        exit(EXIT_FAILURE);
+    }
+
     SSTable *node = (SSTable *)malloc(sizeof(SSTable));
     if (node == NULL) {
         fprintf(stderr, "SSTable 노드 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    node->capacity = size;
-    node->size = size;
-    node->entries = (Entry *)malloc(sizeof(Entry) * size);
-    if (node->entries == NULL) {
-        fprintf(stderr, "SSTable entries 메모리 할당 실패\n");
-        exit(EXIT_FAILURE);
-    }
-    memcpy(node->entries, entries, sizeof(Entry) * size);
+    node->file_number = file_number;
+    node->fd = fd;
+    node->file_size = file_size;
+    node->base = (const unsigned char *)base;
+    node->index = (const IndexEntry *)(node->base + footer.index_offset);
+    node->filter = node->base + footer.filter_offset;
+    node->filter_bits = footer.filter_bits;
+    node->num_hashes = (int)footer.num_hashes;
+    node->num_blocks = (int)footer.num_blocks;
+    node->size = (int)footer.num_entries;
+    node->min_key = footer.min_key;
+    node->max_key = footer.max_key;
+    node->max_seq = footer.max_seq;
+    node->being_compacted = false;
+    node->obsolete = false;
+    atomic_init(&node->refs, 1);
     node->next = NULL;
     return node;
 }
 
-// SSTable 연결 리스트의 끝에 새로운 노드 추가
-void appendSSTable(SSTable **head, SSTable *node) {
-    if (*head == NULL) {
-        *head = node;
-    } else {
-        SSTable *curr = *head;
-        while (curr->next != NULL) {
-            curr = curr->next;
+// SSTable 매핑 해제 (remove_file이 true이면 파일도 삭제)
+void closeSSTable(SSTable *table, const char *dir, bool remove_file) {
+    munmap((void *)table->base, table->file_size);
+    close(table->fd);
+    if (remove_file) {
+        char path[LSM_PATH_MAX];
+        sstablePath(path, sizeof(path), dir, table->file_number);
+        unlink(path);
+    }
+    free(table);
+}
+
+void refSSTable(SSTable *table) {
+    atomic_fetch_add_explicit(&table->refs, 1, memory_order_relaxed);
+}
+
+// 참조 해제: 마지막 참조가 반환되면 매핑을 해제하고, 대체된(obsolete) SSTable이면 파일도 삭제
+void unrefSSTable(SSTable *table, const char *dir) {
+    if (atomic_fetch_sub_explicit(&table->refs, 1, memory_order_acq_rel) == 1)
+        closeSSTable(table, dir, table->obsolete);
+}
+
+// SSTable 검색: key 범위 → 블룸 필터 → 펜스 포인터 순으로 걸러낸 뒤, 후보 블록 안에서만 이진 검색
+// 존재하지 않는 key는 대부분 데이터 블록을 전혀 읽지 않고 O(k) 비트 검사만으로 끝남
+// stats가 NULL이 아니면 각 단계에서 걸러진 횟수를 누적
+int searchSSTable(SSTable *table, int key, bool *found, bool *deleted, LookupStats *stats) {
+    *found = false;
+    *deleted = false;
+    if (key < table->min_key || key > table->max_key) {
+        if (stats) stats->range_skips++;
+        return -1;
+    }
+    if (!bloomMayContain(table->filter, table->filter_bits, table->num_hashes, bloomHash(key))) {
+        if (stats) stats->bloom_skips++;
+        return -1;
+    }
+
+    // first_key <= key 인 마지막 블록 찾기
+    int low = 0, high = table->num_blocks - 1;
+    while (low < high) {
+        int mid = low + (high - low + 1) / 2;
+        if (table->index[mid].first_key <= key)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    const IndexEntry *ie = &table->index[low];
+    if (key > ie->last_key) {
+        if (stats) stats->fence_skips++;
+        return -1;
+    }
+    if (stats) stats->block_reads++;
+    const DiskEntry *block = (const DiskEntry *)(table->base + ie->offset);
+
+    int lo = 0, hi = (int)ie->count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (block[mid].key == key) {
+            *found = true;
+            if (block[mid].tombstone) {
+                *deleted = true;
+                return -1;
+            }
+            return block[mid].value;
+        } else if (block[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
         }
-        curr->next = node;
     }
+    return -1;
+}
+
+void resetLookupStats(LookupStats *stats) {
+    atomic_store(&stats->range_skips, 0);
+    atomic_store(&stats->bloom_skips, 0);
+    atomic_store(&stats->fence_skips, 0);
+    atomic_store(&stats->block_reads, 0);
 }
 
-// SSTable 연결 리스트 내용 출력
-void printSSTables(SSTable *head) {
-    printf("=== SSTables ===\n");
-    int tableNo = 1;
-    while (head != NULL) {
-        printf("SSTable %d (size: %d): ", tableNo, head->size);
-        for (int i = 0; i < head->size; i++) {
-            printf("[Key: %d, Value: %d, %s] ", 
-                   head->entries[i].key, 
-                   head->entries[i].value, 
-                   head->entries[i].tombstone ? "TOMBSTONE" : "VALID");
+// 레벨별 SSTable 내용 출력
+void printSSTables(LSMTree *tree) {
+    printf("=== SSTables (%s) ===\n", tree->policy == COMPACTION_LEVELED ? "leveled" : "tiered");
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        if (tree->levels[level] == NULL)
+            continue;
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+            const DiskEntry *entries = (const DiskEntry *)curr->base;
+            printf("L%d SSTable #%06u (size: %d, blocks: %d, keys: %d~%d): ", level, curr->file_number,
+                   curr->size, curr->num_blocks, curr->min_key, curr->max_key);
+            for (int i = 0; i < curr->size; i++) {
+                printf("[Key: %d, Value: %d, Seq: %llu, %s] ",
+                       entries[i].key,
+                       entries[i].value,
+                       (unsigned long long)entries[i].seq,
+                       entries[i].tombstone ? "TOMBSTONE" : "VALID");
+            }
+            printf("\n");
         }
-        printf("\n");
-        head = head->next;
-        tableNo++;
     }
 }
 
+// --- MANIFEST ---
+
+// MANIFEST: 컴팩션 정책, 다음 파일 번호, 레벨별 유효한 SSTable 목록(리스트 순서 그대로)을 기록
+// 임시 파일 기록 후 rename으로 원자적으로 교체
+void writeManifest(LSMTree *tree) {
+    char path[LSM_PATH_MAX], tmp[LSM_PATH_MAX + 8];
+    snprintf(path, sizeof(path), "%s/%s", tree->dir, MANIFEST_FILE_NAME);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *fp = fopen(tmp, "w");
+    if (fp == NULL)
+        die("MANIFEST 생성", tmp);
+    fprintf(fp, "policy %d\n", (int)tree->policy);
+    fprintf(fp, "next %u\n", tree->next_file_number);
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next)
+            fprintf(fp, "sst %d %u\n", level, curr->file_number);
+    }
+    fflush(fp);
+    if (fsync(fileno(fp)) < 0)
+        die("MANIFEST fsync", tmp);
+    fclose(fp);
+
+    if (rename(tmp, path) < 0)
+        die("MANIFEST rename", path);
+    fsyncDir(tree->dir);
+}
+
+// MANIFEST를 읽어 레벨별 SSTable 목록을 복원 (파일이 없으면 빈 트리)
+void loadManifest(LSMTree *tree) {
+    char path[LSM_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", tree->dir, MANIFEST_FILE_NAME);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        if (errno == ENOENT)
+            return;
+        die("MANIFEST open", path);
+    }
+    SSTable *tails[LSM_NUM_LEVELS] = { NULL };
+    char tag[16];
+    unsigned int a, b;
+    while (fscanf(fp, "%15s %u", tag, &a) == 2) {
+        if (strcmp(tag, "policy") == 0) {
+            // 기존 데이터의 레벨 불변식은 생성 시의 정책을 따르므로, 저장된 정책이 우선
+            if ((CompactionPolicy)a != tree->policy)
+                printf("MANIFEST에 기록된 컴팩션 정책(%s)을 사용합니다.\n",
+                       a == COMPACTION_LEVELED ? "leveled" : "tiered");
+            tree->policy = (CompactionPolicy)a;
+        } else if (strcmp(tag, "next") == 0) {
+            tree->next_file_number = a;
+        } else if (strcmp(tag, "sst") == 0 && fscanf(fp, "%u", &b) == 1 && a < LSM_NUM_LEVELS) {
+            // MANIFEST는 레벨별 리스트 순서대로 기록되어 있으므로 순서대로 뒤에 붙임
+            SSTable *node = openSSTable(tree->dir, b);
+            if (tails[a] == NULL)
+                tree->levels[a] = node;
+            else
+                tails[a]->next = node;
+            tails[a] = node;
+            if (node->max_seq > tree->last_seq)
+                tree->last_seq = node->max_seq;
+        }
+    }
+    fclose(fp);
+}
+
+// --- WAL (Write-Ahead Log) ---
+// 메모테이블마다 별도의 WAL 파일(%06u.log)을 사용합니다.
+// 활성 메모테이블이 immutable로 전환되면 새 WAL이 열리고, 이전 WAL은 immutable 메모테이블이
+// SSTable로 플러시되어 MANIFEST에 등록된 뒤에 삭제됩니다.
+
+static void walPath(char *buf, size_t len, const char *dir, uint32_t number) {
+    snprintf(buf, len, "%s/%06u.log", dir, number);
+}
+
+// FNV-1a 기반 레코드 체크섬
+static uint32_t walChecksum(const WalRecord *rec) {
+    const unsigned char *p = (const unsigned char *)rec + sizeof(rec->checksum);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(WalRecord) - sizeof(rec->checksum); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 새 WAL 파일을 만들어 활성 WAL로 지정 (tree->mutex 보유 상태 또는 백그라운드 스레드 시작 전에 호출)
+static void walOpenNew(LSMTree *tree) {
+    char path[LSM_PATH_MAX];
+    tree->wal_number = tree->next_file_number++;
+    walPath(path, sizeof(path), tree->dir, tree->wal_number);
+    tree->wal_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (tree->wal_fd < 0)
+        die("WAL open", path);
+    fsyncDir(tree->dir);
+}
+
+static void walRemove(LSMTree *tree, uint32_t number) {
+    char path[LSM_PATH_MAX];
+    walPath(path, sizeof(path), tree->dir, number);
+    unlink(path);
+}
+
+// 활성 WAL에 레코드를 추가 (메모테이블 반영 전에, tree->mutex 보유 상태에서 호출)
+void walAppend(LSMTree *tree, uint8_t op, int key, int value, uint64_t seq) {
+    WalRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.key = key;
+    rec.value = value;
+    rec.op = op;
+    rec.seq = seq;
+    rec.checksum = walChecksum(&rec);
+    writeAll(tree->wal_fd, &rec, sizeof(rec), "WAL");
+#if WAL_SYNC
+    if (fdatasync(tree->wal_fd) < 0)
+        die("WAL fdatasync", "WAL");
+#endif
+}
+
+// WAL 파일 하나를 처음부터 읽어 mt에 재생
+// 크래시로 인해 마지막 레코드가 잘렸거나 체크섬이 맞지 않으면 그 지점에서 재생을 멈춤
+static int walReplayFile(LSMTree *tree, MemTable *mt, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        die("WAL open", path);
+    WalRecord rec;
+    int replayed = 0;
+    for (;;) {
+        ssize_t n = read(fd, &rec, sizeof(rec));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n != (ssize_t)sizeof(rec))
+            break;
+        if (rec.checksum != walChecksum(&rec))
+            break;
+        insertMemTable(mt, rec.key, rec.value, rec.op == WAL_OP_DELETE, rec.seq);
+        if (rec.seq > tree->last_seq)
+            tree->last_seq = rec.seq;
+        replayed++;
+    }
+    close(fd);
+    return replayed;
+}
+
+static int compareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 데이터 디렉터리의 모든 WAL을 생성 순서(파일 번호 순)로 재생하여 L0 SSTable로 기록한 뒤 WAL 파일을 삭제
+// (종료 직전의 활성/immutable 메모테이블이 모두 복구됨). 백그라운드 스레드 시작 전에 호출
+void walReplay(LSMTree *tree) {
+    DIR *d = opendir(tree->dir);
+    if (d == NULL)
+        die("데이터 디렉터리 open", tree->dir);
+    uint32_t *numbers = NULL;
+    int count = 0, capacity = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        unsigned int number;
+        char suffix[8];
+        if (sscanf(ent->d_name, "%u.%7s", &number, suffix) != 2 || strcmp(suffix, "log") != 0)
+            continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 4;
+            numbers = (uint32_t *)realloc(numbers, sizeof(uint32_t) * capacity);
+            if (numbers == NULL) {
+                fprintf(stderr, "WAL 목록 메모리 할당 실패\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        numbers[count++] = number;
+    }
+    closedir(d);
+    if (count == 0)
+        return;
+    qsort(numbers, count, sizeof(uint32_t), compareU32);
+
+    MemTable recovered;
+    initMemTable(&recovered);
+    int replayed = 0;
+    char path[LSM_PATH_MAX];
+    for (int i = 0; i < count; i++) {
+        walPath(path, sizeof(path), tree->dir, numbers[i]);
+        replayed += walReplayFile(tree, &recovered, path);
+        // MANIFEST 기록 전에 할당된 WAL 번호와 새 파일 번호가 겹치지 않도록 함
+        if (numbers[i] >= tree->next_file_number)
+            tree->next_file_number = numbers[i] + 1;
+    }
+    if (recovered.size > 0) {
+        uint32_t file_number = tree->next_file_number++;
+        writeMemTableFile(tree->dir, file_number, &recovered);
+        SSTable *table = openSSTable(tree->dir, file_number);
+        table->next = tree->levels[0];
+        tree->levels[0] = table;
+        printf("WAL 복구: %d개의 레코드를 재생하여 L0 SSTable #%06u 로 기록했습니다.\n", replayed, file_number);
+    }
+    // 복구 결과가 MANIFEST에 등록된 뒤에만 WAL을 삭제
+    writeManifest(tree);
+    for (int i = 0; i < count; i++)
+        walRemove(tree, numbers[i]);
+    freeMemTable(&recovered);
+    free(numbers);
+}
+
 // --- LSM Tree Operations ---
 
-// 플러시: 메모테이블의 내용을 SSTable로 전환 후 메모테이블 초기화
-void flushMemTable(MemTable *mt, SSTable **sstables) {
-    if (mt->size == 0)
+static MemTable* newMemTable(void) {
+    MemTable *mt = (MemTable *)malloc(sizeof(MemTable));
+    if (mt == NULL) {
+        fprintf(stderr, "메모테이블 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    initMemTable(mt);
+    return mt;
+}
+
+static void refMemTable(MemTable *mt) {
+    atomic_fetch_add_explicit(&mt->refs, 1, memory_order_relaxed);
+}
+
+// 참조 해제: 마지막 참조(트리 또는 검색 중이던 reader)가 놓을 때 메모리 해제
+static void unrefMemTable(MemTable *mt) {
+    if (atomic_fetch_sub_explicit(&mt->refs, 1, memory_order_acq_rel) == 1) {
+        freeMemTable(mt);
+        free(mt);
+    }
+}
+
+static int countTables(SSTable *head) {
+    int count = 0;
+    for (; head != NULL; head = head->next)
+        count++;
+    return count;
+}
+
+static void* flushThreadMain(void *arg);
+static void* compactionThreadMain(void *arg);
+
+// 데이터 디렉터리를 열고, MANIFEST와 WAL로부터 이전 상태를 복구한 뒤 백그라운드 스레드를 시작
+// policy는 새 트리에만 적용되며, 기존 트리는 MANIFEST에 기록된 정책을 따름
+void openLSM(LSMTree *tree, const char *dir, CompactionPolicy policy) {
+    snprintf(tree->dir, sizeof(tree->dir), "%s", dir);
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST)
+        die("데이터 디렉터리 생성", dir);
+
+    pthread_mutex_init(&tree->mutex, NULL);
+    pthread_rwlock_init(&tree->version_lock, NULL);
+    pthread_cond_init(&tree->flush_cv, NULL);
+    pthread_cond_init(&tree->compact_cv, NULL);
+    pthread_cond_init(&tree->done_cv, NULL);
+
+    tree->active = newMemTable();
+    tree->imm = NULL;
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        tree->levels[level] = NULL;
+        tree->has_compact_pointer[level] = false;
+        tree->level_busy[level] = false;
+    }
+    tree->next_file_number = 1;
+    tree->last_seq = 0;
+    tree->policy = policy;
+    tree->running_compactions = 0;
+    tree->shutting_down = false;
+    tree->verbose = true;
+    tree->slowdown_writes = 0;
+    tree->stalled_writes = 0;
+    resetLookupStats(&tree->stats);
+    loadManifest(tree);
+    walReplay(tree);
+    walOpenNew(tree);
+
+    if (pthread_create(&tree->flush_thread, NULL, flushThreadMain, tree) != 0) {
+        fprintf(stderr, "플러시 스레드 생성 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < COMPACTION_THREADS; i++) {
+        if (pthread_create(&tree->compaction_threads[i], NULL, compactionThreadMain, tree) != 0) {
+            fprintf(stderr, "컴팩션 스레드 생성 실패\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// LSM Tree 닫기: 진행 중인 플러시/컴팩션이 끝나기를 기다린 뒤 스레드를 종료
+// 활성 메모테이블 내용은 WAL에 남아 있으므로 플러시 없이 닫아도 다음 openLSM에서 복구됨
+void closeLSM(LSMTree *tree) {
+    pthread_mutex_lock(&tree->mutex);
+    tree->shutting_down = true;
+    pthread_cond_broadcast(&tree->flush_cv);
+    pthread_cond_broadcast(&tree->compact_cv);
+    pthread_mutex_unlock(&tree->mutex);
+    pthread_join(tree->flush_thread, NULL);
+    for (int i = 0; i < COMPACTION_THREADS; i++)
+        pthread_join(tree->compaction_threads[i], NULL);
+
+    close(tree->wal_fd);
+    tree->wal_fd = -1;
+    unrefMemTable(tree->active);
+    tree->active = NULL;
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        while (tree->levels[level] != NULL) {
+            SSTable *temp = tree->levels[level];
+            tree->levels[level] = temp->next;
+            unrefSSTable(temp, tree->dir);
+        }
+    }
+    pthread_cond_destroy(&tree->done_cv);
+    pthread_cond_destroy(&tree->compact_cv);
+    pthread_cond_destroy(&tree->flush_cv);
+    pthread_rwlock_destroy(&tree->version_lock);
+    pthread_mutex_destroy(&tree->mutex);
+}
+
+// 데이터 디렉터리 내 LSM 파일(SSTable, WAL, MANIFEST)을 모두 삭제 (데모 초기화용)
+void destroyLSM(const char *dir) {
+    DIR *d = opendir(dir);
+    if (d == NULL)
         return;
-    // 새로운 SSTable 생성 (메모테이블은 이미 정렬되어 있음)
-    SSTable *newSSTable = createSSTable(mt->entries, mt->size);
-    appendSSTable(sstables, newSSTable);
-    printf("MemTable 플러시: %d개의 항목이 SSTable로 이동되었습니다.\n", mt->size);
-    // 메모테이블 초기화 (capacity 유지)
-    mt->size = 0;
+    struct dirent *ent;
+    char path[LSM_PATH_MAX];
+    while ((ent = readdir(d)) != NULL) {
+        const char *name = ent->d_name;
+        size_t len = strlen(name);
+        if ((len > 4 && strcmp(name + len - 4, ".sst") == 0) ||
+            (len > 4 && strcmp(name + len - 4, ".log") == 0) ||
+            strcmp(name, MANIFEST_FILE_NAME) == 0) {
+            snprintf(path, sizeof(path), "%s/%s", dir, name);
+            unlink(path);
+        }
+    }
+    closedir(d);
 }
 
-// 이진 검색: 정렬된 배열에서 key를 검색. found 값과 인덱스를 반환
-int binarySearch(Entry *arr, int size, int key, bool *found) {
-    int low = 0, high = size - 1, mid;
-    *found = false;
-    while (low <= high) {
-        mid = low + (high - low) / 2;
-        if (arr[mid].key == key) {
-            *found = true;
-            return mid;
-        } else if (arr[mid].key < key) {
-            low = mid + 1;
+// 활성 메모테이블을 immutable로 전환하고 새 메모테이블/WAL로 교체 (tree->mutex 보유, imm == NULL일 때 호출)
+// 실제 파일 기록은 플러시 스레드가 수행하므로 writer는 포인터 교체 비용만 부담
+static void switchMemTable(LSMTree *tree) {
+    tree->imm = tree->active;
+    tree->imm_wal_number = tree->wal_number;
+    close(tree->wal_fd);
+    walOpenNew(tree);
+    tree->active = newMemTable();
+    pthread_cond_signal(&tree->flush_cv);
+}
+
+// 쓰기 전에 활성 메모테이블에 여유가 있는지 확인 (tree->mutex 보유 상태에서 호출)
+//  - L0가 L0_SLOWDOWN_WRITES_TRIGGER 이상: 쓰기 한 번당 1ms 지연하여 컴팩션이 따라올 시간을 줌
+//  - 활성 메모테이블이 가득 찼고 이전 immutable이 아직 플러시 중: 플러시 완료까지 대기
+//  - L0가 L0_STOP_WRITES_TRIGGER 이상: 컴팩션으로 L0가 줄어들 때까지 쓰기 정지
+static void makeRoomForWrite(LSMTree *tree) {
+    bool delayed = false;
+    for (;;) {
+        int l0 = countTables(tree->levels[0]);
+        if (!delayed && l0 >= L0_SLOWDOWN_WRITES_TRIGGER) {
+            pthread_mutex_unlock(&tree->mutex);
+            usleep(1000);
+            pthread_mutex_lock(&tree->mutex);
+            tree->slowdown_writes++;
+            delayed = true;
+        } else if (tree->active->size < MEMTABLE_THRESHOLD &&
+                   memTableMemoryUsage(tree->active) < MEMTABLE_MAX_BYTES) {
+            return;
+        } else if (tree->imm != NULL) {
+            tree->stalled_writes++;
+            pthread_cond_wait(&tree->done_cv, &tree->mutex);
+        } else if (l0 >= L0_STOP_WRITES_TRIGGER) {
+            tree->stalled_writes++;
+            pthread_cond_broadcast(&tree->compact_cv);
+            pthread_cond_wait(&tree->done_cv, &tree->mutex);
         } else {
-            high = mid - 1;
+            switchMemTable(tree);
         }
     }
-    return low; // 삽입 위치
 }
 
-// 메모테이블에서 key 검색: 삭제된 항목이면 deleted를 true로 설정
+// 플러시 스레드: immutable 메모테이블이 생기면 SSTable 파일로 기록하고 L0에 등록
+static void* flushThreadMain(void *arg) {
+    LSMTree *tree = (LSMTree *)arg;
+    pthread_mutex_lock(&tree->mutex);
+    for (;;) {
+        while (tree->imm == NULL && !tree->shutting_down)
+            pthread_cond_wait(&tree->flush_cv, &tree->mutex);
+        if (tree->imm == NULL)
+            break;   // 종료 요청 + 남은 immutable 없음
+        MemTable *imm = tree->imm;
+        uint32_t wal_number = tree->imm_wal_number;
+        uint32_t file_number = tree->next_file_number++;
+        pthread_mutex_unlock(&tree->mutex);
+
+        // immutable 메모테이블은 더 이상 수정되지 않으므로 락 없이 읽어 파일로 기록
+        int written = writeMemTableFile(tree->dir, file_number, imm);
+        SSTable *table = openSSTable(tree->dir, file_number);
+
+        pthread_mutex_lock(&tree->mutex);
+        pthread_rwlock_wrlock(&tree->version_lock);
+        table->next = tree->levels[0];
+        tree->levels[0] = table;
+        pthread_rwlock_unlock(&tree->version_lock);
+        // 순서가 중요함: SSTable이 MANIFEST에 등록된 뒤에만 해당 WAL을 삭제
+        writeManifest(tree);
+        walRemove(tree, wal_number);
+        tree->imm = NULL;
+        if (tree->verbose)
+            printf("MemTable 플러시: %d개의 항목이 L0 SSTable #%06u 로 이동되었습니다.\n", written, file_number);
+        unrefMemTable(imm);
+        pthread_cond_broadcast(&tree->done_cv);
+        pthread_cond_broadcast(&tree->compact_cv);
+    }
+    pthread_mutex_unlock(&tree->mutex);
+    return NULL;
+}
+
+// 플러시: 활성 메모테이블을 강제로 immutable로 전환하고 L0 SSTable로 기록될 때까지 대기
+void flushMemTable(LSMTree *tree) {
+    pthread_mutex_lock(&tree->mutex);
+    while (tree->imm != NULL)
+        pthread_cond_wait(&tree->done_cv, &tree->mutex);
+    if (tree->active->size > 0) {
+        switchMemTable(tree);
+        while (tree->imm != NULL)
+            pthread_cond_wait(&tree->done_cv, &tree->mutex);
+    }
+    pthread_mutex_unlock(&tree->mutex);
+}
+
+// 메모테이블에서 key 검색 (락 없이 호출 가능): 삭제된 항목이면 deleted를 true로 설정
+// 같은 key의 노드 중 가장 앞쪽이 최신 버전이므로, key 이상인 첫 노드만 확인하면 됨
 int searchMemTable(MemTable *mt, int key, bool *found, bool *deleted) {
-    int idx = binarySearch(mt->entries, mt->size, key, found);
-    if (*found) {
-        if (mt->entries[idx].tombstone) {
-            *deleted = true;
-            return -1;
-        } else {
-            *deleted = false;
-            return mt->entries[idx].value;
-        }
+    MemNode *node = memFindGreaterOrEqual(mt, key, UINT64_MAX, NULL);
+    *found = false;
+    *deleted = false;
+    if (node == NULL || node->entry.key != key)
+        return -1;
+    *found = true;
+    if (node->entry.tombstone) {
+        *deleted = true;
+        return -1;
     }
-    return -1;
+    return node->entry.value;
 }
 
-// LSM Tree 검색: 먼저 메모테이블, 그 후 최신 SSTable부터 순차적으로 검색
-int searchLSM(MemTable *mt, SSTable *sstables, int key, bool *found) {
+// LSM Tree 검색: 활성 메모테이블 → immutable 메모테이블 → L0(최신 순) → L1 → ... 순서로 검색
+// 얕은 레벨일수록, 같은 레벨에서는 리스트 앞쪽일수록 최신이므로 가장 먼저 발견된 버전에서 검색을 끝냄
+// 메모테이블은 참조만 잡은 뒤 락 없이 검색하고, SSTable 검색은 읽기 락만 잡으므로
+// 여러 reader가 writer 및 플러시/컴팩션과 동시에 진행됨
+int searchLSM(LSMTree *tree, int key, bool *found) {
     bool del = false;
-    int value = searchMemTable(mt, key, found, &del);
-    if (*found && !del)
+    int value;
+    pthread_mutex_lock(&tree->mutex);
+    MemTable *active = tree->active, *imm = tree->imm;
+    refMemTable(active);
+    if (imm != NULL)
+        refMemTable(imm);
+    pthread_mutex_unlock(&tree->mutex);
+
+    value = searchMemTable(active, key, found, &del);
+    if (!*found && imm != NULL)
+        value = searchMemTable(imm, key, found, &del);
+    unrefMemTable(active);
+    if (imm != NULL)
+        unrefMemTable(imm);
+    if (*found) {
+        if (del)
+            *found = false;
         return value;
-    // 메모테이블에서 찾았으나 삭제된 경우 혹은 못찾은 경우, SSTable 검색
-    SSTable *curr = sstables;
-    while (curr != NULL) {
-        bool f = false;
-        int idx = binarySearch(curr->entries, curr->size, key, &f);
-        if (f) {
-            if (curr->entries[idx].tombstone) {
-                *found = false;
-                return -1;
-            } else {
-                *found = true;
-                return curr->entries[idx].value;
+    }
+
+    // 메모테이블에서 못 찾은 사이에 immutable이 L0로 옮겨졌더라도, 아래에서 L0를 보게 되므로 안전
+    pthread_rwlock_rdlock(&tree->version_lock);
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+            // leveled의 L1+는 min_key 순으로 정렬되어 겹치지 않으므로 조기 종료 가능
+            if (level > 0 && tree->policy == COMPACTION_LEVELED && key < curr->min_key)
+                break;
+            bool f = false;
+            value = searchSSTable(curr, key, &f, &del, &tree->stats);
+            if (f) {
+                pthread_rwlock_unlock(&tree->version_lock);
+                *found = !del;
+                return value;
             }
         }
-        curr = curr->next;
     }
+    pthread_rwlock_unlock(&tree->version_lock);
     *found = false;
     return -1;
 }
 
-// LSM Tree 삽입: 메모테이블에 삽입 후 임계치 초과 시 플러시
-void insertLSM(MemTable *mt, SSTable **sstables, int key, int value) {
-    insertMemTable(mt, key, value, false);
-    // 임계치를 넘으면 플러시
-    if (mt->size >= MEMTABLE_THRESHOLD) {
-        flushMemTable(mt, sstables);
-    }
+// 쓰기 공통 경로: 공간 확보(필요 시 대기) → 시퀀스 번호 부여 → WAL 기록 → 활성 메모테이블 삽입
+static void writeLSM(LSMTree *tree, uint8_t op, int key, int value) {
+    pthread_mutex_lock(&tree->mutex);
+    makeRoomForWrite(tree);
+    uint64_t seq = ++tree->last_seq;
+    walAppend(tree, op, key, value, seq);
+    insertMemTable(tree->active, key, value, op == WAL_OP_DELETE, seq);
+    pthread_mutex_unlock(&tree->mutex);
+}
+
+// LSM Tree 삽입: 메모테이블이 가득 차면 플러시 스레드로 넘기고 곧바로 새 메모테이블에 기록
+void insertLSM(LSMTree *tree, int key, int value) {
+    writeLSM(tree, WAL_OP_PUT, key, value);
 }
 
-// LSM Tree 삭제: tombstone을 메모테이블에 삽입하여 삭제 처리
-void deleteLSM(MemTable *mt, SSTable **sstables, int key) {
+// LSM Tree 삭제: WAL 기록 후 tombstone을 메모테이블에 삽입하여 삭제 처리
+void deleteLSM(LSMTree *tree, int key) {
     // 삭제 표시는 tombstone = true, value는 무시
-    insertMemTable(mt, key, 0, true);
-    if (mt->size >= MEMTABLE_THRESHOLD) {
-        flushMemTable(mt, sstables);
-    }
+    writeLSM(tree, WAL_OP_DELETE, key, 0);
     printf("Key %d 삭제 요청 (tombstone 기록됨).\n", key);
 }
 
-// 간단한 컴팩션: SSTable들을 모두 병합하여 최신 값 유지
-// (실제 구현에서는 각 SSTable의 타임스탬프를 고려하여 최신 데이터를 유지합니다)
-void compactSSTables(SSTable **head) {
-    if (*head == NULL || (*head)->next == NULL) {
-        printf("컴팩션 대상 SSTable이 부족합니다.\n");
-        return;
+// --- Compaction ---
+// 컴팩션 스레드 풀(COMPACTION_THREADS개)이 작업을 나누어 수행합니다.
+//  1) pick   : tree->mutex 안에서 입력 SSTable을 고르고 being_compacted로 표시 (다른 스레드와 겹치지 않게)
+//  2) run    : 락 없이 k-way 병합으로 출력 파일 기록 (입력은 불변 파일이므로 안전)
+//  3) install: mutex + version_lock(쓰기) 안에서 레벨 구성을 교체하고 MANIFEST 기록, 이후 입력 파일 삭제
+
+// k-way 병합의 입력: 이미 정렬된 SSTable 하나를 앞에서부터 순차적으로 읽는 커서
+typedef struct {
+    const DiskEntry *entries;
+    int size;
+    int pos;
+} MergeSource;
+
+// 병합 순서: key 오름차순, 같은 key라면 시퀀스 번호 내림차순 (최신 버전이 먼저 나옴)
+static bool mergeLess(const MergeSource *a, const MergeSource *b) {
+    const DiskEntry *ea = &a->entries[a->pos];
+    const DiskEntry *eb = &b->entries[b->pos];
+    if (ea->key != eb->key)
+        return ea->key < eb->key;
+    return ea->seq > eb->seq;
+}
+
+// 최소 힙 sift-down (heap에는 MergeSource 인덱스가 저장됨)
+static void mergeHeapSiftDown(int *heap, int n, int i, const MergeSource *src) {
+    for (;;) {
+        int smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < n && mergeLess(&src[heap[l]], &src[heap[smallest]]))
+            smallest = l;
+        if (r < n && mergeLess(&src[heap[r]], &src[heap[smallest]]))
+            smallest = r;
+        if (smallest == i)
+            return;
+        int temp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = temp;
+        i = smallest;
     }
-    // 우선 모든 SSTable의 엔트리를 동적 배열에 복사
-    int totalEntries = 0;
-    SSTable *curr = *head;
-    while (curr != NULL) {
-        totalEntries += curr->size;
-        curr = curr->next;
+}
+
+// 레벨 리스트에서 SSTable 하나를 떼어냄 (파일은 그대로 유지)
+static void unlinkSSTable(LSMTree *tree, int level, SSTable *table) {
+    SSTable **pp = &tree->levels[level];
+    while (*pp != NULL && *pp != table)
+        pp = &(*pp)->next;
+    if (*pp == table)
+        *pp = table->next;
+    table->next = NULL;
+}
+
+// leveled의 L1+에 SSTable을 min_key 순서로 삽입
+static void insertSSTableSorted(LSMTree *tree, int level, SSTable *table) {
+    SSTable **pp = &tree->levels[level];
+    while (*pp != NULL && (*pp)->min_key < table->min_key)
+        pp = &(*pp)->next;
+    table->next = *pp;
+    *pp = table;
+}
+
+static bool isInput(SSTable **inputs, int n, const SSTable *table) {
+    for (int i = 0; i < n; i++)
+        if (inputs[i] == table)
+            return true;
+    return false;
+}
+
+// 병합 결과가 들어갈 레벨(out_level) 이하에, 입력이 아니면서 [min_key, max_key]와 겹치는 SSTable이 없다면
+// 출력이 해당 key 범위의 가장 오래된 데이터이므로 tombstone을 안전하게 버릴 수 있음
+static bool isBottommost(LSMTree *tree, SSTable **inputs, int n, int out_level, int32_t min_key, int32_t max_key) {
+    for (int level = out_level; level < LSM_NUM_LEVELS; level++) {
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+            if (isInput(inputs, n, curr))
+                continue;
+            if (curr->max_key >= min_key && curr->min_key <= max_key)
+                return false;
+        }
     }
-    Entry *allEntries = (Entry *)malloc(sizeof(Entry) * totalEntries);
-    if (allEntries == NULL) {
+    return true;
+}
+
+// 컴팩션 작업 하나의 입력/출력 정보
+typedef struct {
+    SSTable **inputs;
+    int *input_levels;
+    int n;
+    int capacity;
+    int source_level;
+    int out_level;
+    int max_entries_per_file;   // 출력 파일당 최대 엔트리 수 (leveled는 작은 파일로 나눔)
+    bool drop_tombstones;
+    SSTable **outputs;
+    int num_outputs;
+    long long total;            // 입력 엔트리 수
+    long long written;          // 출력 엔트리 수
+} CompactionJob;
+
+static CompactionJob* newCompactionJob(int capacity) {
+    CompactionJob *job = (CompactionJob *)calloc(1, sizeof(CompactionJob));
+    if (job == NULL) {
         fprintf(stderr, "컴팩션을 위한 메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    int pos = 0;
-    curr = *head;
-    while (curr != NULL) {
-        memcpy(allEntries + pos, curr->entries, sizeof(Entry) * curr->size);
-        pos += curr->size;
-        curr = curr->next;
-    }
-    // 단순 정렬 (key 기준) - 실제 컴팩션은 더 복잡한 병합 알고리즘을 사용합니다.
-    // 버블 정렬 사용 (데모 목적)
-    for (int i = 0; i < totalEntries - 1; i++) {
-        for (int j = 0; j < totalEntries - i - 1; j++) {
-            if (allEntries[j].key > allEntries[j+1].key) {
-                Entry temp = allEntries[j];
-                allEntries[j] = allEntries[j+1];
-                allEntries[j+1] = temp;
+    job->capacity = capacity > 0 ? capacity : 1;
+    job->inputs = (SSTable **)malloc(sizeof(SSTable *) * job->capacity);
+    job->input_levels = (int *)malloc(sizeof(int) * job->capacity);
+    if (job->inputs == NULL || job->input_levels == NULL) {
+        fprintf(stderr, "컴팩션을 위한 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    return job;
+}
+
+static void freeCompactionJob(CompactionJob *job) {
+    free(job->inputs);
+    free(job->input_levels);
+    free(job->outputs);
+    free(job);
+}
+
+static void addJobInput(CompactionJob *job, SSTable *table, int level) {
+    job->inputs[job->n] = table;
+    job->input_levels[job->n] = level;
+    job->n++;
+}
+
+// level에서 [min_key, max_key]와 겹치는 SSTable을 입력에 추가
+// 그중 하나라도 다른 컴팩션이 사용 중이면 false (이 작업은 지금 수행할 수 없음)
+static bool addOverlapping(LSMTree *tree, CompactionJob *job, int level, int32_t min_key, int32_t max_key) {
+    for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+        if (curr->max_key >= min_key && curr->min_key <= max_key) {
+            if (curr->being_compacted)
+                return false;
+            addJobInput(job, curr, level);
+        }
+    }
+    return true;
+}
+
+// 선택이 끝난 작업의 입력을 사용 중으로 표시 (tree->mutex 보유)
+// L0와 tiered 레벨은 한 번에 하나의 작업만 허용하여 run 순서(최신 순)가 뒤섞이지 않게 함
+static CompactionJob* finalizeCompactionJob(LSMTree *tree, CompactionJob *job, int source_level, int out_level,
+                                            int max_entries_per_file) {
+    int32_t min_key = job->inputs[0]->min_key, max_key = job->inputs[0]->max_key;
+    for (int i = 0; i < job->n; i++) {
+        job->inputs[i]->being_compacted = true;
+        if (job->inputs[i]->min_key < min_key) min_key = job->inputs[i]->min_key;
+        if (job->inputs[i]->max_key > max_key) max_key = job->inputs[i]->max_key;
+        job->total += job->inputs[i]->size;
+    }
+    job->source_level = source_level;
+    job->out_level = out_level;
+    job->max_entries_per_file = max_entries_per_file;
+    job->drop_tombstones = isBottommost(tree, job->inputs, job->n, out_level, min_key, max_key);
+    if (source_level == 0 || tree->policy == COMPACTION_TIERED)
+        tree->level_busy[source_level] = true;
+    return job;
+}
+
+static long long levelEntries(SSTable *head) {
+    long long total = 0;
+    for (; head != NULL; head = head->next)
+        total += head->size;
+    return total;
+}
+
+// leveled: L(level)의 최대 엔트리 수 (마지막 레벨은 제한 없음)
+static long long levelMaxEntries(int level) {
+    long long limit = LEVEL1_MAX_ENTRIES;
+    for (int i = 1; i < level; i++)
+        limit *= LEVEL_SIZE_MULTIPLIER;
+    return limit;
+}
+
+// leveled 컴팩션 작업 선택 (tree->mutex 보유). 지금 수행할 작업이 없으면 NULL
+static CompactionJob* pickLeveledCompaction(LSMTree *tree) {
+    int l0_count = countTables(tree->levels[0]);
+    if (!tree->level_busy[0] && l0_count >= L0_COMPACTION_TRIGGER) {
+        // L0 → L1: L0의 SSTable들은 서로 겹치므로 전부 + L1의 겹치는 SSTable들을 함께 병합
+        CompactionJob *job = newCompactionJob(l0_count + countTables(tree->levels[1]));
+        int32_t min_key = tree->levels[0]->min_key, max_key = tree->levels[0]->max_key;
+        for (SSTable *curr = tree->levels[0]; curr != NULL; curr = curr->next) {
+            if (curr->min_key < min_key) min_key = curr->min_key;
+            if (curr->max_key > max_key) max_key = curr->max_key;
+            addJobInput(job, curr, 0);
+        }
+        if (addOverlapping(tree, job, 1, min_key, max_key))
+            return finalizeCompactionJob(tree, job, 0, 1, SSTABLE_TARGET_ENTRIES);
+        freeCompactionJob(job);
+    }
+
+    for (int level = 1; level < LSM_NUM_LEVELS - 1; level++) {
+        if (levelEntries(tree->levels[level]) <= levelMaxEntries(level))
+            continue;
+        // 라운드 로빈: 지난번 컴팩션한 key 이후의 SSTable부터 차례로 시도하여 레벨 전체를 고르게 내려보냄
+        int count = countTables(tree->levels[level]);
+        SSTable *start = tree->levels[level];
+        if (tree->has_compact_pointer[level]) {
+            for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+                if (curr->min_key > tree->compact_pointer[level]) {
+                    start = curr;
+                    break;
+                }
+            }
+        }
+        SSTable *pick = start;
+        for (int tried = 0; tried < count; tried++) {
+            if (!pick->being_compacted) {
+                CompactionJob *job = newCompactionJob(1 + countTables(tree->levels[level + 1]));
+                addJobInput(job, pick, level);
+                if (addOverlapping(tree, job, level + 1, pick->min_key, pick->max_key)) {
+                    tree->compact_pointer[level] = pick->max_key;
+                    tree->has_compact_pointer[level] = true;
+                    return finalizeCompactionJob(tree, job, level, level + 1, SSTABLE_TARGET_ENTRIES);
+                }
+                freeCompactionJob(job);
             }
+            pick = pick->next != NULL ? pick->next : tree->levels[level];
         }
     }
-    // 중복 키 및 tombstone 처리: 최신 데이터만 남김
-    // 여기서는 단순하게 동일 key가 연속되면 마지막 엔트리가 최신이라 가정
-    Entry *compacted = (Entry *)malloc(sizeof(Entry) * totalEntries);
-    int compactedSize = 0;
-    for (int i = 0; i < totalEntries; i++) {
-        // 만약 다음 엔트리와 key가 동일하면 건너뛰고 마지막 값만 사용
-        if (i < totalEntries - 1 && allEntries[i].key == allEntries[i+1].key)
+    return NULL;
+}
+
+// tiered 컴팩션 작업 선택 (tree->mutex 보유)
+// 레벨의 run 수가 TIER_MAX_RUNS에 도달하면 모든 run을 하나로 병합하여 다음 레벨로 내림
+// (마지막 레벨에서는 같은 레벨에 하나의 run으로 병합)
+static CompactionJob* pickTieredCompaction(LSMTree *tree) {
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        if (tree->level_busy[level])
+            continue;
+        int count = countTables(tree->levels[level]);
+        if (count < TIER_MAX_RUNS)
             continue;
-        // tombstone이면 실제 삭제로 간주하여 결과에 포함하지 않음
-        if (!allEntries[i].tombstone) {
-            compacted[compactedSize++] = allEntries[i];
+        CompactionJob *job = newCompactionJob(count);
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next)
+            addJobInput(job, curr, level);
+        int out_level = level < LSM_NUM_LEVELS - 1 ? level + 1 : level;
+        return finalizeCompactionJob(tree, job, level, out_level, INT32_MAX);
+    }
+    return NULL;
+}
+
+static CompactionJob* pickCompaction(LSMTree *tree) {
+    if (tree->policy == COMPACTION_LEVELED)
+        return pickLeveledCompaction(tree);
+    return pickTieredCompaction(tree);
+}
+
+// 정책상 컴팩션이 필요한 레벨이 남아 있는지 (실행 가능 여부와 무관, tree->mutex 보유)
+static bool needsCompaction(LSMTree *tree) {
+    if (tree->policy == COMPACTION_LEVELED) {
+        if (countTables(tree->levels[0]) >= L0_COMPACTION_TRIGGER)
+            return true;
+        for (int level = 1; level < LSM_NUM_LEVELS - 1; level++)
+            if (levelEntries(tree->levels[level]) > levelMaxEntries(level))
+                return true;
+        return false;
+    }
+    for (int level = 0; level < LSM_NUM_LEVELS; level++)
+        if (countTables(tree->levels[level]) >= TIER_MAX_RUNS)
+            return true;
+    return false;
+}
+
+static uint32_t allocFileNumber(LSMTree *tree) {
+    pthread_mutex_lock(&tree->mutex);
+    uint32_t number = tree->next_file_number++;
+    pthread_mutex_unlock(&tree->mutex);
+    return number;
+}
+
+static void addJobOutput(LSMTree *tree, CompactionJob *job, SSTableBuilder *builder, int *out_capacity) {
+    uint32_t file_number = builder->file_number;
+    sstBuilderFinish(builder, tree->dir);
+    if (job->num_outputs == *out_capacity) {
+        *out_capacity = *out_capacity ? *out_capacity * 2 : 4;
+        job->outputs = (SSTable **)realloc(job->outputs, sizeof(SSTable *) * *out_capacity);
+        if (job->outputs == NULL) {
+            fprintf(stderr, "컴팩션을 위한 메모리 재할당 실패\n");
+            exit(EXIT_FAILURE);
         }
     }
-    free(allEntries);
+    job->outputs[job->num_outputs++] = openSSTable(tree->dir, file_number);
+}
+
+// 입력을 k-way 힙 병합하여 새 SSTable(들)로 기록 (락 없이 실행)
+// - 입력은 각각 정렬되어 있으므로, 병합 비용은 다시 쓰는 바이트 수에 비례 (O(N log k))
+// - 같은 key의 여러 버전 중 시퀀스 번호가 가장 큰 버전만 남김
+// - max_entries_per_file마다 출력 파일을 나누어 다음 컴팩션의 단위를 작게 유지 (leveled)
+static void runCompaction(LSMTree *tree, CompactionJob *job) {
+    int n = job->n;
+    MergeSource *src = (MergeSource *)malloc(sizeof(MergeSource) * n);
+    int *heap = (int *)malloc(sizeof(int) * n);
+    if (src == NULL || heap == NULL) {
+        fprintf(stderr, "컴팩션을 위한 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    int heap_size = 0;
+    for (int i = 0; i < n; i++) {
+        src[i].entries = (const DiskEntry *)job->inputs[i]->base;
+        src[i].size = job->inputs[i]->size;
+        src[i].pos = 0;
+        heap[heap_size++] = i;
+    }
+    for (int i = heap_size / 2 - 1; i >= 0; i--)
+        mergeHeapSiftDown(heap, heap_size, i, src);
 
-    // 새로운 SSTable 생성 후 기존 SSTable 리스트 해제
-    SSTable *newSSTable = createSSTable(compacted, compactedSize);
-    free(compacted);
-    // 해제: 기존 SSTable 리스트 해제
-    curr = *head;
-    while (curr != NULL) {
-        SSTable *temp = curr;
-        curr = curr->next;
-        free(temp->entries);
-        free(temp);
+    SSTableBuilder builder;
+    bool builder_open = false;
+    bool has_last = false;
+    int32_t last_key = 0;
+    int out_capacity = 0;
+    while (heap_size > 0) {
+        MergeSource *top = &src[heap[0]];
+        DiskEntry e = top->entries[top->pos];
+        // 커서 전진: 소진되면 힙에서 제거
+        if (++top->pos == top->size)
+            heap[0] = heap[--heap_size];
+        mergeHeapSiftDown(heap, heap_size, 0, src);
+
+        // 같은 key의 첫 번째(=최신) 버전만 사용하고 나머지 오래된 버전은 버림
+        if (has_last && e.key == last_key)
+            continue;
+        has_last = true;
+        last_key = e.key;
+        if (e.tombstone && job->drop_tombstones)
+            continue;
+
+        if (!builder_open) {
+            sstBuilderOpen(&builder, tree->dir, allocFileNumber(tree));
+            builder_open = true;
+        }
+        sstBuilderAdd(&builder, &e);
+        job->written++;
+        if ((int)builder.num_entries >= job->max_entries_per_file) {
+            addJobOutput(tree, job, &builder, &out_capacity);
+            builder_open = false;
+        }
     }
-    *head = newSSTable;
-    printf("컴팩션 완료: SSTable이 병합되었습니다. (새 크기: %d)\n", newSSTable->size);
+    if (builder_open)
+        addJobOutput(tree, job, &builder, &out_capacity);
+    free(heap);
+    free(src);
+}
+
+// 레벨 구성 교체: 입력 제거 → 출력 추가 → MANIFEST 기록 (tree->mutex 보유)
+// 입력 파일의 삭제는 호출자가 락을 푼 뒤 수행 (이 시점 이후 새 reader는 입력을 볼 수 없음)
+static void installCompaction(LSMTree *tree, CompactionJob *job) {
+    pthread_rwlock_wrlock(&tree->version_lock);
+    for (int i = 0; i < job->n; i++)
+        unlinkSSTable(tree, job->input_levels[i], job->inputs[i]);
+    if (tree->policy == COMPACTION_LEVELED && job->out_level > 0) {
+        for (int i = 0; i < job->num_outputs; i++)
+            insertSSTableSorted(tree, job->out_level, job->outputs[i]);
+    } else if (job->out_level != job->source_level) {
+        // tiered: 새 run은 다음 레벨에서 가장 최신이므로 앞쪽에 추가 (출력 순서 유지)
+        for (int i = job->num_outputs - 1; i >= 0; i--) {
+            job->outputs[i]->next = tree->levels[job->out_level];
+            tree->levels[job->out_level] = job->outputs[i];
+        }
+    } else {
+        // tiered 마지막 레벨: 선택 이후에 도착한 run이 더 최신이므로 출력은 뒤쪽에 추가
+        SSTable **pp = &tree->levels[job->out_level];
+        while (*pp != NULL)
+            pp = &(*pp)->next;
+        for (int i = 0; i < job->num_outputs; i++) {
+            *pp = job->outputs[i];
+            pp = &job->outputs[i]->next;
+        }
+        *pp = NULL;
+    }
+    pthread_rwlock_unlock(&tree->version_lock);
+    writeManifest(tree);
+    tree->level_busy[job->source_level] = false;
+
+    if (tree->verbose)
+        printf("컴팩션 완료: %d개 SSTable(%lld 엔트리) → L%d %d개 SSTable(%lld 엔트리)%s\n",
+               job->n, job->total, job->out_level, job->num_outputs, job->written,
+               job->drop_tombstones ? ", 최하위 병합(tombstone 제거)" : "");
+}
+
+// 컴팩션 스레드: 수행 가능한 작업이 생길 때까지 대기 → 병합 → 설치를 반복
+static void* compactionThreadMain(void *arg) {
+    LSMTree *tree = (LSMTree *)arg;
+    pthread_mutex_lock(&tree->mutex);
+    for (;;) {
+        CompactionJob *job = NULL;
+        while (!tree->shutting_down && (job = pickCompaction(tree)) == NULL)
+            pthread_cond_wait(&tree->compact_cv, &tree->mutex);
+        if (job == NULL)
+            break;
+        tree->running_compactions++;
+        pthread_mutex_unlock(&tree->mutex);
+
+        runCompaction(tree, job);
+
+        pthread_mutex_lock(&tree->mutex);
+        installCompaction(tree, job);
+        pthread_mutex_unlock(&tree->mutex);
+        for (int i = 0; i < job->n; i++) {
+            // 범위 스캔이 아직 입력을 참조 중이면 파일 삭제는 스캔 종료 시점으로 미뤄짐
+            job->inputs[i]->obsolete = true;
+            unrefSSTable(job->inputs[i], tree->dir);
+        }
+        freeCompactionJob(job);
+
+        pthread_mutex_lock(&tree->mutex);
+        tree->running_compactions--;
+        // L0가 줄었을 수 있으므로 멈춘 writer를 깨우고, 다른 스레드가 이어서 할 작업이 있는지 확인하게 함
+        pthread_cond_broadcast(&tree->done_cv);
+        pthread_cond_broadcast(&tree->compact_cv);
+    }
+    pthread_mutex_unlock(&tree->mutex);
+    return NULL;
+}
+
+// 컴팩션: 백그라운드 스레드를 깨우고, 정책상 한도를 넘는 레벨이 없어질 때까지 대기
+// (한 번의 컴팩션은 한 레벨의 일부만 다시 쓰므로 비용이 레벨 단위로 제한됨)
+void compactSSTables(LSMTree *tree) {
+    pthread_mutex_lock(&tree->mutex);
+    pthread_cond_broadcast(&tree->compact_cv);
+    while (tree->imm != NULL || tree->running_compactions > 0 || needsCompaction(tree))
+        pthread_cond_wait(&tree->done_cv, &tree->mutex);
+    pthread_mutex_unlock(&tree->mutex);
+}
+
+// --- Range Scan (Merging Iterator) ---
+// [lo, hi) 범위를 key 오름차순으로 순회합니다.
+//  - 열 때 tree->mutex 안에서 시퀀스 번호 스냅샷을 잡고, 메모테이블과 범위가 겹치는 SSTable의 참조를 획득
+//    → 이후 락 없이 순회하며, 도중에 플러시/컴팩션이 일어나도 열린 시점의 일관된 상태를 봄
+//  - 각 입력(메모테이블/SSTable)의 커서를 최소 힙으로 병합: key 오름차순, 같은 key는 seq 내림차순
+//  - key마다 가장 최신 버전만 내보내고, 최신 버전이 tombstone이면 해당 key를 숨김
+//  - SSTable 커서는 새 블록에 들어설 때 다음 블록을 미리 읽도록 요청 (madvise + 캐시 프리페치)
+
+static size_t scanPageSize(void) {
+    static size_t page_size = 0;
+    if (page_size == 0)
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+// SSTable 블록 프리페치: 아직 요청하지 않은 페이지에 걸친 블록이면 커널에 미리 읽기(readahead)를 요청하여
+// 순회가 해당 블록에 도달했을 때 mmap 페이지 폴트로 멈추지 않게 하고, 블록 첫 캐시 라인도 미리 가져옴
+static void scanPrefetchBlock(ScanSource *src, int block) {
+    const SSTable *table = src->table;
+    if (block >= table->num_blocks)
+        return;
+    const IndexEntry *ie = &table->index[block];
+    size_t page = scanPageSize();
+    size_t start = ie->offset & ~(page - 1);
+    size_t end = ie->offset + (size_t)ie->count * sizeof(DiskEntry);
+    if (end > src->prefetched_until) {
+        if (start < src->prefetched_until)
+            start = src->prefetched_until;
+        end = (end + page - 1) & ~(page - 1);
+        if (end > table->file_size)
+            end = table->file_size;
+        if (end > start)
+            madvise((void *)(table->base + start), end - start, MADV_WILLNEED);
+        src->prefetched_until = end;
+    }
+    __builtin_prefetch(table->base + ie->offset);
+}
+
+// 커서가 가리키는 엔트리를 src->current에 채움. 입력이 끝났으면 false
+static bool scanSourceLoad(ScanSource *src, uint64_t snapshot) {
+    if (src->table == NULL) {
+        // 메모테이블: 스냅샷 이후에 들어온 쓰기는 건너뜀
+        while (memIterValid(&src->mem) && memIterEntry(&src->mem)->seq > snapshot)
+            memIterNext(&src->mem);
+        if (!memIterValid(&src->mem))
+            return false;
+        src->current = *memIterEntry(&src->mem);
+        return true;
+    }
+    if (src->pos >= src->table->size)
+        return false;
+    const DiskEntry *e = &((const DiskEntry *)src->table->base)[src->pos];
+    src->current.key = e->key;
+    src->current.value = e->value;
+    src->current.tombstone = e->tombstone != 0;
+    src->current.seq = e->seq;
+    return true;
+}
+
+// SSTable 커서를 lo 이상인 첫 엔트리로 이동: 펜스 포인터로 블록을 찾고 블록 안에서 이진 검색
+static void scanSourceSeekSSTable(ScanSource *src, int lo) {
+    const SSTable *table = src->table;
+    int low = 0, high = table->num_blocks;
+    while (low < high) {   // last_key >= lo 인 첫 블록
+        int mid = low + (high - low) / 2;
+        if (table->index[mid].last_key < lo)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    src->block = low;
+    src->pos = table->size;
+    if (low == table->num_blocks)
+        return;
+    const IndexEntry *ie = &table->index[low];
+    const DiskEntry *block = (const DiskEntry *)(table->base + ie->offset);
+    int l = 0, h = (int)ie->count;
+    while (l < h) {
+        int mid = l + (h - l) / 2;
+        if (block[mid].key < lo)
+            l = mid + 1;
+        else
+            h = mid;
+    }
+    src->pos = (int)(ie->offset / sizeof(DiskEntry)) + l;
+    src->block_end = (int)(ie->offset / sizeof(DiskEntry) + ie->count);
+    scanPrefetchBlock(src, low);
+    scanPrefetchBlock(src, low + 1);
+}
+
+static void scanSourceAdvance(ScanSource *src) {
+    if (src->table == NULL) {
+        memIterNext(&src->mem);
+        return;
+    }
+    if (++src->pos == src->block_end && src->pos < src->table->size) {
+        // 다음 블록으로 진입: 그다음 블록을 미리 읽어 둠
+        src->block++;
+        src->block_end += (int)src->table->index[src->block].count;
+        scanPrefetchBlock(src, src->block + 1);
+    }
+}
+
+// 병합 순서: key 오름차순, 같은 key라면 시퀀스 번호 내림차순 (최신 버전이 먼저 나옴)
+static bool scanLess(const ScanSource *a, const ScanSource *b) {
+    if (a->current.key != b->current.key)
+        return a->current.key < b->current.key;
+    return a->current.seq > b->current.seq;
+}
+
+static void scanHeapSiftDown(LSMIterator *it, int i) {
+    int *heap = it->heap;
+    for (;;) {
+        int smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < it->heap_size && scanLess(&it->sources[heap[l]], &it->sources[heap[smallest]]))
+            smallest = l;
+        if (r < it->heap_size && scanLess(&it->sources[heap[r]], &it->sources[heap[smallest]]))
+            smallest = r;
+        if (smallest == i)
+            return;
+        int temp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = temp;
+        i = smallest;
+    }
+}
+
+static void scanAddMemTable(LSMIterator *it, MemTable *mt, int lo) {
+    ScanSource *src = &it->sources[it->num_sources++];
+    refMemTable(mt);
+    src->mt = mt;
+    src->table = NULL;
+    memIterInit(&src->mem, mt);
+    memIterSeek(&src->mem, lo);
+}
+
+static void scanAddSSTable(LSMIterator *it, SSTable *table, int lo) {
+    ScanSource *src = &it->sources[it->num_sources++];
+    refSSTable(table);
+    src->mt = NULL;
+    src->table = table;
+    src->prefetched_until = 0;
+    scanSourceSeekSSTable(src, lo);
+}
+
+// 다음으로 내보낼 엔트리를 찾음: 이미 내보낸(또는 숨긴) key의 오래된 버전과 tombstone을 건너뜀
+static void scanFindNext(LSMIterator *it) {
+    while (it->heap_size > 0) {
+        ScanSource *top = &it->sources[it->heap[0]];
+        Entry e = top->current;
+        if (e.key >= it->hi)
+            break;
+        scanSourceAdvance(top);
+        if (!scanSourceLoad(top, it->snapshot))
+            it->heap[0] = it->heap[--it->heap_size];
+        scanHeapSiftDown(it, 0);
+
+        if (it->has_last && e.key == it->last_key)
+            continue;   // 가려진(shadowed) 이전 버전
+        it->has_last = true;
+        it->last_key = e.key;
+        if (e.tombstone)
+            continue;   // 최신 버전이 삭제 표시이므로 key 전체를 숨김
+        it->current = e;
+        it->valid = true;
+        return;
+    }
+    it->valid = false;
+}
+
+// [lo, hi) 범위 스캔 시작. 사용 후 반드시 lsmScanClose로 참조를 반환해야 함 (closeLSM 전에)
+void lsmScanOpen(LSMTree *tree, LSMIterator *it, int lo, int hi) {
+    memset(it, 0, sizeof(*it));
+    it->tree = tree;
+    it->hi = hi;
+
+    pthread_mutex_lock(&tree->mutex);
+    it->snapshot = tree->last_seq;
+    int capacity = 2;
+    for (int level = 0; level < LSM_NUM_LEVELS; level++)
+        capacity += countTables(tree->levels[level]);
+    it->sources = (ScanSource *)malloc(sizeof(ScanSource) * capacity);
+    it->heap = (int *)malloc(sizeof(int) * capacity);
+    if (it->sources == NULL || it->heap == NULL) {
+        fprintf(stderr, "범위 스캔을 위한 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    scanAddMemTable(it, tree->active, lo);
+    if (tree->imm != NULL)
+        scanAddMemTable(it, tree->imm, lo);
+    // 레벨 구성 변경(설치)은 tree->mutex 안에서만 일어나므로 여기서는 읽기 락이 필요 없음
+    for (int level = 0; level < LSM_NUM_LEVELS; level++) {
+        for (SSTable *curr = tree->levels[level]; curr != NULL; curr = curr->next) {
+            if (curr->max_key >= lo && curr->min_key < hi)
+                scanAddSSTable(it, curr, lo);
+        }
+    }
+    pthread_mutex_unlock(&tree->mutex);
+
+    for (int i = 0; i < it->num_sources; i++)
+        if (scanSourceLoad(&it->sources[i], it->snapshot))
+            it->heap[it->heap_size++] = i;
+    for (int i = it->heap_size / 2 - 1; i >= 0; i--)
+        scanHeapSiftDown(it, i);
+    scanFindNext(it);
+}
+
+bool lsmScanValid(const LSMIterator *it) {
+    return it->valid;
+}
+
+int lsmScanKey(const LSMIterator *it) {
+    return it->current.key;
+}
+
+int lsmScanValue(const LSMIterator *it) {
+    return it->current.value;
+}
+
+void lsmScanNext(LSMIterator *it) {
+    scanFindNext(it);
+}
+
+// 스캔 종료: 잡고 있던 메모테이블/SSTable 참조를 반환 (컴팩션으로 대체된 SSTable은 이때 삭제될 수 있음)
+void lsmScanClose(LSMIterator *it) {
+    for (int i = 0; i < it->num_sources; i++) {
+        if (it->sources[i].table != NULL)
+            unrefSSTable(it->sources[i].table, it->tree->dir);
+        else
+            unrefMemTable(it->sources[i].mt);
+    }
+    free(it->sources);
+    free(it->heap);
+    it->sources = NULL;
+    it->heap = NULL;
+    it->valid = false;
 }
 
 // --- main 함수 ---
+
+// 검색 결과 출력 헬퍼
+static void printSearch(LSMTree *tree, const char *label, int key) {
+    bool found = false;
+    int val = searchLSM(tree, key, &found);
+    if (found)
+        printf("%s: Key %d found with value %d\n", label, key, val);
+    else
+        printf("%s: Key %d not found\n", label, key);
+}
+
+// 범위 스캔 결과 출력 헬퍼
+static void printScan(LSMTree *tree, const char *label, int lo, int hi) {
+    LSMIterator it;
+    printf("%s [%d, %d): ", label, lo, hi);
+    for (lsmScanOpen(tree, &it, lo, hi); lsmScanValid(&it); lsmScanNext(&it))
+        printf("(%d, %d) ", lsmScanKey(&it), lsmScanValue(&it));
+    lsmScanClose(&it);
+    printf("\n");
+}
+
+static double nowMicros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// 쓰기 부하 중에 동시에 검색을 수행하는 reader (메모테이블은 락 없이 검색됨)
+typedef struct {
+    LSMTree *tree;
+    atomic_bool stop;
+    long long lookups;
+    long long errors;
+} ReaderArgs;
+
+static void* readerThreadMain(void *arg) {
+    ReaderArgs *args = (ReaderArgs *)arg;
+    while (!atomic_load(&args->stop)) {
+        // 쓰기 부하 전에 기록된 key: 항상 최신 값이 보여야 함
+        bool found = false;
+        int value = searchLSM(args->tree, 12, &found);
+        if (!found || value != 1201)
+            args->errors++;
+        args->lookups++;
+    }
+    return NULL;
+}
+
 int main(void) {
-    MemTable memtable;
-    SSTable *sstables = NULL;
-    initMemTable(&memtable);
-    
-    printf("=== LSM Tree Demo ===\n\n");
-    
-    // 삽입 테스트
-    int keys_to_insert[] = {15, 10, 20, 5, 12, 25, 18, 30, 7};
+    const char *dir = "lsm_data";
+    LSMTree tree;
+    destroyLSM(dir);   // 데모를 항상 빈 상태에서 시작
+    openLSM(&tree, dir, COMPACTION_LEVELED);
+
+    printf("=== LSM Tree Demo (leveled compaction) ===\n\n");
+
+    // 삽입 테스트 (플러시와 컴팩션은 백그라운드 스레드에서 진행)
+    int keys_to_insert[] = {15, 10, 20, 5, 12, 25, 18, 30, 7, 3, 27, 22, 9, 1, 14, 28, 11, 6};
     int n = sizeof(keys_to_insert) / sizeof(keys_to_insert[0]);
     for (int i = 0; i < n; i++) {
-        insertLSM(&memtable, &sstables, keys_to_insert[i], keys_to_insert[i] * 100);
+        insertLSM(&tree, keys_to_insert[i], keys_to_insert[i] * 100);
         printf("Inserted key %d with value %d\n", keys_to_insert[i], keys_to_insert[i]*100);
     }
-    
-    // 남은 메모테이블 플러시
-    flushMemTable(&memtable, &sstables);
-    
-    printf("\n현재 상태:\n");
-    printMemTable(&memtable);
-    printSSTables(sstables);
-    
+
+    // 갱신: 같은 key의 새 버전은 더 큰 시퀀스 번호를 가지므로 컴팩션 후에도 최신 값이 남음
+    insertLSM(&tree, 12, 1201);
+    insertLSM(&tree, 5, 501);
+    insertLSM(&tree, 30, 3001);
+
+    // 백그라운드 작업이 끝날 때까지 대기한 뒤 상태 출력
+    compactSSTables(&tree);
+    printf("\n현재 상태 (활성 메모테이블의 항목은 WAL에만 기록됨):\n");
+    printMemTable(tree.active);
+    printSSTables(&tree);
+
+    // 재시작 테스트: 플러시 없이 닫았다가 다시 열어 WAL로부터 복구
+    printf("\n--- 재시작 (플러시 없이 종료 후 재오픈) ---\n");
+    closeLSM(&tree);
+    openLSM(&tree, dir, COMPACTION_LEVELED);
+
     // 검색 테스트
-    int search_keys[] = {12, 20, 100};
+    int search_keys[] = {12, 20, 5, 30, 100};
     int m = sizeof(search_keys) / sizeof(search_keys[0]);
-    for (int i = 0; i < m; i++) {
-        bool found = false;
-        int val = searchLSM(&memtable, sstables, search_keys[i], &found);
-        if (found)
-            printf("\nSearch: Key %d found with value %d\n", search_keys[i], val);
-        else
-            printf("\nSearch: Key %d not found\n", search_keys[i]);
-    }
-    
+    printf("\n");
+    for (int i = 0; i < m; i++)
+        printSearch(&tree, "Search", search_keys[i]);
+
     // 삭제 테스트
-    int keys_to_delete[] = {10, 25};
+    int keys_to_delete[] = {10, 25, 3};
     int d = sizeof(keys_to_delete) / sizeof(keys_to_delete[0]);
     for (int i = 0; i < d; i++) {
-        deleteLSM(&memtable, &sstables, keys_to_delete[i]);
+        deleteLSM(&tree, keys_to_delete[i]);
     }
-    
-    // 플러시 후 삭제 반영
-    flushMemTable(&memtable, &sstables);
-    
+
+    // 플러시 후 삭제 반영 (필요 시 컴팩션이 자동으로 이어짐)
+    flushMemTable(&tree);
+    compactSSTables(&tree);
+
     printf("\n삭제 후 상태:\n");
-    printMemTable(&memtable);
-    printSSTables(sstables);
-    
-    // 컴팩션 테스트: SSTable 병합
-    compactSSTables(&sstables);
-    printSSTables(sstables);
-    
+    printMemTable(tree.active);
+    printSSTables(&tree);
+
     // 최종 검색 테스트 (삭제된 키 확인)
-    for (int i = 0; i < d; i++) {
+    for (int i = 0; i < d; i++)
+        printSearch(&tree, "After delete", keys_to_delete[i]);
+
+    // 범위 스캔: 메모테이블 + 모든 레벨을 병합하며, 덮어쓴 이전 버전과 삭제된 key(10, 25, 3)는 나타나지 않음
+    insertLSM(&tree, 7, 701);   // 메모테이블에만 있는 최신 버전
+    printf("\n");
+    printScan(&tree, "Scan", 0, 100);
+    printScan(&tree, "Scan", 5, 20);
+
+    // 음성 조회(존재하지 않는 key) 테스트: key 범위/블룸 필터/펜스 포인터가 블록 읽기를 얼마나 줄이는지 확인
+    resetLookupStats(&tree.stats);
+    int misses = 0;
+    for (int key = -20; key < 60; key++) {
         bool found = false;
-        int val = searchLSM(&memtable, sstables, keys_to_delete[i], &found);
-        if (found)
-            printf("\nAfter compaction: Key %d found with value %d\n", keys_to_delete[i], val);
-        else
-            printf("\nAfter compaction: Key %d not found (deleted)\n", keys_to_delete[i]);
-    }
-    
-    // 메모리 해제
-    freeMemTable(&memtable);
-    // SSTable 리스트 해제
-    while (sstables != NULL) {
-        SSTable *temp = sstables;
-        sstables = sstables->next;
-        free(temp->entries);
-        free(temp);
-    }
-    
+        searchLSM(&tree, key, &found);
+        if (!found)
+            misses++;
+    }
+    printf("\n조회 80회 중 %d회 미존재: 범위 제외 %lld, 블룸 필터 제외 %lld, 펜스 포인터 제외 %lld, 블록 검색 %lld\n",
+           misses, (long long)tree.stats.range_skips, (long long)tree.stats.bloom_skips,
+           (long long)tree.stats.fence_skips, (long long)tree.stats.block_reads);
+
+    // 쓰기 부하 테스트: writer는 메모테이블 교체만 하고 플러시/컴팩션은 백그라운드에서 진행
+    // L0가 쌓이면 slowdown/stop 트리거가 writer 속도를 조절하여 L0가 무한히 커지지 않게 함
+    tree.verbose = false;
+    ReaderArgs reader = { .tree = &tree, .lookups = 0, .errors = 0 };
+    atomic_init(&reader.stop, false);
+    pthread_t reader_thread;
+    if (pthread_create(&reader_thread, NULL, readerThreadMain, &reader) != 0) {
+        fprintf(stderr, "reader 스레드 생성 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    int bulk = 1000;
+    double max_latency = 0, start = nowMicros();
+    for (int i = 0; i < bulk; i++) {
+        double t0 = nowMicros();
+        insertLSM(&tree, (int)((i * 7919L) % 5000), i);
+        double latency = nowMicros() - t0;
+        if (latency > max_latency)
+            max_latency = latency;
+    }
+    double elapsed = nowMicros() - start;
+    atomic_store(&reader.stop, true);
+    pthread_join(reader_thread, NULL);
+    compactSSTables(&tree);
+    printf("\n쓰기 %d회: 총 %.1f ms, 최대 지연 %.1f us, slowdown %lld회, stall %lld회\n",
+           bulk, elapsed / 1000.0, max_latency, tree.slowdown_writes, tree.stalled_writes);
+    printf("동시 검색 %lld회, 잘못된 결과 %lld회\n", reader.lookups, reader.errors);
+    for (int level = 0; level < LSM_NUM_LEVELS; level++)
+        printf("L%d: SSTable %d개, 엔트리 %lld개\n", level, countTables(tree.levels[level]),
+               levelEntries(tree.levels[level]));
+    printSearch(&tree, "Bulk search", (int)((999 * 7919L) % 5000));
+
+    // 스캔을 열어 둔 채로 쓰기/컴팩션이 일어나도 스캔은 연 시점의 상태를 그대로 봄
+    LSMIterator scan;
+    long long scanned = 0;
+    lsmScanOpen(&tree, &scan, 1000, 2000);
+    for (int i = 0; i < 200; i++)
+        insertLSM(&tree, 1000 + i * 5, -i);
+    compactSSTables(&tree);
+    for (; lsmScanValid(&scan); lsmScanNext(&scan)) {
+        if (lsmScanValue(&scan) < 0)
+            printf("스냅샷 이후의 쓰기가 보임: key %d\n", lsmScanKey(&scan));
+        scanned++;
+    }
+    lsmScanClose(&scan);
+    printf("스냅샷 스캔 [1000, 2000): %lld개 엔트리\n", scanned);
+    closeLSM(&tree);
+
+    // 같은 작업을 tiered 정책으로 수행하여 레벨 구성 비교
+    printf("\n=== LSM Tree Demo (tiered compaction) ===\n\n");
+    const char *tiered_dir = "lsm_data_tiered";
+    destroyLSM(tiered_dir);
+    openLSM(&tree, tiered_dir, COMPACTION_TIERED);
+    for (int i = 0; i < n; i++)
+        insertLSM(&tree, keys_to_insert[i], keys_to_insert[i] * 100);
+    for (int i = 0; i < d; i++)
+        deleteLSM(&tree, keys_to_delete[i]);
+    flushMemTable(&tree);
+    compactSSTables(&tree);
+    printSSTables(&tree);
+    for (int i = 0; i < d; i++)
+        printSearch(&tree, "Tiered search", keys_to_delete[i]);
+    printSearch(&tree, "Tiered search", 14);
+    printScan(&tree, "Tiered scan", 0, 100);
+
+    // 스레드 종료, 파일 매핑 및 메모리 해제 (데이터 파일은 디스크에 남음)
+    closeLSM(&tree);
+
     return 0;
-}
\ No newline at end of file
+}
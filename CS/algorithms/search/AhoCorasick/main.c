@@ -8,22 +8,38 @@
  * - 검색 결과는 Occurrence 구조체 배열로 반환되며, 각 Occurrence는 패턴 ID와 텍스트 내 시작 인덱스를 포함합니다.
  * - 이 구현체는 실무에서도 사용할 수 있도록 메모리 관리 및 동적 배열 확장을 포함하여 견고하게 작성되었습니다.
  *
+ * 구조 (빌드 → 컴파일 → 검색):
+ * - 빌드용 트라이: 노드마다 256개 포인터 배열(2KB+)을 두지 않고, 노드 배열 + (첫 자식, 다음 형제) 연결로 저장합니다.
+ *   패턴은 바이트열로 다루므로 NUL을 포함한 이진 시그니처도 넣을 수 있습니다.
+ * - 바이트 클래스(알파벳 압축): 어떤 패턴에도 나오지 않는 바이트는 모두 클래스 0(항상 루트로 전이),
+ *   패턴에 나오는 바이트는 1부터 차례로 번호를 붙입니다. 전이 테이블의 열 수가 256에서 "패턴에 쓰인 바이트 수 + 1"로 줄어듭니다.
+ * - 이중 배열(double-array) 트라이: 상태 s의 자식은 base[s] + class 위치에 있고 check[]로 부모를 확인합니다.
+ *   상태당 16바이트 정도이므로 10만 개 이상의 시그니처도 포인터 트라이보다 훨씬 작은 메모리에 들어갑니다.
+ *   실패 링크와 출력 링크(dictionary suffix link)도 이 배열 번호로 미리 계산합니다.
+ * - 완전 DFA(dense): 모든 (상태, 클래스)에 대해 goto/실패를 미리 합친 전이를 평탄한 테이블 하나로 만듭니다.
+ *   검색 루프는 바이트마다 테이블 조회 한 번이며, 실패 링크를 따라가는 while 루프가 없습니다.
+ *   항목에는 다음 상태의 행 시작 위치(상태 × 클래스 수)를 저장해 곱셈을 없애고, 출력이 있는 상태는 최상위 비트로 표시합니다.
+ * - 모드 선택: 테이블 크기가 AC_DENSE_MAX_BYTES 이하이면 완전 DFA, 넘으면 이중 배열(실패 링크 사용)로 검색합니다.
+ * - 스트리밍: ACMatcher가 자동자 상태와 지금까지 읽은 바이트 수를 들고 있어, 임의 크기의 청크를 차례로 넣어도
+ *   한 번에 넣은 것과 같은 결과를 콜백으로 받습니다. 큰 파일이나 패킷 캡처를 일정한 메모리로 검색할 수 있습니다.
+ *
  * 사용 예:
  *   // 패턴 목록
  *   const char *patterns[] = {"he", "she", "his", "hers"};
  *   int patternCount = 4;
  *
- *   // 트라이(automaton) 구축
- *   TrieNode *root = createTrieNode();
+ *   // 트라이 구축 후 자동자로 컴파일
+ *   Trie *trie = createTrie();
  *   for (int i = 0; i < patternCount; i++) {
- *       insertPattern(root, patterns[i], i);
+ *       insertPattern(trie, patterns[i], i);
  *   }
- *   buildFailureLinks(root);
+ *   ACAutomaton *ac = compileAutomaton(trie, AC_MODE_AUTO);
+ *   freeTrie(trie);   // 컴파일 후에는 트라이가 필요 없음
  *
  *   // 텍스트 검색
  *   const char *text = "ahishers";
  *   int occCount = 0;
- *   Occurrence *occurrences = ac_search(root, text, &occCount);
+ *   Occurrence *occurrences = ac_search(ac, text, &occCount);
  *   if (occurrences) {
  *       for (int i = 0; i < occCount; i++) {
  *           printf("패턴 ID %d 발견, 시작 인덱스 %d\n", occurrences[i].patternId, occurrences[i].start);
@@ -31,15 +47,31 @@
  *       free(occurrences);
  *   }
  *
- *   // 트라이 메모리 해제
- *   freeTrie(root);
+ *   // 스트리밍 검색: 청크를 이어서 넣으면 경계에 걸친 매칭도 콜백으로 전달됨 (start는 스트림 전체 기준 위치)
+ *   void onMatch(int patternId, uint64_t start, void *userData);
+ *   ACMatcher *matcher = ac_matcher_create(ac, onMatch, NULL);
+ *   while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+ *       ac_matcher_feed(matcher, buffer, n);
+ *   ac_matcher_free(matcher);
+ *
+ *   freeAutomaton(ac);
+ *
+ * 컴파일 예시: gcc -O2 main.c -o aho_corasick
+ * 실행 예시: ./aho_corasick 100000   (시그니처 10만 개 벤치마크)
+ *           ./aho_corasick -f access.log error timeout   (파일을 64KB씩 읽으며 패턴별 매칭 수 출력)
+ * 다른 파일에서 라이브러리로 쓸 때: #define AHO_CORASICK_LIBRARY 후 #include "main.c" (벤치마크와 데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
 
 #define ALPHABET_SIZE 256
+#define AC_DENSE_MAX_BYTES (16u << 20)   // 완전 DFA 테이블 크기 상한 (넘으면 이중 배열로 검색)
+#define AC_MATCH_FLAG 0x80000000u         // 완전 DFA 항목: 다음 상태에 출력이 있음
 
 /* 구조체 정의 */
 
@@ -49,274 +81,724 @@ typedef struct {
     int patternLength;
 } PatternInfo;
 
-// Trie 노드 구조체
-typedef struct TrieNode {
-    struct TrieNode *children[ALPHABET_SIZE]; // 각 문자에 대한 자식 노드
-    struct TrieNode *failure;                 // 실패 링크
-    PatternInfo *output;                      // 이 노드에서 끝나는 패턴들의 정보 (동적 배열)
-    int outputCount;                          // 출력 배열에 저장된 패턴 개수
-    int outputCapacity;                       // 출력 배열의 현재 용량
+// 빌드용 트라이 노드: 자식은 label 오름차순의 형제 연결 리스트
+typedef struct {
+    int firstChild;     // 첫 자식 노드 번호 (-1: 없음)
+    int nextSibling;    // 같은 부모의 다음 형제 노드 번호 (-1: 없음)
+    int outputHead;     // 이 노드에서 끝나는 패턴 목록의 첫 항목 (TrieOutput 번호, -1: 없음)
+    unsigned char label;
 } TrieNode;
 
-// 검색 결과를 저장하는 구조체
+// 노드에서 끝나는 패턴 목록 항목 (같은 패턴이 여러 ID로 들어올 수 있음)
+typedef struct {
+    PatternInfo info;
+    int next;
+} TrieOutput;
+
+// 빌드용 트라이: 노드 0이 루트
+typedef struct {
+    TrieNode *nodes;
+    int nodeCount, nodeCapacity;
+    TrieOutput *outputs;
+    int outputCount, outputCapacity;
+} Trie;
+
+// 검색 모드
+typedef enum {
+    AC_MODE_AUTO,          // 테이블 크기에 따라 자동 선택
+    AC_MODE_DENSE,         // 완전 DFA (바이트당 조회 한 번)
+    AC_MODE_DOUBLE_ARRAY   // 이중 배열 + 실패 링크 (메모리 최소)
+} ACMode;
+
+// 컴파일된 자동자: 상태 번호는 이중 배열의 위치 (0이 루트)
+typedef struct {
+    uint8_t byteClass[ALPHABET_SIZE];   // 바이트 → 클래스 (0: 어떤 패턴에도 없는 바이트)
+    int classCount;
+    int stateCount;                     // 이중 배열 크기 (빈 칸 포함)
+    int32_t *base;                      // 자식 위치 = base[s] + class
+    int32_t *check;                     // check[t] == s이면 t는 s의 자식 (-1: 빈 칸)
+    int32_t *fail;                      // 실패 링크
+    int32_t *match;                     // 자기 자신부터 실패 링크를 따라 처음 만나는 출력 있는 상태 (-1: 없음)
+    int32_t *dictLink;                  // 자기 자신을 제외하고 처음 만나는 출력 있는 상태 (-1: 없음)
+    int32_t *outStart;                  // 이 상태에서 끝나는 패턴들의 outputs 시작 위치
+    int32_t *outCount;
+    PatternInfo *outputs;
+    uint32_t *delta;                    // 완전 DFA: delta[s * classCount + c] = (다음 상태 * classCount) | AC_MATCH_FLAG?
+    ACMode mode;                        // 실제 검색 모드 (AC_MODE_DENSE 또는 AC_MODE_DOUBLE_ARRAY)
+} ACAutomaton;
+
+// 검색 결과를 저장하는 구조체 (다른 검색 엔진과 함께 포함될 때 한 번만 정의)
+#ifndef SEARCH_OCCURRENCE_DEFINED
+#define SEARCH_OCCURRENCE_DEFINED
 typedef struct {
     int patternId; // 매칭된 패턴의 ID
     int start;     // 텍스트에서 패턴이 시작하는 인덱스 (0 기반)
 } Occurrence;
+#endif
 
-/* Trie 노드 관련 함수 */
-
-// 새로운 Trie 노드를 생성하고 초기화합니다.
-TrieNode* createTrieNode() {
-    TrieNode* node = (TrieNode*)malloc(sizeof(TrieNode));
-    if (!node) {
-        fprintf(stderr, "메모리 할당 실패: TrieNode\n");
+static void *acAlloc(size_t bytes, const char *what) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        fprintf(stderr, "메모리 할당 실패: %s\n", what);
         exit(EXIT_FAILURE);
     }
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        node->children[i] = NULL;
-    }
-    node->failure = NULL;
-    node->output = NULL;
-    node->outputCount = 0;
-    node->outputCapacity = 0;
-    return node;
+    return p;
+}
+
+/* 트라이 관련 함수 */
+
+// 빈 트라이(루트 노드 하나)를 생성합니다.
+Trie* createTrie(void) {
+    Trie *trie = (Trie*)acAlloc(sizeof(Trie), "Trie");
+    trie->nodeCapacity = 64;
+    trie->nodes = (TrieNode*)acAlloc(trie->nodeCapacity * sizeof(TrieNode), "TrieNode");
+    trie->nodeCount = 1;
+    trie->nodes[0].firstChild = -1;
+    trie->nodes[0].nextSibling = -1;
+    trie->nodes[0].outputHead = -1;
+    trie->nodes[0].label = 0;
+    trie->outputs = NULL;
+    trie->outputCount = 0;
+    trie->outputCapacity = 0;
+    return trie;
 }
 
-// 출력 배열에 새로운 패턴 정보를 추가합니다.
-void addOutput(TrieNode *node, int patternId, int patternLength) {
-    if (node->outputCount == node->outputCapacity) {
-        int newCapacity = (node->outputCapacity == 0) ? 2 : node->outputCapacity * 2;
-        PatternInfo *newOutput = (PatternInfo *)realloc(node->output, newCapacity * sizeof(PatternInfo));
-        if (!newOutput) {
-            fprintf(stderr, "메모리 재할당 실패: addOutput\n");
+// node의 label 자식을 찾고, 없으면 형제 목록의 정렬 위치에 새로 만듭니다.
+static int childOrCreate(Trie *trie, int node, unsigned char label) {
+    int prev = -1, cur = trie->nodes[node].firstChild;
+    while (cur != -1 && trie->nodes[cur].label < label) {
+        prev = cur;
+        cur = trie->nodes[cur].nextSibling;
+    }
+    if (cur != -1 && trie->nodes[cur].label == label)
+        return cur;
+
+    if (trie->nodeCount == trie->nodeCapacity) {
+        trie->nodeCapacity *= 2;
+        TrieNode *newNodes = (TrieNode*)realloc(trie->nodes, trie->nodeCapacity * sizeof(TrieNode));
+        if (!newNodes) {
+            fprintf(stderr, "메모리 재할당 실패: TrieNode\n");
             exit(EXIT_FAILURE);
         }
-        node->output = newOutput;
-        node->outputCapacity = newCapacity;
+        trie->nodes = newNodes;
     }
-    node->output[node->outputCount].patternId = patternId;
-    node->output[node->outputCount].patternLength = patternLength;
-    node->outputCount++;
+    int id = trie->nodeCount++;
+    trie->nodes[id].firstChild = -1;
+    trie->nodes[id].nextSibling = cur;
+    trie->nodes[id].outputHead = -1;
+    trie->nodes[id].label = label;
+    if (prev == -1)
+        trie->nodes[node].firstChild = id;
+    else
+        trie->nodes[prev].nextSibling = id;
+    return id;
 }
 
-// 패턴을 트라이에 삽입합니다.
-void insertPattern(TrieNode *root, const char *pattern, int patternId) {
-    TrieNode *node = root;
-    for (int i = 0; pattern[i] != '\0'; i++) {
-        unsigned char c = (unsigned char)pattern[i];
-        if (node->children[c] == NULL) {
-            node->children[c] = createTrieNode();
+// 바이트열 패턴을 트라이에 삽입합니다. (NUL 포함 가능, 빈 패턴은 무시)
+void insertPatternBytes(Trie *trie, const unsigned char *pattern, size_t length, int patternId) {
+    if (length == 0)
+        return;
+    int node = 0;
+    for (size_t i = 0; i < length; i++)
+        node = childOrCreate(trie, node, pattern[i]);
+
+    if (trie->outputCount == trie->outputCapacity) {
+        int newCapacity = (trie->outputCapacity == 0) ? 16 : trie->outputCapacity * 2;
+        TrieOutput *newOutputs = (TrieOutput*)realloc(trie->outputs, newCapacity * sizeof(TrieOutput));
+        if (!newOutputs) {
+            fprintf(stderr, "메모리 재할당 실패: insertPattern\n");
+            exit(EXIT_FAILURE);
         }
-        node = node->children[c];
+        trie->outputs = newOutputs;
+        trie->outputCapacity = newCapacity;
     }
-    int len = (int)strlen(pattern);
-    addOutput(node, patternId, len);
+    TrieOutput *out = &trie->outputs[trie->outputCount];
+    out->info.patternId = patternId;
+    out->info.patternLength = (int)length;
+    out->next = trie->nodes[node].outputHead;
+    trie->nodes[node].outputHead = trie->outputCount++;
 }
 
-/* 실패 링크 구축 함수 */
+// 문자열 패턴을 트라이에 삽입합니다.
+void insertPattern(Trie *trie, const char *pattern, int patternId) {
+    insertPatternBytes(trie, (const unsigned char*)pattern, strlen(pattern), patternId);
+}
 
-// A simple queue implementation for BFS.
+// 트라이의 메모리를 해제합니다.
+void freeTrie(Trie *trie) {
+    if (trie == NULL)
+        return;
+    free(trie->nodes);
+    free(trie->outputs);
+    free(trie);
+}
+
+/* 컴파일: 바이트 클래스 → 이중 배열 배치 → 실패/출력 링크 → (선택) 완전 DFA */
+
+// 패턴에 쓰인 바이트만 1부터 번호를 붙입니다. (바이트 순서를 유지하므로 형제 목록도 클래스 오름차순)
+static void buildByteClasses(const Trie *trie, ACAutomaton *ac) {
+    int used[ALPHABET_SIZE] = {0};
+    for (int i = 1; i < trie->nodeCount; i++)
+        used[trie->nodes[i].label] = 1;
+    ac->classCount = 1;
+    for (int b = 0; b < ALPHABET_SIZE; b++)
+        ac->byteClass[b] = used[b] ? (uint8_t)ac->classCount++ : 0;
+}
+
+// 이중 배열 배치 중에만 쓰는 정보: 위치별 트라이 노드와 빈 칸 목록 (오름차순 이중 연결 리스트)
 typedef struct {
-    TrieNode **data;
-    int head;
-    int tail;
+    ACAutomaton *ac;
+    int32_t *nodeOf;     // 위치 → 트라이 노드 번호 (-1: 빈 칸)
+    int32_t *nextFree;   // 빈 칸의 다음 빈 칸 (마지막 빈 칸은 capacity를 가리킴: 늘리면 새 칸으로 이어짐)
+    int32_t *prevFree;   // 빈 칸의 이전 빈 칸 (-1: 첫 빈 칸)
     int capacity;
-} Queue;
+    int freeHead;        // 첫 빈 칸 (capacity이면 빈 칸 없음)
+    int lastFree;        // capacity보다 작은 마지막 빈 칸 (-1: 없음)
+} DoubleArrayBuilder;
 
-// Initialize a new queue.
-Queue* createQueue(int capacity) {
-    Queue *queue = (Queue*)malloc(sizeof(Queue));
-    if (!queue) {
-        fprintf(stderr, "메모리 할당 실패: Queue\n");
+// 배열들을 needed칸 이상으로 늘리고 새 칸을 빈 칸 목록 끝에 이어 붙임
+static void growDoubleArray(DoubleArrayBuilder *da, int needed) {
+    if (needed <= da->capacity)
+        return;
+    int oldCapacity = da->capacity;
+    int newCapacity = oldCapacity > 0 ? oldCapacity : 1024;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+    ACAutomaton *ac = da->ac;
+    int32_t *newBase = (int32_t*)realloc(ac->base, (size_t)newCapacity * sizeof(int32_t));
+    int32_t *newCheck = (int32_t*)realloc(ac->check, (size_t)newCapacity * sizeof(int32_t));
+    int32_t *newNodeOf = (int32_t*)realloc(da->nodeOf, (size_t)newCapacity * sizeof(int32_t));
+    int32_t *newNext = (int32_t*)realloc(da->nextFree, (size_t)newCapacity * sizeof(int32_t));
+    int32_t *newPrev = (int32_t*)realloc(da->prevFree, (size_t)newCapacity * sizeof(int32_t));
+    if (!newBase || !newCheck || !newNodeOf || !newNext || !newPrev) {
+        fprintf(stderr, "메모리 재할당 실패: double array\n");
         exit(EXIT_FAILURE);
     }
-    queue->data = (TrieNode**)malloc(capacity * sizeof(TrieNode*));
-    if (!queue->data) {
-        fprintf(stderr, "메모리 할당 실패: Queue data\n");
-        exit(EXIT_FAILURE);
+    for (int i = oldCapacity; i < newCapacity; i++) {
+        newBase[i] = 0;
+        newCheck[i] = -1;
+        newNodeOf[i] = -1;
+        newNext[i] = i + 1;
+        newPrev[i] = i - 1;
     }
-    queue->head = 0;
-    queue->tail = 0;
-    queue->capacity = capacity;
-    return queue;
+    newPrev[oldCapacity] = da->lastFree;
+    ac->base = newBase;
+    ac->check = newCheck;
+    da->nodeOf = newNodeOf;
+    da->nextFree = newNext;
+    da->prevFree = newPrev;
+    da->capacity = newCapacity;
+    da->lastFree = newCapacity - 1;
 }
 
-// Enqueue an element.
-void enqueue(Queue *queue, TrieNode *node) {
-    if (queue->tail >= queue->capacity) {
-        queue->capacity *= 2;
-        TrieNode **newData = (TrieNode**)realloc(queue->data, queue->capacity * sizeof(TrieNode*));
-        if (!newData) {
-            fprintf(stderr, "메모리 재할당 실패: enqueue\n");
-            exit(EXIT_FAILURE);
-        }
-        queue->data = newData;
-    }
-    queue->data[queue->tail++] = node;
+// 빈 칸 t를 사용 중으로 바꾸고 빈 칸 목록에서 뺌
+static void occupyCell(DoubleArrayBuilder *da, int t, int32_t parent, int32_t node) {
+    int prev = da->prevFree[t], next = da->nextFree[t];
+    if (prev < 0)
+        da->freeHead = next;
+    else
+        da->nextFree[prev] = next;
+    if (next < da->capacity)
+        da->prevFree[next] = prev;
+    else
+        da->lastFree = prev;
+    da->ac->check[t] = parent;
+    da->nodeOf[t] = node;
 }
 
-// Dequeue an element.
-TrieNode* dequeue(Queue *queue) {
-    if (queue->head < queue->tail) {
-        return queue->data[queue->head++];
+/*
+ * 트라이를 BFS 순서로 이중 배열에 배치합니다. order에 BFS 순서의 상태 번호를, *nodeOf에 위치별 트라이 노드를
+ * 기록하고 상태 개수를 반환합니다.
+ * 자식 클래스 c1 < c2 < ...가 모두 빈 칸에 들어가는 base를 찾을 때 빈 칸 목록만 훑으므로,
+ * 배열이 거의 다 찬 뒤에도 (대부분인) 자식 하나짜리 노드는 첫 빈 칸에 바로 들어갑니다.
+ */
+static int placeDoubleArray(const Trie *trie, ACAutomaton *ac, int32_t *order, int32_t **nodeOf) {
+    DoubleArrayBuilder da = {ac, NULL, NULL, NULL, 0, 0, -1};
+    ac->base = NULL;
+    ac->check = NULL;
+    growDoubleArray(&da, 1024);
+    occupyCell(&da, 0, 0, 0);   // 루트
+    int labels[ALPHABET_SIZE], children[ALPHABET_SIZE];
+
+    int head = 0, tail = 0;
+    order[tail++] = 0;
+    while (head < tail) {
+        int s = order[head++];
+        int node = da.nodeOf[s];
+        int k = 0;
+        for (int v = trie->nodes[node].firstChild; v != -1; v = trie->nodes[v].nextSibling) {
+            labels[k] = ac->byteClass[trie->nodes[v].label];
+            children[k++] = v;
+        }
+        if (k == 0)
+            continue;
+
+        // 첫 자식을 빈 칸 e에 놓는다고 가정하고 나머지 자식 자리도 비어 있는지 확인
+        int b;
+        for (int e = da.freeHead;; e = da.nextFree[e]) {
+            growDoubleArray(&da, e + ac->classCount + 1);
+            b = e - labels[0];
+            if (b < 1)
+                continue;
+            int ok = 1;
+            for (int j = 1; j < k && ok; j++)
+                ok = ac->check[b + labels[j]] == -1;
+            if (ok)
+                break;
+        }
+        ac->base[s] = b;
+        for (int j = 0; j < k; j++) {
+            occupyCell(&da, b + labels[j], s, children[j]);
+            order[tail++] = b + labels[j];
+        }
     }
-    return NULL;
+    // 검색 중 base[s] + c가 항상 배열 안에 있도록 여유 칸 확보
+    int size = 0;
+    for (int i = 0; i < da.capacity; i++)
+        if (ac->check[i] != -1)
+            size = i + 1;
+    for (int i = 0; i < tail; i++)
+        if (ac->base[order[i]] + ac->classCount > size)
+            size = ac->base[order[i]] + ac->classCount;
+    growDoubleArray(&da, size);
+    ac->stateCount = size;
+    free(da.nextFree);
+    free(da.prevFree);
+    *nodeOf = da.nodeOf;
+    return tail;
 }
 
-// Check if the queue is empty.
-int isQueueEmpty(Queue *queue) {
-    return queue->head >= queue->tail;
+// 상태 s에서 클래스 c로 가는 goto 전이 (없으면 -1)
+static inline int32_t gotoState(const ACAutomaton *ac, int32_t s, int c) {
+    int32_t t = ac->base[s] + c;
+    return (c != 0 && ac->check[t] == s) ? t : -1;
 }
 
-// Free the queue.
-void freeQueue(Queue *queue) {
-    free(queue->data);
-    free(queue);
+// 실패 링크와 출력 링크를 BFS 순서로 계산합니다. (부모의 실패 링크가 먼저 계산되어 있음)
+static void buildFailureLinks(ACAutomaton *ac, const int32_t *order, int orderCount) {
+    ac->fail[0] = 0;
+    ac->dictLink[0] = -1;
+    ac->match[0] = ac->outCount[0] > 0 ? 0 : -1;
+    for (int i = 0; i < orderCount; i++) {
+        int32_t s = order[i];
+        for (int c = 1; c < ac->classCount; c++) {
+            int32_t t = gotoState(ac, s, c);
+            if (t < 0)
+                continue;
+            int32_t f = 0;
+            if (s != 0) {
+                // 실패 링크를 따라 이동하며, 해당 문자를 가진 상태를 찾음
+                int32_t g = ac->fail[s];
+                for (;;) {
+                    int32_t next = gotoState(ac, g, c);
+                    if (next >= 0) {
+                        f = next;
+                        break;
+                    }
+                    if (g == 0)
+                        break;
+                    g = ac->fail[g];
+                }
+            }
+            ac->fail[t] = f;
+            ac->dictLink[t] = ac->outCount[f] > 0 ? f : ac->dictLink[f];
+            ac->match[t] = ac->outCount[t] > 0 ? t : ac->dictLink[t];
+        }
+    }
 }
 
-// Build failure links for the Aho-Corasick automaton.
-void buildFailureLinks(TrieNode *root) {
-    root->failure = root;
-    Queue *queue = createQueue(100);
-    
-    // 초기: 루트의 자식들의 실패 링크는 루트로 설정
-    for (int c = 0; c < ALPHABET_SIZE; c++) {
-        if (root->children[c]) {
-            root->children[c]->failure = root;
-            enqueue(queue, root->children[c]);
-        }
+// 완전 DFA: BFS 순서로 행을 채우므로 실패 상태의 행은 항상 먼저 완성되어 있음
+static void buildDenseTable(ACAutomaton *ac, const int32_t *order, int orderCount) {
+    size_t classes = (size_t)ac->classCount;
+    ac->delta = (uint32_t*)calloc((size_t)ac->stateCount * classes, sizeof(uint32_t));
+    if (!ac->delta) {
+        fprintf(stderr, "메모리 할당 실패: delta\n");
+        exit(EXIT_FAILURE);
     }
-    
-    // BFS로 트라이 순회
-    while (!isQueueEmpty(queue)) {
-        TrieNode *current = dequeue(queue);
-        for (int c = 0; c < ALPHABET_SIZE; c++) {
-            TrieNode *child = current->children[c];
-            if (child) {
-                TrieNode *fail = current->failure;
-                // 실패 링크를 따라 이동하며, 해당 문자를 가진 노드를 찾음
-                while (fail != root && fail->children[c] == NULL) {
-                    fail = fail->failure;
-                }
-                if (fail->children[c]) {
-                    child->failure = fail->children[c];
-                } else {
-                    child->failure = root;
-                }
-                // 실패 링크를 통해 출력 목록 병합
-                for (int i = 0; i < child->failure->outputCount; i++) {
-                    PatternInfo info = child->failure->output[i];
-                    addOutput(child, info.patternId, info.patternLength);
-                }
-                enqueue(queue, child);
-            }
+    for (int i = 0; i < orderCount; i++) {
+        int32_t s = order[i];
+        uint32_t *row = ac->delta + (size_t)s * classes;
+        const uint32_t *failRow = ac->delta + (size_t)ac->fail[s] * classes;
+        row[0] = 0;   // 어떤 패턴에도 없는 바이트: 루트 (루트에는 출력이 없음)
+        for (size_t c = 1; c < classes; c++) {
+            int32_t t = gotoState(ac, s, (int)c);
+            if (t >= 0)
+                row[c] = (uint32_t)((size_t)t * classes) | (ac->match[t] >= 0 ? AC_MATCH_FLAG : 0);
+            else
+                row[c] = s == 0 ? 0 : failRow[c];
         }
     }
-    freeQueue(queue);
 }
 
-/* Aho-Corasick 검색 함수 */
+// 트라이를 검색용 자동자로 컴파일합니다. (트라이는 수정하지 않으므로 컴파일 후 해제해도 됨)
+ACAutomaton* compileAutomaton(const Trie *trie, ACMode mode) {
+    ACAutomaton *ac = (ACAutomaton*)acAlloc(sizeof(ACAutomaton), "ACAutomaton");
+    memset(ac, 0, sizeof(ACAutomaton));
+    buildByteClasses(trie, ac);
 
-// 검색 결과를 저장하는 Occurrence 구조체는 위에 정의됨:
-// typedef struct {
-//     int patternId;
-//     int start;
-// } Occurrence;
+    int32_t *order = (int32_t*)acAlloc((size_t)trie->nodeCount * sizeof(int32_t), "order");
+    int32_t *nodeOf;
+    int orderCount = placeDoubleArray(trie, ac, order, &nodeOf);
 
-// Aho-Corasick 알고리즘을 사용하여 텍스트에서 패턴 매칭 결과를 찾습니다.
-// patternId와 패턴 길이는 트라이 생성 시 삽입한 값에 기반합니다.
-Occurrence* ac_search(TrieNode *root, const char *text, int *occurrenceCount) {
-    int textLen = (int)strlen(text);
-    int capacity = 10;
-    int count = 0;
-    Occurrence *occurrences = (Occurrence*)malloc(capacity * sizeof(Occurrence));
-    if (!occurrences) {
-        fprintf(stderr, "메모리 할당 실패: occurrences\n");
+    // 상태별 출력 목록을 평탄한 배열로
+    size_t states = (size_t)ac->stateCount;
+    ac->fail = (int32_t*)acAlloc(states * sizeof(int32_t), "fail");
+    ac->match = (int32_t*)acAlloc(states * sizeof(int32_t), "match");
+    ac->dictLink = (int32_t*)acAlloc(states * sizeof(int32_t), "dictLink");
+    ac->outStart = (int32_t*)acAlloc(states * sizeof(int32_t), "outStart");
+    ac->outCount = (int32_t*)calloc(states, sizeof(int32_t));
+    ac->outputs = (PatternInfo*)acAlloc((size_t)trie->outputCount * sizeof(PatternInfo), "outputs");
+    if (!ac->outCount) {
+        fprintf(stderr, "메모리 할당 실패: outCount\n");
         exit(EXIT_FAILURE);
     }
-    
-    TrieNode *node = root;
-    for (int i = 0; i < textLen; i++) {
-        unsigned char c = (unsigned char)text[i];
-        // 상태 전이: 해당 문자가 없는 경우 실패 링크를 따라 이동
-        while (node != root && node->children[c] == NULL) {
-            node = node->failure;
+    int outIndex = 0;
+    for (int i = 0; i < orderCount; i++) {
+        int32_t s = order[i];
+        ac->outStart[s] = outIndex;
+        for (int o = trie->nodes[nodeOf[s]].outputHead; o != -1; o = trie->outputs[o].next)
+            ac->outputs[outIndex++] = trie->outputs[o].info;
+        ac->outCount[s] = outIndex - ac->outStart[s];
+    }
+    buildFailureLinks(ac, order, orderCount);
+
+    size_t denseBytes = states * (size_t)ac->classCount * sizeof(uint32_t);
+    if (mode == AC_MODE_AUTO)
+        mode = denseBytes <= AC_DENSE_MAX_BYTES ? AC_MODE_DENSE : AC_MODE_DOUBLE_ARRAY;
+    if (mode == AC_MODE_DENSE && states * (size_t)ac->classCount >= AC_MATCH_FLAG)
+        mode = AC_MODE_DOUBLE_ARRAY;   // 행 위치가 플래그 비트와 겹침
+    ac->mode = mode;
+    if (mode == AC_MODE_DENSE)
+        buildDenseTable(ac, order, orderCount);
+
+    free(order);
+    free(nodeOf);
+    return ac;
+}
+
+// 자동자의 메모리를 해제합니다.
+void freeAutomaton(ACAutomaton *ac) {
+    if (ac == NULL)
+        return;
+    free(ac->base);
+    free(ac->check);
+    free(ac->fail);
+    free(ac->match);
+    free(ac->dictLink);
+    free(ac->outStart);
+    free(ac->outCount);
+    free(ac->outputs);
+    free(ac->delta);
+    free(ac);
+}
+
+/* 스트리밍 검색: 청크 단위로 입력하고 매칭은 콜백으로 받음 */
+
+// 매칭 콜백: start는 스트림 처음부터 센 절대 위치 (바이트 단위, 여러 GB도 표현 가능)
+typedef void (*ACMatchCallback)(int patternId, uint64_t start, void *userData);
+
+// 스트림 하나의 검색 상태 (자동자는 읽기만 하므로 여러 스트림이 하나의 자동자를 공유할 수 있음)
+typedef struct {
+    const ACAutomaton *ac;
+    uint32_t state;          // 완전 DFA: 현재 상태의 행 시작 위치, 이중 배열: 현재 상태 번호
+    uint64_t offset;         // 지금까지 입력된 바이트 수 (다음 청크 첫 바이트의 절대 위치)
+    ACMatchCallback callback;
+    void *userData;
+} ACMatcher;
+
+static void initMatcher(ACMatcher *matcher, const ACAutomaton *ac, ACMatchCallback callback, void *userData) {
+    matcher->ac = ac;
+    matcher->state = 0;
+    matcher->offset = 0;
+    matcher->callback = callback;
+    matcher->userData = userData;
+}
+
+// 스트림 검색 상태를 생성합니다. 같은 자동자로 여러 스트림을 동시에 검색할 수 있습니다.
+ACMatcher* ac_matcher_create(const ACAutomaton *ac, ACMatchCallback callback, void *userData) {
+    ACMatcher *matcher = (ACMatcher*)acAlloc(sizeof(ACMatcher), "ACMatcher");
+    initMatcher(matcher, ac, callback, userData);
+    return matcher;
+}
+
+// 새 스트림을 처음부터 검색하도록 상태와 위치를 초기화합니다.
+void ac_matcher_reset(ACMatcher *matcher) {
+    matcher->state = 0;
+    matcher->offset = 0;
+}
+
+void ac_matcher_free(ACMatcher *matcher) {
+    free(matcher);
+}
+
+// 상태 s에서 끝나는 모든 패턴(출력 링크를 따라)을 콜백으로 알립니다. end: 마지막 바이트의 절대 위치
+static void reportMatches(const ACMatcher *matcher, int32_t s, uint64_t end) {
+    const ACAutomaton *ac = matcher->ac;
+    for (int32_t m = ac->match[s]; m >= 0; m = ac->dictLink[m]) {
+        const PatternInfo *out = ac->outputs + ac->outStart[m];
+        for (int j = 0; j < ac->outCount[m]; j++)
+            matcher->callback(out[j].patternId, end + 1 - (uint64_t)out[j].patternLength, matcher->userData);
+    }
+}
+
+/*
+ * 청크 chunk[0..length)를 이어서 검색합니다. (NUL 포함 임의의 바이트열, 길이 0도 허용)
+ * 자동자 상태가 청크 사이에 유지되므로 청크 경계에 걸친 패턴도 찾으며, 청크를 어떻게 나누든 결과가 같습니다.
+ * 청크 내용은 호출이 끝나면 더 이상 참조하지 않으므로 같은 버퍼를 다시 채워 넣어도 됩니다.
+ */
+void ac_matcher_feed(ACMatcher *matcher, const void *chunk, size_t length) {
+    const ACAutomaton *ac = matcher->ac;
+    const unsigned char *text = (const unsigned char*)chunk;
+    const uint8_t *byteClass = ac->byteClass;
+    uint64_t offset = matcher->offset;
+
+    if (ac->mode == AC_MODE_DENSE) {
+        // 바이트마다 테이블 조회 한 번 (state는 현재 상태의 행 시작 위치)
+        const uint32_t *delta = ac->delta;
+        uint32_t state = matcher->state;
+        for (size_t i = 0; i < length; i++) {
+            state = delta[state + byteClass[text[i]]];
+            if (state & AC_MATCH_FLAG) {
+                state &= ~AC_MATCH_FLAG;
+                reportMatches(matcher, (int32_t)(state / (uint32_t)ac->classCount), offset + i);
+            }
         }
-        if (node->children[c])
-            node = node->children[c];
-        // 출력 목록이 있다면, 매칭된 모든 패턴에 대해 결과 기록
-        if (node->outputCount > 0) {
-            for (int j = 0; j < node->outputCount; j++) {
-                int patLen = node->output[j].patternLength;
-                int startIndex = i - patLen + 1;
-                if (startIndex >= 0) {
-                    if (count == capacity) {
-                        capacity *= 2;
-                        Occurrence *temp = (Occurrence*)realloc(occurrences, capacity * sizeof(Occurrence));
-                        if (!temp) {
-                            fprintf(stderr, "메모리 재할당 실패: occurrences\n");
-                            free(occurrences);
-                            exit(EXIT_FAILURE);
-                        }
-                        occurrences = temp;
-                    }
-                    occurrences[count].patternId = node->output[j].patternId;
-                    occurrences[count].start = startIndex;
-                    count++;
+        matcher->state = state;
+    } else {
+        // 이중 배열: goto가 없으면 실패 링크를 따라감 (바이트당 평균 O(1))
+        int32_t s = (int32_t)matcher->state;
+        for (size_t i = 0; i < length; i++) {
+            int c = byteClass[text[i]];
+            if (c == 0) {
+                s = 0;
+                continue;
+            }
+            for (;;) {
+                int32_t t = ac->base[s] + c;
+                if (ac->check[t] == s) {
+                    s = t;
+                    break;
                 }
+                if (s == 0)
+                    break;
+                s = ac->fail[s];
             }
+            if (ac->match[s] >= 0)
+                reportMatches(matcher, s, offset + i);
         }
+        matcher->state = (uint32_t)s;
     }
-    *occurrenceCount = count;
-    return occurrences;
+    matcher->offset = offset + length;
 }
 
-/* 메모리 해제 함수 */
+/* Aho-Corasick 검색 함수 (텍스트 전체를 한 번에) */
 
-// 트라이의 메모리를 재귀적으로 해제합니다.
-void freeTrie(TrieNode *node) {
-    if (node == NULL)
-        return;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        // 자식 노드가 존재하면 재귀적으로 해제
-        if (node->children[i]) {
-            freeTrie(node->children[i]);
+typedef struct {
+    Occurrence *occurrences;
+    int count, capacity;
+} OccurrenceList;
+
+// 결과 배열에 하나 추가 (용량이 차면 2배로)
+static void appendOccurrence(int patternId, uint64_t start, void *userData) {
+    OccurrenceList *list = (OccurrenceList*)userData;
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        Occurrence *temp = (Occurrence*)realloc(list->occurrences, list->capacity * sizeof(Occurrence));
+        if (!temp) {
+            fprintf(stderr, "메모리 재할당 실패: occurrences\n");
+            free(list->occurrences);
+            exit(EXIT_FAILURE);
+        }
+        list->occurrences = temp;
+    }
+    list->occurrences[list->count].patternId = patternId;
+    list->occurrences[list->count].start = (int)start;   // ac_search_bytes가 textLen <= INT_MAX를 보장
+    list->count++;
+}
+
+// 바이트열 text[0..textLen)에서 모든 패턴의 매칭 결과를 찾습니다. (NUL 포함 가능)
+// Occurrence.start가 int이므로 textLen은 INT_MAX 이하여야 합니다. 더 긴 입력은 ac_matcher_feed(64비트 위치)를
+// 사용하세요. 초과하면 오류를 출력하고 NULL(*occurrenceCount = -1)을 반환합니다.
+Occurrence* ac_search_bytes(const ACAutomaton *ac, const unsigned char *text, size_t textLen, int *occurrenceCount) {
+    if (textLen > (size_t)INT_MAX) {
+        fprintf(stderr, "ac_search_bytes: 텍스트가 너무 깁니다 (%zu바이트, 최대 %d바이트)\n", textLen, INT_MAX);
+        *occurrenceCount = -1;
+        return NULL;
+    }
+    OccurrenceList list;
+    list.capacity = 10;
+    list.count = 0;
+    list.occurrences = (Occurrence*)acAlloc(list.capacity * sizeof(Occurrence), "occurrences");
+
+    ACMatcher matcher;
+    initMatcher(&matcher, ac, appendOccurrence, &list);
+    ac_matcher_feed(&matcher, text, textLen);
+    *occurrenceCount = list.count;
+    return list.occurrences;
+}
+
+// Aho-Corasick 알고리즘을 사용하여 텍스트(NUL 종료 문자열)에서 패턴 매칭 결과를 찾습니다.
+// patternId와 패턴 길이는 트라이 생성 시 삽입한 값에 기반합니다.
+Occurrence* ac_search(const ACAutomaton *ac, const char *text, int *occurrenceCount) {
+    return ac_search_bytes(ac, (const unsigned char*)text, strlen(text), occurrenceCount);
+}
+
+#ifndef AHO_CORASICK_LIBRARY
+/* 벤치마크 */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 시그니처 patternCount개(길이 8~16, 소문자)로 16MB 무작위 텍스트를 두 모드로 검색
+static void benchmark(int patternCount) {
+    const size_t textLen = 16u << 20;
+    uint64_t state = 88172645463325252ULL;
+    unsigned char *text = (unsigned char*)acAlloc(textLen, "text");
+    for (size_t i = 0; i < textLen; i++)
+        text[i] = (unsigned char)('a' + nextRandom(&state) % 26);
+
+    double start = nowSeconds();
+    Trie *trie = createTrie();
+    unsigned char pattern[16];
+    for (int p = 0; p < patternCount; p++) {
+        size_t len = 8 + nextRandom(&state) % 9;
+        if (p % 10 == 0 && len <= textLen) {
+            // 일부는 텍스트에서 잘라 와서 실제로 매칭되게 함
+            memcpy(pattern, text + nextRandom(&state) % (textLen - len), len);
+        } else {
+            for (size_t j = 0; j < len; j++)
+                pattern[j] = (unsigned char)('a' + nextRandom(&state) % 26);
         }
+        insertPatternBytes(trie, pattern, len, p);
+    }
+    double buildTime = nowSeconds() - start;
+    printf("\n시그니처 %d개 (트라이 노드 %d개), 텍스트 %zuMB:\n", patternCount, trie->nodeCount, textLen >> 20);
+
+    const ACMode modes[] = {AC_MODE_DENSE, AC_MODE_DOUBLE_ARRAY};
+    const char *names[] = {"완전 DFA", "이중 배열"};
+    for (int m = 0; m < 2; m++) {
+        start = nowSeconds();
+        ACAutomaton *ac = compileAutomaton(trie, modes[m]);
+        double compileTime = nowSeconds() - start;
+        size_t bytes = (size_t)ac->stateCount * 7 * sizeof(int32_t);
+        if (ac->delta)
+            bytes += (size_t)ac->stateCount * ac->classCount * sizeof(uint32_t);
+        int count = 0;
+        start = nowSeconds();
+        Occurrence *occ = ac_search_bytes(ac, text, textLen, &count);
+        double searchTime = nowSeconds() - start;
+        printf("  %s: 컴파일 %.3f초, 검색 %.3f초 (%.0f MB/s), 매칭 %d개, 메모리 약 %.1fMB\n",
+               names[m], buildTime + compileTime, searchTime, (double)textLen / (1 << 20) / searchTime,
+               count, (double)bytes / (1 << 20));
+        free(occ);
+        freeAutomaton(ac);
+    }
+    freeTrie(trie);
+    free(text);
+}
+
+// 스트리밍 데모용 콜백: 매칭 위치를 출력
+static void printMatch(int patternId, uint64_t start, void *userData) {
+    const char **names = (const char**)userData;
+    printf("  패턴 \"%s\" (ID %d), 시작 위치 %llu\n", names[patternId], patternId, (unsigned long long)start);
+}
+
+// 파일 스트리밍용 콜백: 패턴별 매칭 수를 셈
+static void countMatch(int patternId, uint64_t start, void *userData) {
+    (void)start;
+    ((uint64_t*)userData)[patternId]++;
+}
+
+// 파일을 고정 크기 버퍼로 읽으며 검색 (파일 크기와 무관하게 메모리 사용량 일정)
+static int streamFile(const char *path, char **patterns, int patternCount) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return EXIT_FAILURE;
     }
-    if (node->output)
-        free(node->output);
-    free(node);
+    Trie *trie = createTrie();
+    for (int i = 0; i < patternCount; i++)
+        insertPattern(trie, patterns[i], i);
+    ACAutomaton *ac = compileAutomaton(trie, AC_MODE_AUTO);
+    freeTrie(trie);
+
+    uint64_t *counts = (uint64_t*)calloc((size_t)patternCount, sizeof(uint64_t));
+    unsigned char *buffer = (unsigned char*)acAlloc(1 << 16, "buffer");
+    if (!counts) {
+        fprintf(stderr, "메모리 할당 실패: counts\n");
+        exit(EXIT_FAILURE);
+    }
+    ACMatcher *matcher = ac_matcher_create(ac, countMatch, counts);
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, 1 << 16, fp)) > 0)
+        ac_matcher_feed(matcher, buffer, bytesRead);
+    int status = ferror(fp) ? EXIT_FAILURE : EXIT_SUCCESS;
+    fclose(fp);
+
+    printf("%s (%llu바이트):\n", path, (unsigned long long)matcher->offset);
+    for (int i = 0; i < patternCount; i++)
+        printf("  \"%s\": %llu회\n", patterns[i], (unsigned long long)counts[i]);
+    ac_matcher_free(matcher);
+    free(buffer);
+    free(counts);
+    freeAutomaton(ac);
+    return status;
 }
 
 /* main 함수: Aho-Corasick 알고리즘 데모 */
-int main(void) {
+int main(int argc, char *argv[]) {
+    if (argc > 3 && strcmp(argv[1], "-f") == 0)
+        return streamFile(argv[2], argv + 3, argc - 3);
+
     // 패턴 목록 (실제 응용에서는 동적 입력을 사용할 수 있음)
     const char *patterns[] = {"he", "she", "his", "hers"};
     int patternCount = sizeof(patterns) / sizeof(patterns[0]);
-    
-    // 트라이(automaton) 구축
-    TrieNode *root = createTrieNode();
+
+    // 트라이 구축 후 자동자로 컴파일
+    Trie *trie = createTrie();
     for (int i = 0; i < patternCount; i++) {
-        insertPattern(root, patterns[i], i);
+        insertPattern(trie, patterns[i], i);
     }
-    buildFailureLinks(root);
-    
+    ACAutomaton *ac = compileAutomaton(trie, AC_MODE_AUTO);
+    freeTrie(trie);
+
     // 검색할 텍스트
     const char *text = "ahishers";
     int occCount = 0;
-    Occurrence *occurrences = ac_search(root, text, &occCount);
-    
-    if (occurrences) {
+    Occurrence *occurrences = ac_search(ac, text, &occCount);
+
+    if (occCount > 0) {
         printf("텍스트 \"%s\"에서 패턴 매칭 결과:\n", text);
         for (int i = 0; i < occCount; i++) {
             printf("패턴 ID %d 발견, 시작 인덱스 %d\n", occurrences[i].patternId, occurrences[i].start);
         }
-        free(occurrences);
     } else {
         printf("매칭된 패턴이 없습니다.\n");
     }
-    
-    freeTrie(root);
+    free(occurrences);
+
+    // 같은 텍스트를 청크 "ahi" | "sh" | "" | "ers"로 나누어 스트리밍 (경계에 걸친 "she", "hers"도 찾음)
+    printf("\n청크 단위 스트리밍 결과:\n");
+    ACMatcher *matcher = ac_matcher_create(ac, printMatch, patterns);
+    const char *chunks[] = {"ahi", "sh", "", "ers"};
+    for (int i = 0; i < 4; i++)
+        ac_matcher_feed(matcher, chunks[i], strlen(chunks[i]));
+    ac_matcher_free(matcher);
+    freeAutomaton(ac);
+
+    // 작은 사전(테이블이 캐시에 들어감)과 큰 사전(이중 배열이 유리)
+    benchmark(1000);
+    benchmark(argc > 1 ? atoi(argv[1]) : 100000);
     return 0;
-}
\ No newline at end of file
+}
+#endif /* AHO_CORASICK_LIBRARY */
@@ -16,12 +16,19 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 드문 바이트 전처리(../rare_byte.c): 각 정렬 위치에서 비교하기 전에, 패턴의 드문 바이트 두 개가 제자리에 있는
+ * 다음 위치까지 SIMD로 건너뜁니다. 건너뛴 위치에는 매칭이 없으므로 이동 규칙은 그대로 유효합니다.
+ * 다른 파일에서 라이브러리로 쓸 때: #define BOYER_MOORE_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define RARE_BYTE_LIBRARY
+#include "../rare_byte.c"
+
 #define ALPHABET_SIZE 256
 
 /**
@@ -155,9 +162,18 @@ int *boyer_moore_search(const char *text, const char *pattern, int *matchCount)
         return NULL;
     }
     
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
+
     int count = 0;
     int s = 0; // 텍스트 내에서 패턴의 시작 위치 (shift)
     while (s <= n - m) {
+        if (rb.useful) {
+            // 드문 바이트 두 개가 제자리에 있는 다음 후보 위치로 이동 (그 사이에는 매칭이 없음)
+            s = rare_byte_find(&rb, text, s, n - m);
+            if (s < 0)
+                break;
+        }
         int j = m - 1;
         // 패턴의 뒤쪽부터 비교하여 일치 여부 확인
         while (j >= 0 && pattern[j] == text[s + j])
@@ -196,6 +212,7 @@ int *boyer_moore_search(const char *text, const char *pattern, int *matchCount)
     return result;
 }
 
+#ifndef BOYER_MOORE_LIBRARY
 // main 함수: 보이어-무어 알고리즘 데모
 int main(void) {
     const char *text = "HERE IS A SIMPLE EXAMPLE";
@@ -214,4 +231,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* BOYER_MOORE_LIBRARY */
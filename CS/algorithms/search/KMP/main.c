@@ -17,12 +17,19 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 드문 바이트 전처리(../rare_byte.c): 부분 일치가 없을 때(j == 0)는 패턴의 드문 바이트 두 개가 제자리에 있는
+ * 다음 위치까지 SIMD로 건너뛴 뒤 KMP 비교를 이어갑니다.
+ * 다른 파일에서 라이브러리로 쓸 때: #define KMP_SEARCH_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define RARE_BYTE_LIBRARY
+#include "../rare_byte.c"
+
 /**
  * computeLPS
  *
@@ -101,12 +108,21 @@ int *kmp_search(const char *text, const char *pattern, int *matchCount) {
         return NULL;
     }
 
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
+
     int count = 0;  // 매치 횟수
     int i = 0;      // text 인덱스
     int j = 0;      // pattern 인덱스
 
     // 텍스트를 순회하며 패턴 검색
     while (i < n) {
+        if (j == 0 && rb.useful) {
+            // 부분 일치가 없으면 매칭이 시작될 수 있는 다음 후보 위치로 바로 이동
+            i = rare_byte_find(&rb, text, i, n - m);
+            if (i < 0)
+                break;
+        }
         if (pattern[j] == text[i]) {
             i++;
             j++;
@@ -142,6 +158,7 @@ int *kmp_search(const char *text, const char *pattern, int *matchCount) {
     return result;
 }
 
+#ifndef KMP_SEARCH_LIBRARY
 // main 함수: 고도화된 KMP 알고리즘 데모
 int main(void) {
     const char *text = "ABABDABACDABABCABAB";
@@ -160,4 +177,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* KMP_SEARCH_LIBRARY */
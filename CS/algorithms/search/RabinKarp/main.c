@@ -16,6 +16,8 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define RABIN_KARP_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
@@ -53,6 +55,11 @@ int *rabinKarpSearch(const char *text, const char *pattern, int *matchCount) {
         *matchCount = 0;
         return NULL;
     }
+    // 패턴이 텍스트보다 길면 매칭이 없음 (첫 해시 계산이 텍스트 끝을 넘어 읽지 않도록)
+    if (m > n) {
+        *matchCount = 0;
+        return NULL;
+    }
     
     // 초기 해시 값 계산을 위한 변수 설정
     long long patternHash = 0;
@@ -118,6 +125,7 @@ int *rabinKarpSearch(const char *text, const char *pattern, int *matchCount) {
     return results;
 }
 
+#ifndef RABIN_KARP_LIBRARY
 // main 함수: 라빈-카프 알고리즘 데모
 int main(void) {
     const char *text = "GEEKS FOR GEEKS";
@@ -136,4 +144,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* RABIN_KARP_LIBRARY */
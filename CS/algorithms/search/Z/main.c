@@ -3,8 +3,10 @@
  *
  * 고도화된 Z 알고리즘 기반 문자열 검색 구현 예제
  * - 주어진 텍스트(text) 내에서 패턴(pattern)이 등장하는 모든 시작 인덱스를 동적 배열로 반환합니다.
- * - Z 알고리즘을 사용하여 "패턴 + '$' + 텍스트" 문자열의 Z 배열을 계산하고,
- *   패턴과 완벽하게 일치하는 부분을 찾아 그 시작 인덱스를 기록합니다.
+ * - 패턴의 Z 배열만 계산한 뒤, 텍스트의 각 위치에서 패턴 접두사와 일치하는 길이를 Z-box로 재사용하며 구합니다.
+ *   ("패턴 + '$' + 텍스트"를 새로 만들지 않으므로 텍스트 크기의 추가 메모리가 없고, 텍스트에 '$'가 있어도 안전합니다.)
+ * - 드문 바이트 전처리(../rare_byte.c): 현재 Z-box 밖에서는 패턴의 드문 바이트 두 개가 제자리에 있는
+ *   다음 위치까지 SIMD로 건너뛰고, 후보 위치에서만 비교를 확장합니다.
  * - 결과 배열은 동적으로 할당되며, 호출자가 사용 후 free()로 메모리 해제해야 합니다.
  *
  * 사용 예:
@@ -16,12 +18,17 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define Z_SEARCH_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define RARE_BYTE_LIBRARY
+#include "../rare_byte.c"
+
 /**
  * computeZArray
  *
@@ -92,25 +99,14 @@ int *z_search(const char *text, const char *pattern, int *matchCount) {
         return NULL;
     }
     
-    // 새 문자열 생성: "패턴 + '$' + 텍스트"
-    int concatLen = patternLen + 1 + textLen;
-    char *concatStr = (char *)malloc((concatLen + 1) * sizeof(char));
-    if (concatStr == NULL) {
-        fprintf(stderr, "메모리 할당 실패 (concatStr)\n");
-        *matchCount = -1;
-        return NULL;
-    }
-    strcpy(concatStr, pattern);
-    concatStr[patternLen] = '$';
-    strcpy(concatStr + patternLen + 1, text);
-    concatStr[concatLen] = '\0';
-    
-    // Z 배열 계산
-    int *Z = computeZArray(concatStr, concatLen);
-    if (Z == NULL) {
-        free(concatStr);
-        *matchCount = -1;
-        return NULL;
+    // 패턴의 Z 배열 계산 (Z[k]: pattern[k..]와 pattern의 최장 공통 접두사 길이)
+    int *Z = NULL;
+    if (patternLen > 1) {
+        Z = computeZArray(pattern, patternLen);
+        if (Z == NULL) {
+            *matchCount = -1;
+            return NULL;
+        }
     }
     
     // 결과 저장용 동적 배열 (초기 용량 10)
@@ -119,16 +115,39 @@ int *z_search(const char *text, const char *pattern, int *matchCount) {
     if (result == NULL) {
         fprintf(stderr, "메모리 할당 실패 (result 배열)\n");
         free(Z);
-        free(concatStr);
         *matchCount = -1;
         return NULL;
     }
     
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, patternLen);
+    
     int count = 0;
-    // 인덱스 patternLen + 1 부터 확인 (패턴과 '$'를 건너뛰고 텍스트 시작)
-    for (int i = patternLen + 1; i < concatLen; i++) {
-        if (Z[i] == patternLen) {
-            int pos = i - patternLen - 1; // 텍스트 내의 시작 인덱스
+    int L = 0, R = 0;  // Z-box: text[L..R)가 pattern[0..R-L)과 일치 (지금까지 가장 오른쪽까지 확장한 구간)
+    for (int i = 0; i <= textLen - patternLen; i++) {
+        int len;
+        if (i >= R) {
+            // Z-box 밖: 재사용할 정보가 없으므로 다음 후보 위치로 건너뛰고 처음부터 비교
+            if (rb.useful) {
+                i = rare_byte_find(&rb, text, i, textLen - patternLen);
+                if (i < 0)
+                    break;
+            }
+            len = 0;
+        } else {
+            // Z-box 안: text[i..R)는 pattern[i-L..R-L)과 같으므로 패턴의 Z 값으로 일치 길이를 알 수 있음
+            int k = i - L;
+            if (Z[k] < R - i)
+                continue;   // 일치 길이가 Z[k] < 패턴 길이로 확정
+            len = R - i;
+        }
+        while (len < patternLen && text[i + len] == pattern[len])
+            len++;
+        if (i + len > R) {
+            L = i;
+            R = i + len;
+        }
+        if (len == patternLen) {
             if (count == capacity) {
                 capacity *= 2;
                 int *temp = (int *)realloc(result, capacity * sizeof(int));
@@ -136,22 +155,21 @@ int *z_search(const char *text, const char *pattern, int *matchCount) {
                     fprintf(stderr, "결과 배열 재할당 실패\n");
                     free(result);
                     free(Z);
-                    free(concatStr);
                     *matchCount = -1;
                     return NULL;
                 }
                 result = temp;
             }
-            result[count++] = pos;
+            result[count++] = i;
         }
     }
     
     free(Z);
-    free(concatStr);
     *matchCount = count;
     return result;
 }
 
+#ifndef Z_SEARCH_LIBRARY
 // main 함수: Z 알고리즘 데모
 int main(void) {
     const char *text = "abracadabra";
@@ -170,4 +188,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* Z_SEARCH_LIBRARY */
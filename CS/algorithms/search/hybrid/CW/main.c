@@ -30,6 +30,8 @@
  *       free(occurrences);
  *   }
  *   freeTrie(root);
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define COMMENTZ_WALTER_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
@@ -56,11 +58,14 @@ typedef struct TrieNode {
     int outputCapacity;
 } TrieNode;
 
-// 검색 결과를 저장하는 구조체
+// 검색 결과를 저장하는 구조체 (다른 검색 엔진과 함께 포함될 때 한 번만 정의)
+#ifndef SEARCH_OCCURRENCE_DEFINED
+#define SEARCH_OCCURRENCE_DEFINED
 typedef struct {
     int patternId; // 매칭된 패턴의 ID
     int start;     // 텍스트에서 패턴이 시작하는 인덱스 (0 기반)
 } Occurrence;
+#endif
 
 /*---------------- Trie 및 Aho-Corasick 관련 함수 ----------------*/
 
@@ -185,9 +190,11 @@ void freeTrie(TrieNode *node) {
  * computeGlobalShift
  *
  * 다중 패턴 집합에 대해, 각 문자에 대한 글로벌 불일치 문자 이동 값을 계산합니다.
- * 각 문자 c에 대해, globalShift[c]는 패턴 중 c가 등장한 위치에 기반하여
- * (pattern_length - last_occurrence_index(c) - 1)의 최솟값을 저장합니다.
- * 만약 c가 어떤 패턴에도 등장하지 않으면, globalShift[c]는 (minPatternLength + 1)로 설정합니다.
+ * 각 문자 c에 대해, globalShift[c]는 패턴의 앞 minLen 문자 중 c가 등장한 위치에 기반하여
+ * (minPatternLength - last_occurrence_index(c) - 1)의 최솟값을 저장합니다.
+ * (검색 창의 길이가 minLen이므로, 길이가 다른 패턴이 섞여 있어도 건너뛰는 동안 매칭을 놓치지 않음)
+ * 만약 c가 어떤 패턴에도 등장하지 않으면, globalShift[c]는 minPatternLength로 설정합니다.
+ * (창의 마지막 문자 자체를 건너뛰어야 하므로 minLen + 1만큼 옮기면 그 다음 위치에서 시작하는 매칭을 놓침)
  *
  * 또한, *minLen에는 패턴 집합에서 가장 짧은 패턴의 길이가 저장됩니다.
  */
@@ -199,18 +206,20 @@ void computeGlobalShift(const char **patterns, int patternCount, int globalShift
     for (int i = 0; i < patternCount; i++) {
         int len = (int)strlen(patterns[i]);
         if (len < *minLen) *minLen = len;
-        // for each character in the pattern, compute candidate shift
-        for (int j = 0; j < len; j++) {
+    }
+    for (int i = 0; i < patternCount; i++) {
+        // for each character in the first minLen characters, compute candidate shift
+        for (int j = 0; j < *minLen; j++) {
             unsigned char c = (unsigned char)patterns[i][j];
-            int candidate = len - j - 1;
+            int candidate = *minLen - j - 1;
             if (candidate < globalShift[c])
                 globalShift[c] = candidate;
         }
     }
-    // For characters not present in any pattern, set shift to minLen + 1
+    // For characters not present in any pattern, set shift to minLen
     for (int c = 0; c < ALPHABET_SIZE; c++) {
         if (globalShift[c] == INT_MAX)
-            globalShift[c] = *minLen + 1;
+            globalShift[c] = *minLen;
     }
 }
 
@@ -222,16 +231,15 @@ void computeGlobalShift(const char **patterns, int patternCount, int globalShift
  * 주어진 텍스트의 s 위치에서 Trie(automaton)를 사용하여
  * 패턴들이 시작하는지 확인합니다.
  * 발견된 매칭은 동적 배열 occurrences에 추가됩니다.
+ * s에서 시작하는 패턴만 찾으므로 실패 링크 없이 트라이를 따라 내려가다가 자식이 없으면 멈춥니다.
+ * (검사 비용은 텍스트 길이가 아니라 가장 긴 패턴 길이에 비례)
  */
 void checkMatchAt(TrieNode *root, const char *text, int s, Occurrence **occurrences, int *occCount, int *occCapacity) {
-    int n = (int)strlen(text);
     TrieNode *node = root;
-    for (int i = s; i < n; i++) {
-        unsigned char c = (unsigned char)text[i];
-        while (node != root && node->children[c] == NULL)
-            node = node->failure;
-        if (node->children[c])
-            node = node->children[c];
+    for (int i = s; text[i] != '\0'; i++) {
+        node = node->children[(unsigned char)text[i]];
+        if (node == NULL)
+            break;
         // Check output: 매칭된 패턴들 중 시작 위치가 s 인 경우 기록
         if (node->outputCount > 0) {
             for (int j = 0; j < node->outputCount; j++) {
@@ -306,6 +314,7 @@ Occurrence* cw_search(TrieNode *root, const char **patterns, int patternCount, c
 
 /*---------------- main 함수 (데모) ----------------*/
 
+#ifndef COMMENTZ_WALTER_LIBRARY
 int main(void) {
     // 패턴 목록 예제
     const char *patterns[] = {"he", "she", "his", "hers"};
@@ -335,4 +344,5 @@ int main(void) {
     
     freeTrie(root);
     return 0;
-}
\ No newline at end of file
+}
+#endif /* COMMENTZ_WALTER_LIBRARY */
@@ -2,8 +2,14 @@
  * main.c
  *
  * 고도화된 Hybrid Pattern Matching 구현 예제
- * - 패턴의 길이와 데이터 특성에 따라 서로 다른 문자열 검색 알고리즘(브루트 포스, Boyer-Moore)을 선택하여 최적의 성능을 달성합니다.
- * - 짧은 패턴은 간단한 브루트 포스 알고리즘을, 긴 패턴은 Boyer-Moore 알고리즘(불일치 문자 규칙 기반)을 사용합니다.
+ * - 패턴의 통계(길이, 주기)에 따라 서로 다른 문자열 검색 알고리즘을 선택하여 최적의 성능을 달성합니다.
+ *   - 짧은 패턴(PATTERN_THRESHOLD 미만): 주기가 짧으면(예: "aaaa", "abab") KMP, 아니면 브루트 포스
+ *   - 주기가 짧은 긴 패턴: Two-Way (선형 시간, 추가 메모리 O(1))
+ *   - 아주 긴 패턴(SBOM_THRESHOLD 이상): SBOM (Backward Oracle Matching, 창마다 여러 칸 건너뜀)
+ *   - 그 밖의 패턴: Boyer-Moore (불일치 문자 + 좋은 접미사 규칙)
+ * - 모든 엔진은 공용 드문 바이트 전처리(../../rare_byte.c)를 사용합니다. 패턴에서 가장 드문 바이트 두 개를
+ *   AVX2/SSE2 비교로 찾아 그 후보 위치에서만 각 알고리즘이 검증하므로, 로그 검색처럼 패턴에 드문 바이트
+ *   ('E', 'R', '=', 숫자 등)가 있으면 대부분의 텍스트를 SIMD로 건너뜁니다.
  * - 검색 결과는 동적 배열로 반환되며, 호출자가 사용 후 free()로 메모리 해제해야 합니다.
  *
  * 사용 예:
@@ -15,18 +21,37 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 컴파일 예시: gcc -O2 -march=native main.c -o hpm
+ * 실행 예시: ./hpm 64   (64MB 로그 텍스트에서 엔진별, 전처리 유무별 벤치마크)
+ * 다른 파일에서 라이브러리로 쓸 때: #define HYBRID_PATTERN_LIBRARY 후 #include "main.c" (벤치마크와 데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
+#include <time.h>
+
+#define KMP_SEARCH_LIBRARY
+#include "../../KMP/main.c"
+#define BOYER_MOORE_LIBRARY
+#include "../../BoyerMoore/main.c"
+#define Z_SEARCH_LIBRARY
+#include "../../Z/main.c"
+#define TWO_WAY_LIBRARY
+#include "../TWSM/main.c"
+#define SBOM_LIBRARY
+#include "../SBOM/main.c"
 
-#define PATTERN_THRESHOLD 10  // 패턴 길이가 이 값 미만이면 브루트 포스 사용
+#define PATTERN_THRESHOLD 10  // 패턴 길이가 이 값 미만이면 브루트 포스(또는 KMP) 사용
+#define SBOM_THRESHOLD 32     // 패턴 길이가 이 값 이상이면 SBOM 사용
 
-/* 
+/*
  * 브루트 포스 탐색 함수
  * - 텍스트 내에서 패턴과 일치하는 모든 시작 인덱스를 동적 배열로 반환합니다.
+ * - 드문 바이트 두 개가 제자리에 있는 후보 위치에서만 비교합니다.
  */
 int* brute_force_search(const char *text, const char *pattern, int *matchCount) {
     int n = (int)strlen(text);
@@ -39,8 +64,16 @@ int* brute_force_search(const char *text, const char *pattern, int *matchCount)
         *matchCount = -1;
         return NULL;
     }
-    
+
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
+
     for (int i = 0; i <= n - m; i++) {
+        if (rb.useful) {
+            i = rare_byte_find(&rb, text, i, n - m);
+            if (i < 0)
+                break;
+        }
         int j = 0;
         while (j < m && text[i+j] == pattern[j])
             j++;
@@ -59,7 +92,7 @@ int* brute_force_search(const char *text, const char *pattern, int *matchCount)
             result[count++] = i;
         }
     }
-    
+
     *matchCount = count;
     return result;
 }
@@ -68,6 +101,7 @@ int* brute_force_search(const char *text, const char *pattern, int *matchCount)
  * Boyer-Moore 탐색 함수 (불일치 문자 규칙만 사용)
  * - 패턴의 각 문자에 대한 마지막 등장 위치를 이용하여 건너뛰기 간격을 결정합니다.
  * - 텍스트 내에서 패턴과 일치하는 모든 시작 인덱스를 동적 배열로 반환합니다.
+ * - 건너뛴 뒤에는 드문 바이트 후보 위치까지 한 번 더 건너뜁니다.
  */
 int* bm_search(const char *text, const char *pattern, int *matchCount) {
     int n = (int)strlen(text);
@@ -80,16 +114,24 @@ int* bm_search(const char *text, const char *pattern, int *matchCount) {
         *matchCount = -1;
         return NULL;
     }
-    
+
     // Build Bad Character Table
     int badChar[256];
     for (int i = 0; i < 256; i++)
         badChar[i] = -1;
     for (int i = 0; i < m; i++)
         badChar[(unsigned char)pattern[i]] = i;
-    
+
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
+
     int s = 0;  // shift of the pattern with respect to text
     while (s <= n - m) {
+        if (rb.useful) {
+            s = rare_byte_find(&rb, text, s, n - m);
+            if (s < 0)
+                break;
+        }
         int j = m - 1;
         // Compare pattern from rightmost character
         while (j >= 0 && pattern[j] == text[s + j])
@@ -116,37 +158,182 @@ int* bm_search(const char *text, const char *pattern, int *matchCount) {
             s += (shift > 0) ? shift : 1;
         }
     }
-    
+
     *matchCount = count;
     return result;
 }
 
+/* 패턴 통계: 엔진 선택에 쓰는 값들 */
+typedef struct {
+    int length;      // 패턴 길이
+    int period;      // 가장 짧은 주기 (m - 가장 긴 경계 길이)
+} PatternStats;
+
+typedef int *(*SearchFunc)(const char *text, const char *pattern, int *matchCount);
+
+// 패턴의 길이와 주기(KMP 경계 배열로 계산)
+static PatternStats analyzePattern(const char *pattern) {
+    PatternStats st;
+    int m = (int)strlen(pattern);
+    st.length = m;
+    st.period = m;
+    if (m > 1) {
+        int *lps = (int *)malloc(sizeof(int) * m);
+        if (!lps) {
+            fprintf(stderr, "메모리 할당 실패 (analyzePattern)\n");
+            exit(EXIT_FAILURE);
+        }
+        computeLPS(pattern, m, lps);
+        st.period = m - lps[m - 1];
+        free(lps);
+    }
+    return st;
+}
+
+/*
+ * 패턴 통계로 엔진 선택
+ * - 주기가 패턴 길이의 절반 이하이면 반복이 많은 패턴이므로, 텍스트에서도 부분 일치가 길게 이어지기 쉬움:
+ *   이때 건너뛰기 기반 엔진(BM, SBOM)은 최악 O(nm)에 가까워지므로 선형 시간 엔진(KMP, Two-Way)을 사용
+ * - 짧은 패턴은 건너뛰기 폭이 작아 전처리 비용만큼 이득이 없으므로, 후보 위치에서 단순 비교가 가장 쌈
+ */
+static SearchFunc chooseSearch(const PatternStats *st, const char **name) {
+    int periodic = st->length > 1 && 2 * st->period <= st->length;
+    if (st->length < PATTERN_THRESHOLD) {
+        if (periodic) {
+            *name = "KMP";
+            return kmp_search;
+        }
+        *name = "브루트 포스";
+        return brute_force_search;
+    }
+    if (periodic) {
+        *name = "Two-Way";
+        return two_way_search;
+    }
+    if (st->length >= SBOM_THRESHOLD) {
+        *name = "SBOM";
+        return sbom_search;
+    }
+    *name = "Boyer-Moore";
+    return boyer_moore_search;
+}
+
 /*
  * Hybrid Pattern Matching 함수
- * - 패턴 길이가 PATTERN_THRESHOLD 미만이면 브루트 포스 탐색을,
- *   그렇지 않으면 Boyer-Moore 탐색을 사용합니다.
+ * - 패턴 통계(길이, 주기)를 계산해 엔진을 고른 뒤 검색합니다.
  */
 int* hybrid_pattern_search(const char *text, const char *pattern, int *matchCount) {
     if (!text || !pattern || !matchCount) {
         fprintf(stderr, "입력 인자에 NULL이 전달되었습니다.\n");
         return NULL;
     }
-    
+
     int m = (int)strlen(pattern);
-    // 선택 기준: 패턴 길이가 작으면 단순 브루트 포스, 그렇지 않으면 Boyer-Moore 사용
-    if (m < PATTERN_THRESHOLD) {
-        return brute_force_search(text, pattern, matchCount);
-    } else {
-        return bm_search(text, pattern, matchCount);
+    if (m == 0) {
+        *matchCount = 0;
+        return NULL;
     }
+    PatternStats st = analyzePattern(pattern);
+    const char *name;
+    SearchFunc search = chooseSearch(&st, &name);
+    return search(text, pattern, matchCount);
+}
+
+#ifndef HYBRID_PATTERN_LIBRARY
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 벤치마크용 로그 텍스트 생성: INFO 줄이 대부분이고 가끔 WARN/ERROR 줄이 섞임
+static char *makeLogText(size_t size) {
+    static const char *paths[] = {"/api/users", "/api/orders", "/static/app.js", "/health", "/api/search?q=item"};
+    char *text = (char *)malloc(size + 1);
+    if (!text) {
+        fprintf(stderr, "메모리 할당 실패 (makeLogText)\n");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t state = 88172645463325252ULL;
+    size_t len = 0;
+    char line[160];
+    while (len < size) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        unsigned r = (unsigned)(state >> 32);
+        int lineLen;
+        if (r % 1000 == 0)
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u ERROR connection refused by upstream host 10.0.%u.%u\n",
+                               r % 60, (r >> 8) % 60, (r >> 12) % 256, (r >> 20) % 256);
+        else if (r % 100 == 1)
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u WARN slow response (timeout=%us) on %s\n",
+                               r % 60, (r >> 8) % 60, (r >> 12) % 60, paths[(r >> 20) % 5]);
+        else
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u INFO request id=%u GET %s status=200 took %ums\n",
+                               r % 60, (r >> 8) % 60, r >> 8, paths[(r >> 20) % 5], (r >> 4) % 500);
+        if (len + (size_t)lineLen > size)
+            lineLen = (int)(size - len);
+        memcpy(text + len, line, (size_t)lineLen);
+        len += (size_t)lineLen;
+    }
+    text[size] = '\0';
+    return text;
+}
+
+// 대용량 벤치마크: 엔진별로 전처리를 켜고 끈 검색 시간을 비교
+static void benchmark(int megabytes) {
+    static const char *patterns[] = {
+        "ERROR",
+        "timeout=42s",
+        "abababab",
+        "connection refused by upstream host 10.0.7",
+        "status=200",
+    };
+    static const struct { const char *name; SearchFunc search; } engines[] = {
+        {"브루트 포스", brute_force_search}, {"BM(불일치 문자)", bm_search}, {"KMP", kmp_search},
+        {"Boyer-Moore", boyer_moore_search}, {"Z", z_search}, {"Two-Way", two_way_search},
+        {"SBOM", sbom_search}, {"Hybrid", hybrid_pattern_search},
+    };
+    int patternCount = (int)(sizeof(patterns) / sizeof(patterns[0]));
+    int engineCount = (int)(sizeof(engines) / sizeof(engines[0]));
+    size_t size = (size_t)megabytes << 20;
+    char *text = makeLogText(size);
+
+    printf("\n%dMB 로그 텍스트 검색 (초, 전처리 끔 / 켬)\n", megabytes);
+    for (int p = 0; p < patternCount; p++) {
+        const char *name;
+        PatternStats st = analyzePattern(patterns[p]);
+        chooseSearch(&st, &name);
+        printf("패턴 \"%s\" (길이 %d, 주기 %d, Hybrid 선택: %s)\n", patterns[p], st.length, st.period, name);
+        int expected = -1;
+        for (int e = 0; e < engineCount; e++) {
+            double seconds[2];
+            int counts[2];
+            for (int on = 0; on < 2; on++) {
+                rareBytePrefilterEnabled = on;
+                double start = nowSeconds();
+                int *matches = engines[e].search(text, patterns[p], &counts[on]);
+                seconds[on] = nowSeconds() - start;
+                free(matches);
+            }
+            if (expected < 0)
+                expected = counts[0];
+            int ok = counts[0] == expected && counts[1] == expected;
+            printf("  %-16s %.3f / %.3f  (매칭 %d개)%s\n", engines[e].name, seconds[0], seconds[1], counts[1],
+                   ok ? "" : " (결과 불일치!)");
+        }
+    }
+    rareBytePrefilterEnabled = 1;
+    free(text);
 }
 
 /* main 함수: Hybrid Pattern Matching 알고리즘 데모 */
-int main(void) {
+int main(int argc, char *argv[]) {
     const char *text = "This is a simple example to demonstrate hybrid pattern matching.";
     const char *pattern = "pattern";
     int matchCount = 0;
-    
+
     int *matches = hybrid_pattern_search(text, pattern, &matchCount);
     if (!matches && matchCount <= 0) {
         printf("패턴을 찾을 수 없습니다.\n");
@@ -159,6 +346,9 @@ int main(void) {
     } else {
         printf("검색 중 오류가 발생했습니다.\n");
     }
-    
+
+    benchmark(argc > 1 ? atoi(argv[1]) : 64);
+
     return 0;
-}
\ No newline at end of file
+}
+#endif /* HYBRID_PATTERN_LIBRARY */
@@ -1,12 +1,16 @@
 /**
  * main.c
  *
- * 고도화된 Set-Backward Oracle Matching (SBOM) 알고리즘 구현 예제
- * - 이 구현은 Boyer-Moore의 불일치 휴리스틱과 Factor Oracle (오토마타 기반) 자료구조를 결합하여
- *   단일 패턴 검색을 수행하는 하이브리드 알고리즘입니다.
- * - 패턴에 대해 Factor Oracle을 구축하고, 이를 활용하여 텍스트 내에서 패턴을 빠르게 검증합니다.
- * - 동시에, Boyer-Moore의 아이디어에 기반한 글로벌 불일치 문자 이동 테이블(global shift table)을 사용하여
- *   불일치 발생 시 효과적으로 검색 위치를 건너뜁니다.
+ * Set-Backward Oracle Matching (SBOM) 알고리즘의 단일 패턴 버전(Backward Oracle Matching) 구현 예제
+ * - 패턴을 뒤집은 문자열에 대해 Factor Oracle을 구축합니다. Factor Oracle은 (뒤집힌) 패턴의 모든 부분 문자열을
+ *   인식하는 작은 오토마타입니다(부분 문자열이 아닌 일부 문자열도 받아들일 수 있지만, 그 반대는 없음).
+ * - 검색 창(window)의 오른쪽 끝에서 왼쪽으로 텍스트를 읽으며 오라클 전이를 따라갑니다.
+ *   - 위치 i에서 전이가 없으면 t[j+i .. j+m-1]은 패턴의 부분 문자열이 아니므로 창을 i + 1칸 옮깁니다.
+ *   - 창 전체를 읽으면 패턴과 일치한 것이며(길이 m인 인식 문자열은 패턴 자신뿐), 창을 한 칸 옮깁니다.
+ * - 긴 패턴에서 한 번에 여러 칸을 건너뛰므로 평균적으로 텍스트의 일부만 읽습니다.
+ *
+ * 드문 바이트 전처리(../../rare_byte.c): 창을 옮길 때마다, 패턴의 드문 바이트 두 개가 제자리에 있는
+ * 다음 창까지 SIMD로 건너뛴 뒤 오라클로 확인합니다.
  *
  * 사용 예:
  *   int matchCount = 0;
@@ -17,12 +21,17 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define SBOM_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define RARE_BYTE_LIBRARY
+#include "../../rare_byte.c"
+
 #define ALPHABET_SIZE 256
 
 /*---------------- Factor Oracle 자료구조 ----------------*/
@@ -84,43 +93,15 @@ FOState* buildFactorOracle(const char *pattern) {
     return oracle;
 }
 
-/*---------------- 글로벌 불일치 문자 이동 테이블 ----------------*/
-
-/*
- * computeGlobalShift
- *
- * 패턴에 대해 Boyer-Moore 스타일의 불일치 문자 휴리스틱을 적용하여,
- * 각 문자 c에 대해 이동 거리를 globalShift[c]에 계산합니다.
- * - 만약 c가 패턴에 등장하지 않으면, 이동 거리는 (m + 1)로 설정됩니다.
- * - 그렇지 않으면, globalShift[c] = m - lastOccurrence[c] - 1.
- */
-void computeGlobalShift(const char *pattern, int globalShift[ALPHABET_SIZE]) {
-    int m = (int)strlen(pattern);
-    int last[ALPHABET_SIZE];
-    for (int c = 0; c < ALPHABET_SIZE; c++) {
-        last[c] = -1;
-    }
-    for (int i = 0; i < m; i++) {
-        last[(unsigned char)pattern[i]] = i;
-    }
-    for (int c = 0; c < ALPHABET_SIZE; c++) {
-        if (last[c] == -1)
-            globalShift[c] = m + 1;
-        else
-            globalShift[c] = m - last[c] - 1;
-    }
-}
-
 /*---------------- SBOM 검색 함수 ----------------*/
 
 /*
  * sbom_search
  *
- * SBOM 알고리즘을 사용하여 텍스트 내에서 패턴이 등장하는 모든 시작 인덱스를 찾습니다.
- * - 먼저, 패턴에 대한 Factor Oracle을 구축하고, 글로벌 불일치 문자 이동 테이블을 계산합니다.
- * - 검색 단계에서는 텍스트의 위치 s에서, Factor Oracle을 이용해 패턴과의 전이 과정을 수행합니다.
- *   만약 전체 패턴에 대해 전이가 성공하면 매칭된 것으로 간주하고, 결과 배열에 s를 기록합니다.
- * - 불일치가 발생하면, 텍스트의 해당 위치 문자에 따른 글로벌 이동 거리를 사용하여 s를 업데이트합니다.
+ * Backward Oracle Matching으로 텍스트 내에서 패턴이 등장하는 모든 시작 인덱스를 찾습니다.
+ * - 먼저, 뒤집은 패턴에 대한 Factor Oracle을 구축합니다.
+ * - 검색 창 [j, j+m)을 오른쪽 끝부터 왼쪽으로 읽으며 오라클 전이를 따라갑니다.
+ *   전이가 끊긴 위치 i에 대해 창을 i + 1칸 옮기고, 끝까지 읽으면 j를 결과에 기록하고 한 칸 옮깁니다.
  *
  * 반환: 동적 할당된 정수 배열 (매칭 위치 인덱스들)
  *         매칭된 개수는 matchCount에 저장됨.
@@ -138,11 +119,20 @@ int* sbom_search(const char *text, const char *pattern, int *matchCount) {
         return NULL;
     }
     
-    // Factor Oracle 구축
-    FOState *oracle = buildFactorOracle(pattern);
-    // 글로벌 불일치 이동 테이블 계산
-    int globalShift[ALPHABET_SIZE];
-    computeGlobalShift(pattern, globalShift);
+    // 뒤집은 패턴에 대해 Factor Oracle 구축
+    char *reversed = (char *)malloc((size_t)m + 1);
+    if (!reversed) {
+        fprintf(stderr, "메모리 할당 실패 (sbom_search)\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < m; i++)
+        reversed[i] = pattern[m - 1 - i];
+    reversed[m] = '\0';
+    FOState *oracle = buildFactorOracle(reversed);
+    free(reversed);
+    
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
     
     // 결과 배열 초기화
     int capacity = 10;
@@ -155,20 +145,24 @@ int* sbom_search(const char *text, const char *pattern, int *matchCount) {
         return NULL;
     }
     
-    int s = 0;
-    while (s <= n - m) {
+    int j = 0;
+    while (j <= n - m) {
+        if (rb.useful) {
+            // 드문 바이트가 맞는 다음 창으로 이동
+            j = rare_byte_find(&rb, text, j, n - m);
+            if (j < 0)
+                break;
+        }
+        // 창의 오른쪽 끝부터 왼쪽으로 오라클 전이
         int state = 0;
-        int i;
-        // Factor Oracle을 통해 패턴 전이 검사 (왼쪽부터 순차 비교)
-        for (i = 0; i < m; i++) {
-            unsigned char c = (unsigned char)text[s + i];
-            if (oracle[state].transitions[c] != -1) {
-                state = oracle[state].transitions[c];
-            } else {
+        int i = m - 1;
+        while (i >= 0) {
+            state = oracle[state].transitions[(unsigned char)text[j + i]];
+            if (state == -1)
                 break;
-            }
+            i--;
         }
-        if (i == m) {
+        if (i < 0) {
             // 패턴이 완전히 매칭됨
             if (count == capacity) {
                 capacity *= 2;
@@ -182,16 +176,11 @@ int* sbom_search(const char *text, const char *pattern, int *matchCount) {
                 }
                 result = temp;
             }
-            result[count++] = s;
-            // 매칭된 경우, 다음 비교 위치는 s + globalShift[다음 문자] (가능하면)
-            if (s + m < n)
-                s += globalShift[(unsigned char)text[s + m]];
-            else
-                s++;
+            result[count++] = j;
+            j++;
         } else {
-            // 불일치 발생: 텍스트의 첫 불일치 문자에 따른 이동
-            int shift = globalShift[(unsigned char)text[s + i]];
-            s += (shift > 0) ? shift : 1;
+            // t[j+i .. j+m-1]은 패턴의 부분 문자열이 아니므로, 이 구간을 포함하는 창은 모두 건너뜀
+            j += i + 1;
         }
     }
     
@@ -202,6 +191,7 @@ int* sbom_search(const char *text, const char *pattern, int *matchCount) {
 
 /*---------------- main 함수 (데모) ----------------*/
 
+#ifndef SBOM_LIBRARY
 int main(void) {
     const char *text = "abracadabra";
     const char *pattern = "abra";
@@ -221,4 +211,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* SBOM_LIBRARY */
@@ -16,41 +16,56 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 드문 바이트 전처리(../../rare_byte.c): 이전 비교에서 기억한 일치 정보(memory)가 없을 때는
+ * 패턴의 드문 바이트 두 개가 제자리에 있는 다음 위치까지 SIMD로 건너뛴 뒤 Two-Way 비교를 합니다.
+ * 다른 파일에서 라이브러리로 쓸 때: #define TWO_WAY_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define RARE_BYTE_LIBRARY
+#include "../../rare_byte.c"
+
 /* 
-   maximal_suffix: 패턴의 최대 접미사와 그에 해당하는 주기를 계산합니다.
-   flag 인자가 1이면 "lexicographically maximum" (>=)를, 0이면 "lexicographically minimum" (<=)을 기준으로 합니다.
-   반환값은 계산된 최대 접미사의 시작 인덱스이며, *p에 주기가 저장됩니다.
+   maximal_suffix: 패턴의 최대 접미사와 그에 해당하는 주기를 계산합니다. (Crochemore-Perrin)
+   flag 인자가 1이면 "lexicographically maximum" 순서를, 0이면 반대 순서를 기준으로 합니다.
+   반환값은 계산된 최대 접미사의 시작 인덱스이며, *p에 그 접미사의 주기가 저장됩니다.
 */
 static int maximal_suffix(const char *s, int m, int flag, int *p) {
-    int i = 0, j = 1, k = 0;
+    int ms = -1, j = 0, k = 1;
     *p = 1;
     while (j + k < m) {
-        if (s[i + k] == s[j + k]) {
-            k++;
-        } else if ((s[i + k] < s[j + k]) == flag) {
-            // s[j+k] is "better" than s[i+k] in the chosen order
-            j = j + k + 1;
-            k = 0;
-            *p = j - i;
+        unsigned char a = (unsigned char)s[j + k];
+        unsigned char b = (unsigned char)s[ms + k];
+        if (a == b) {
+            // 현재 주기만큼 일치했으면 다음 주기로
+            if (k != *p) {
+                k++;
+            } else {
+                j += *p;
+                k = 1;
+            }
+        } else if ((a < b) == flag) {
+            // 후보 접미사가 더 "작음": 주기가 늘어남
+            j += k;
+            k = 1;
+            *p = j - ms;
         } else {
-            i = (j > i + k + 1) ? j : i + k + 1;
-            j = i + 1;
-            k = 0;
-            *p = 1;
+            // 더 "큰" 접미사 발견: 새 후보로 교체
+            ms = j;
+            j = ms + 1;
+            k = *p = 1;
         }
     }
-    return i;
+    return ms + 1;
 }
 
 /*
    two_way_critical: 패턴의 critical factorization를 계산합니다.
-   두 가지 maximal_suffix 계산(하나는 >= 기준, 다른 하나는 <= 기준)을 수행한 후,
+   두 가지 순서로 maximal_suffix를 계산한 후,
    더 큰 시작 인덱스를 critical 분할점(pos)로 선택하고, 해당 주기를 per에 저장합니다.
 */
 static void two_way_critical(const char *pattern, int m, int *pos, int *per) {
@@ -102,17 +117,32 @@ int *two_way_search(const char *text, const char *pattern, int *matchCount) {
     }
     int count = 0;
     
+    // 패턴 전체가 주기 per를 가지면(왼쪽 부분이 per만큼 밀어도 같으면) 주기 이동과 memory를 쓰고,
+    // 아니면 어떤 매칭도 겹칠 수 없을 만큼 크게 이동하며 memory를 쓰지 않음
+    int periodic = (pos + per <= m && memcmp(pattern, pattern + per, pos) == 0);
+    if (!periodic)
+        per = ((pos > m - pos) ? pos : m - pos) + 1;
+    
+    RareBytePrefilter rb;
+    rare_byte_init(&rb, pattern, m);
+    
     int i = 0;       // 텍스트 내에서의 현재 검색 시작 인덱스
     int memory = 0;  // 이전 비교에서 왼쪽 부분에서 일치한 문자 수
     while (i <= n - m) {
+        if (memory == 0 && rb.useful) {
+            // 기억한 일치 정보가 없으면 드문 바이트가 맞는 다음 후보 위치로 이동
+            i = rare_byte_find(&rb, text, i, n - m);
+            if (i < 0)
+                break;
+        }
         // 오른쪽 부분(후반부) 비교: pos와 memory 중 큰 값부터 시작
         int j = (pos > memory) ? pos : memory;
         while (j < m && pattern[j] == text[i + j]) {
             j++;
         }
         if (j < m) {
-            // 불일치 발생: 건너뛰기 간격은 (j - memory + 1)
-            i += j - memory + 1;
+            // 불일치 발생: 건너뛰기 간격은 (j - pos + 1)
+            i += j - pos + 1;
             memory = 0;
         } else {
             // 후반부 모두 일치하면, 왼쪽 부분(전반부) 비교 수행
@@ -137,8 +167,8 @@ int *two_way_search(const char *text, const char *pattern, int *matchCount) {
             }
             // 패턴이 주기(per)만큼 이동
             i += per;
-            // 이전 비교에서 오른쪽 부분이 일치했던 문자의 수를 보존
-            memory = (m - per > 0) ? m - per : 0;
+            // 주기적 패턴이면 이전 비교에서 일치했던 앞부분 (m - per)글자를 기억
+            memory = periodic ? m - per : 0;
         }
     }
     
@@ -146,6 +176,7 @@ int *two_way_search(const char *text, const char *pattern, int *matchCount) {
     return result;
 }
 
+#ifndef TWO_WAY_LIBRARY
 /* main 함수: Two-Way String Matching 알고리즘 데모 */
 int main(void) {
     const char *text = "abracadabra";
@@ -166,4 +197,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* TWO_WAY_LIBRARY */
@@ -0,0 +1,378 @@
+/**
+ * main.c
+ *
+ * Teddy 방식 SIMD 다중 패턴 사전 필터 구현 예제 (Hyperscan의 Teddy 참고)
+ * - 패턴이 몇 개~64개 정도인 작은 집합에서, 텍스트를 16/32바이트씩 SIMD로 훑어 후보 위치만 골라냅니다.
+ * - 후보 위치는 Commentz-Walter 구현(../CW/main.c)의 트라이로 검증(checkMatchAt)하여 정확한 매칭만 보고합니다.
+ * - multi_pattern_search는 패턴 수와 길이를 보고 Teddy / Wu-Manber(../WM/main.c) / Commentz-Walter 중 하나를 고릅니다.
+ *
+ * 동작 원리 (packed bucket):
+ * - 패턴을 최대 8개의 버킷으로 나눕니다. (앞부분이 비슷한 패턴끼리 같은 버킷)
+ * - 패턴의 앞 1~3바이트(TEDDY_MAX_MASKS) 각 위치 k마다 16바이트 표 두 개를 만듭니다.
+ *   lo[k][x]: 앞에서 k번째 바이트의 하위 4비트가 x인 패턴이 있는 버킷들의 비트 집합, hi[k][x]: 상위 4비트 기준
+ * - 텍스트 위치 i에서 pshufb(lo[k], text[i+k] & 15) & pshufb(hi[k], text[i+k] >> 4)를 k에 대해 모두 AND하면,
+ *   i에서 시작하는 앞 1~3바이트가 니블 단위로 맞는 버킷만 비트가 남습니다. 표 조회 16/32개가 명령 하나입니다.
+ * - 결과가 0이 아닌 위치만 후보로 검증합니다. 버킷을 나누면 서로 다른 패턴의 니블이 섞여 생기는 거짓 후보가 줄어듭니다.
+ * - AVX2(32바이트), SSSE3(16바이트) 순으로 컴파일 대상에 맞는 경로를 쓰며, 둘 다 없으면 같은 표를 바이트 단위로 조회합니다.
+ *   바이트 단위 조회는 Wu-Manber보다 느리므로, 이 경우 multi_pattern_search는 Teddy를 고르지 않습니다.
+ *
+ * 사용 예:
+ *   const char *patterns[] = {"error", "fail", "timeout", "panic"};
+ *   int matchCount = 0;
+ *   Occurrence *matches = multi_pattern_search(patterns, 4, logText, &matchCount);
+ *   if (matches) {
+ *       for (int i = 0; i < matchCount; i++) {
+ *           printf("패턴 ID %d 발견, 시작 인덱스 %d\n", matches[i].patternId, matches[i].start);
+ *       }
+ *       free(matches);
+ *   }
+ *
+ *   // 같은 패턴 집합으로 여러 텍스트를 검색할 때는 한 번만 컴파일
+ *   Teddy *teddy = teddy_create(patterns, 4);
+ *   Occurrence *occ = teddy_search(teddy, text, &matchCount);
+ *   teddy_free(teddy);
+ *
+ * 컴파일 예시: gcc -O2 -march=native main.c -o teddy
+ * 실행 예시: ./teddy 64   (8MB 텍스트에서 Teddy / Wu-Manber / Commentz-Walter 비교)
+ * 다른 파일에서 라이브러리로 쓸 때: #define TEDDY_LIBRARY 후 #include "main.c" (벤치마크와 데모 main 제외)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+#define WU_MANBER_LIBRARY
+#include "../WM/main.c"
+#define COMMENTZ_WALTER_LIBRARY
+#include "../CW/main.c"
+
+#define TEDDY_BUCKETS 8          // 버킷 수 (결과 바이트의 비트 하나씩)
+#define TEDDY_MAX_MASKS 3        // 비교하는 패턴 앞부분 바이트 수
+#define TEDDY_MAX_PATTERNS 64    // 이보다 많으면 버킷당 패턴이 많아져 거짓 후보가 늘어남
+#define TEDDY_SKIP_MIN_LEN 12    // 가장 짧은 패턴이 이 길이 이상이면 건너뛰기가 큰 Wu-Manber가 더 빠름
+
+/* Teddy 사전 필터: 니블 표와 후보 검증용 트라이 */
+typedef struct {
+    uint8_t lo[TEDDY_MAX_MASKS][16];   // 하위 니블 → 버킷 비트 집합
+    uint8_t hi[TEDDY_MAX_MASKS][16];   // 상위 니블 → 버킷 비트 집합
+    int maskCount;                     // 실제로 비교하는 앞부분 바이트 수 (1 ~ min(3, 최소 패턴 길이))
+    int patternCount;
+    TrieNode *root;                    // Commentz-Walter 트라이 (checkMatchAt으로 후보 검증)
+} Teddy;
+
+/*
+ * teddy_create
+ *
+ * 패턴 집합(1 ~ TEDDY_MAX_PATTERNS개, 빈 문자열 불가)으로 Teddy 사전 필터를 만듭니다.
+ * 지원하지 않는 집합이면 NULL을 반환합니다.
+ */
+Teddy* teddy_create(const char **patterns, int patternCount) {
+    if (!patterns || patternCount <= 0 || patternCount > TEDDY_MAX_PATTERNS)
+        return NULL;
+    int minLen = INT_MAX;
+    for (int i = 0; i < patternCount; i++) {
+        int len = (int)strlen(patterns[i]);
+        if (len < minLen)
+            minLen = len;
+    }
+    if (minLen == 0)
+        return NULL;
+
+    Teddy *teddy = (Teddy*)malloc(sizeof(Teddy));
+    if (!teddy) {
+        fprintf(stderr, "메모리 할당 실패: Teddy\n");
+        exit(EXIT_FAILURE);
+    }
+    teddy->maskCount = minLen < TEDDY_MAX_MASKS ? minLen : TEDDY_MAX_MASKS;
+    teddy->patternCount = patternCount;
+    // 쓰지 않는 위치의 표는 모든 버킷을 통과시킴 (검색 루프는 항상 TEDDY_MAX_MASKS개를 AND)
+    memset(teddy->lo, 0, sizeof(teddy->lo));
+    memset(teddy->hi, 0, sizeof(teddy->hi));
+    for (int k = teddy->maskCount; k < TEDDY_MAX_MASKS; k++) {
+        memset(teddy->lo[k], 0xff, 16);
+        memset(teddy->hi[k], 0xff, 16);
+    }
+
+    // 사전순으로 정렬해 연속한 묶음을 한 버킷으로: 앞부분이 같은 패턴이 같은 버킷에 들어가 니블이 덜 섞임
+    // (패턴이 최대 64개이므로 삽입 정렬)
+    int order[TEDDY_MAX_PATTERNS];
+    for (int i = 0; i < patternCount; i++) {
+        int j = i;
+        while (j > 0 && strcmp(patterns[order[j - 1]], patterns[i]) > 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    int perBucket = (patternCount + TEDDY_BUCKETS - 1) / TEDDY_BUCKETS;
+    for (int r = 0; r < patternCount; r++) {
+        const unsigned char *p = (const unsigned char*)patterns[order[r]];
+        uint8_t bit = (uint8_t)(1u << (r / perBucket));
+        for (int k = 0; k < teddy->maskCount; k++) {
+            teddy->lo[k][p[k] & 0x0f] |= bit;
+            teddy->hi[k][p[k] >> 4] |= bit;
+        }
+    }
+
+    teddy->root = createTrieNode();
+    for (int i = 0; i < patternCount; i++)
+        insertPattern(teddy->root, patterns[i], i);
+    return teddy;
+}
+
+void teddy_free(Teddy *teddy) {
+    if (!teddy)
+        return;
+    freeTrie(teddy->root);
+    free(teddy);
+}
+
+// 위치 i 하나에 대한 버킷 비트 집합 (SIMD 경로의 나머지 부분, i + maskCount <= n)
+static inline uint8_t teddyScalarMatch(const Teddy *teddy, const unsigned char *p) {
+    uint8_t bits = 0xff;
+    for (int k = 0; k < teddy->maskCount; k++)
+        bits &= teddy->lo[k][p[k] & 0x0f] & teddy->hi[k][p[k] >> 4];
+    return bits;
+}
+
+/*
+ * teddy_search
+ *
+ * 텍스트에서 모든 패턴의 매칭 결과를 찾습니다. 결과는 시작 위치 순이며, 호출자가 free()로 해제합니다.
+ */
+Occurrence* teddy_search(const Teddy *teddy, const char *text, int *matchCount) {
+    const unsigned char *t = (const unsigned char*)text;
+    int n = (int)strlen(text);
+    int occCapacity = 10;
+    int occCount = 0;
+    Occurrence *occurrences = (Occurrence*)malloc(occCapacity * sizeof(Occurrence));
+    if (!occurrences) {
+        fprintf(stderr, "메모리 할당 실패: occurrences (teddy_search)\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int i = 0;
+#if defined(__AVX2__)
+    // 32바이트씩: pshufb는 128비트 레인 안에서만 조회하므로 표를 두 레인에 복사
+    __m256i lo[TEDDY_MAX_MASKS], hi[TEDDY_MAX_MASKS];
+    for (int k = 0; k < TEDDY_MAX_MASKS; k++) {
+        lo[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)teddy->lo[k]));
+        hi[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)teddy->hi[k]));
+    }
+    const __m256i low4 = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 + TEDDY_MAX_MASKS - 1 <= n; i += 32) {
+        __m256i result = _mm256_set1_epi8((char)0xff);
+        for (int k = 0; k < TEDDY_MAX_MASKS; k++) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(t + i + k));
+            __m256i l = _mm256_shuffle_epi8(lo[k], _mm256_and_si256(chunk, low4));
+            __m256i h = _mm256_shuffle_epi8(hi[k], _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low4));
+            result = _mm256_and_si256(result, _mm256_and_si256(l, h));
+        }
+        uint32_t candidates = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(result, zero));
+        while (candidates) {
+            int p = __builtin_ctz(candidates);
+            checkMatchAt(teddy->root, text, i + p, &occurrences, &occCount, &occCapacity);
+            candidates &= candidates - 1;
+        }
+    }
+#elif defined(__SSSE3__)
+    // 16바이트씩
+    __m128i lo[TEDDY_MAX_MASKS], hi[TEDDY_MAX_MASKS];
+    for (int k = 0; k < TEDDY_MAX_MASKS; k++) {
+        lo[k] = _mm_loadu_si128((const __m128i*)teddy->lo[k]);
+        hi[k] = _mm_loadu_si128((const __m128i*)teddy->hi[k]);
+    }
+    const __m128i low4 = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 + TEDDY_MAX_MASKS - 1 <= n; i += 16) {
+        __m128i result = _mm_set1_epi8((char)0xff);
+        for (int k = 0; k < TEDDY_MAX_MASKS; k++) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(t + i + k));
+            __m128i l = _mm_shuffle_epi8(lo[k], _mm_and_si128(chunk, low4));
+            __m128i h = _mm_shuffle_epi8(hi[k], _mm_and_si128(_mm_srli_epi16(chunk, 4), low4));
+            result = _mm_and_si128(result, _mm_and_si128(l, h));
+        }
+        uint32_t candidates = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(result, zero)) & 0xffffu;
+        while (candidates) {
+            int p = __builtin_ctz(candidates);
+            checkMatchAt(teddy->root, text, i + p, &occurrences, &occCount, &occCapacity);
+            candidates &= candidates - 1;
+        }
+    }
+#endif
+    // 나머지 (또는 SIMD가 없는 대상): 같은 표를 바이트 단위로 조회
+    for (; i + teddy->maskCount <= n; i++) {
+        if (teddyScalarMatch(teddy, t + i))
+            checkMatchAt(teddy->root, text, i, &occurrences, &occCount, &occCapacity);
+    }
+
+    *matchCount = occCount;
+    return occurrences;
+}
+
+/* 엔진 자동 선택 */
+
+typedef enum {
+    ENGINE_TEDDY,
+    ENGINE_WU_MANBER,
+    ENGINE_COMMENTZ_WALTER
+} SearchEngine;
+
+/*
+ * 패턴 수와 길이로 엔진을 고릅니다.
+ * - 패턴이 TEDDY_MAX_PATTERNS개 이하이고 짧은 패턴이 있으면 Teddy (SIMD로 모든 위치를 빠르게 거름)
+ *   SSSE3/AVX2 없이 컴파일하면 Teddy는 바이트 단위 조회로 떨어지므로 고르지 않음
+ * - 가장 짧은 패턴이 BLOCK_SIZE 이상이면 Wu-Manber (패턴이 길수록 블록 해시로 크게 건너뜀)
+ * - 그 외 (1글자 패턴이 섞인 큰 집합)는 Commentz-Walter
+ */
+static SearchEngine chooseEngine(const char **patterns, int patternCount) {
+    int minLen = INT_MAX;
+    for (int i = 0; i < patternCount; i++) {
+        int len = (int)strlen(patterns[i]);
+        if (len < minLen)
+            minLen = len;
+    }
+#if defined(__AVX2__) || defined(__SSSE3__)
+    if (patternCount <= TEDDY_MAX_PATTERNS && minLen < TEDDY_SKIP_MIN_LEN)
+        return ENGINE_TEDDY;
+#endif
+    if (minLen >= BLOCK_SIZE)
+        return ENGINE_WU_MANBER;
+    return ENGINE_COMMENTZ_WALTER;
+}
+
+static Occurrence* searchWithEngine(SearchEngine engine, const char **patterns, int patternCount,
+                                    const char *text, int *matchCount) {
+    if (engine == ENGINE_TEDDY) {
+        Teddy *teddy = teddy_create(patterns, patternCount);
+        if (teddy) {
+            Occurrence *occ = teddy_search(teddy, text, matchCount);
+            teddy_free(teddy);
+            return occ;
+        }
+        engine = ENGINE_COMMENTZ_WALTER;
+    }
+    if (engine == ENGINE_WU_MANBER)
+        return wu_manber_search(patterns, patternCount, text, matchCount);
+
+    TrieNode *root = createTrieNode();
+    for (int i = 0; i < patternCount; i++)
+        insertPattern(root, patterns[i], i);
+    buildFailureLinks(root);
+    Occurrence *occ = cw_search(root, patterns, patternCount, text, matchCount);
+    freeTrie(root);
+    return occ;
+}
+
+/*
+ * multi_pattern_search
+ *
+ * 패턴 집합에 맞는 엔진을 골라 텍스트에서 모든 패턴의 매칭 결과를 찾습니다. (빈 패턴 불가)
+ * 반환: Occurrence 배열 (동적 할당), 호출자가 free()로 해제
+ */
+Occurrence* multi_pattern_search(const char **patterns, int patternCount, const char *text, int *matchCount) {
+    if (!patterns || patternCount <= 0 || !text || !matchCount) {
+        fprintf(stderr, "입력 인자가 올바르지 않습니다.\n");
+        return NULL;
+    }
+    return searchWithEngine(chooseEngine(patterns, patternCount), patterns, patternCount, text, matchCount);
+}
+
+#ifndef TEDDY_LIBRARY
+
+/* 벤치마크 */
+
+static const char *engineNames[] = {"Teddy", "Wu-Manber", "Commentz-Walter"};
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 영문 소문자/공백 텍스트에서 길이 minLen~maxLen인 패턴 patternCount개를 세 엔진으로 검색
+static void benchmark(int patternCount, int minLen, int maxLen) {
+    const int n = 8 << 20;
+    uint64_t state = 88172645463325252ULL;
+    char *text = (char*)malloc((size_t)n + 1);
+    char (*storage)[64] = malloc((size_t)patternCount * sizeof(*storage));
+    const char **patterns = (const char**)malloc((size_t)patternCount * sizeof(char*));
+    if (!text || !storage || !patterns) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        uint64_t r = nextRandom(&state) % 32;
+        text[i] = r < 26 ? (char)('a' + r) : ' ';
+    }
+    text[n] = '\0';
+    for (int p = 0; p < patternCount; p++) {
+        int len = minLen + (int)(nextRandom(&state) % (uint64_t)(maxLen - minLen + 1));
+        for (int j = 0; j < len; j++)
+            storage[p][j] = (char)('a' + nextRandom(&state) % 26);
+        storage[p][len] = '\0';
+        patterns[p] = storage[p];
+    }
+
+    printf("\n패턴 %d개 (길이 %d~%d), 텍스트 %dMB: 자동 선택 = %s\n", patternCount, minLen, maxLen, n >> 20,
+           engineNames[chooseEngine(patterns, patternCount)]);
+    int expected = -1;
+    for (int e = 0; e < 3; e++) {
+        if (e == ENGINE_TEDDY && patternCount > TEDDY_MAX_PATTERNS)
+            continue;
+        if (e == ENGINE_WU_MANBER && minLen < BLOCK_SIZE)
+            continue;
+        int count = 0;
+        double start = nowSeconds();
+        Occurrence *occ = searchWithEngine((SearchEngine)e, patterns, patternCount, text, &count);
+        double elapsed = nowSeconds() - start;
+        if (expected < 0)
+            expected = count;
+        printf("  %-16s %.3f초 (%.0f MB/s), 매칭 %d개 %s\n", engineNames[e], elapsed,
+               (double)n / (1 << 20) / elapsed, count, count == expected ? "" : "(결과 불일치!)");
+        free(occ);
+    }
+    free(patterns);
+    free(storage);
+    free(text);
+}
+
+/* main 함수: Teddy 사전 필터와 엔진 자동 선택 데모 */
+int main(int argc, char *argv[]) {
+    const char *patterns[] = {"he", "she", "his", "hers"};
+    int patternCount = sizeof(patterns) / sizeof(patterns[0]);
+    const char *text = "ahishers";
+
+    int matchCount = 0;
+    Occurrence *matches = multi_pattern_search(patterns, patternCount, text, &matchCount);
+    if (matches == NULL || matchCount <= 0) {
+        printf("매칭된 패턴이 없습니다.\n");
+    } else {
+        printf("텍스트 \"%s\"에서 매칭 결과 (%s):\n", text, engineNames[chooseEngine(patterns, patternCount)]);
+        for (int i = 0; i < matchCount; i++) {
+            printf("패턴 ID %d 발견, 시작 인덱스 %d\n", matches[i].patternId, matches[i].start);
+        }
+    }
+    free(matches);
+
+    int count = argc > 1 ? atoi(argv[1]) : 64;
+    benchmark(8, 4, 8);
+    benchmark(count, 3, 10);
+    benchmark(count, 16, 24);
+    return 0;
+}
+
+#endif /* TEDDY_LIBRARY */
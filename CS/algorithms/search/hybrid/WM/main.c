@@ -18,6 +18,8 @@
  *       }
  *       free(matches);
  *   }
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define WU_MANBER_LIBRARY 후 #include "main.c" (데모 main 제외)
  */
 
 #include <stdio.h>
@@ -28,11 +30,14 @@
 #define BLOCK_SIZE 2
 #define SHIFT_SIZE 65536  // 256^2
 
-/* Occurrence 구조체: 매칭 결과 저장 */
+/* Occurrence 구조체: 매칭 결과 저장 (다른 검색 엔진과 함께 포함될 때 한 번만 정의) */
+#ifndef SEARCH_OCCURRENCE_DEFINED
+#define SEARCH_OCCURRENCE_DEFINED
 typedef struct {
     int patternId; // 매칭된 패턴의 인덱스
     int start;     // 텍스트 내 매칭 시작 인덱스 (0 기반)
 } Occurrence;
+#endif
 
 /* CandidateList 구조체: 특정 블록 해시 값에 대응하는 패턴 인덱스 목록 */
 typedef struct {
@@ -83,19 +88,19 @@ static void preprocess_patterns(const char **patterns, int patternCount,
     }
     // 각 패턴에 대해 SHIFT 테이블 업데이트, HASH 테이블 및 prefixes 계산
     for (i = 0; i < patternCount; i++) {
-        int len = (int)strlen(patterns[i]);
         // prefixes: 패턴의 첫 BLOCK_SIZE 문자 해시 계산
         prefixes[i] = block_hash(patterns[i]);
-        // SHIFT 테이블: 패턴의 각 가능한 블록(길이 BLOCK_SIZE)에 대해 이동 값 업데이트
-        for (j = 0; j <= len - BLOCK_SIZE; j++) {
+        // SHIFT 테이블: 패턴의 앞 minLen 문자 안의 각 블록(길이 BLOCK_SIZE)에 대해 이동 값 업데이트
+        // (길이가 다른 패턴이 섞여 있어도 검색 창은 minLen이므로, 그 뒤의 블록으로 이동 값을 정하면 매칭을 건너뜀)
+        for (j = 0; j <= *minLen - BLOCK_SIZE; j++) {
             int hashVal = block_hash(patterns[i] + j);
-            int shiftCandidate = len - j - BLOCK_SIZE;
+            int shiftCandidate = *minLen - j - BLOCK_SIZE;
             if (shiftCandidate < shiftTable[hashVal]) {
                 shiftTable[hashVal] = shiftCandidate;
             }
         }
-        // HASH 테이블: 패턴의 마지막 BLOCK_SIZE 문자 블록을 기준으로 후보 추가
-        int endBlockHash = block_hash(patterns[i] + (len - BLOCK_SIZE));
+        // HASH 테이블: 패턴의 앞 minLen 문자 중 마지막 블록을 기준으로 후보 추가
+        int endBlockHash = block_hash(patterns[i] + (*minLen - BLOCK_SIZE));
         CandidateList *clist = &hashTable[endBlockHash];
         if (clist->count == clist->capacity) {
             int newCapacity = (clist->capacity == 0) ? 2 : clist->capacity * 2;
@@ -177,7 +182,7 @@ Occurrence* wu_manber_search(const char **patterns, int patternCount,
     
     // 검색: 텍스트를 BLOCK_SIZE 단위로 스캔하며 후보 패턴 검증
     int s = minLen - BLOCK_SIZE; // 초기 스캔 위치: 최소 패턴의 끝 블록 정렬
-    while (s <= n - minLen) {
+    while (s <= n - BLOCK_SIZE) {
         int hashVal = block_hash(text + s);
         int shift = shiftTable[hashVal];
         if (shift > 0) {
@@ -188,8 +193,8 @@ Occurrence* wu_manber_search(const char **patterns, int patternCount,
             for (i = 0; i < clist.count; i++) {
                 int patId = clist.indices[i];
                 int patLen = (int)strlen(patterns[patId]);
-                // 추정되는 매칭 시작 위치: s - (patLen - BLOCK_SIZE)
-                int pos = s - (patLen - BLOCK_SIZE);
+                // 추정되는 매칭 시작 위치: s - (minLen - BLOCK_SIZE)
+                int pos = s - (minLen - BLOCK_SIZE);
                 if (pos < 0 || pos + patLen > n)
                     continue;
                 // 후보 패턴과 텍스트의 해당 위치 비교
@@ -227,6 +232,7 @@ Occurrence* wu_manber_search(const char **patterns, int patternCount,
     return occurrences;
 }
 
+#ifndef WU_MANBER_LIBRARY
 /* main 함수: Wu-Manber 알고리즘 데모 */
 int main(void) {
     const char *patterns[] = {"pattern", "search", "example"};
@@ -246,4 +252,5 @@ int main(void) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+#endif /* WU_MANBER_LIBRARY */
@@ -0,0 +1,547 @@
+/**
+ * parallel_search.c
+ *
+ * 문자열 검색 엔진 공용 병렬 드라이버: 큰 텍스트를 청크로 나누어 여러 스레드에서 검색
+ * - 텍스트를 PARALLEL_CHUNK_SIZE 크기의 청크로 나누고, 각 청크 뒤에 (패턴 길이 - 1)바이트를 겹쳐 붙여 검색합니다.
+ *   다중 패턴이면 가장 긴 패턴 길이 - 1만큼 겹칩니다. 청크 경계에 걸친 매칭도 겹친 부분 덕분에 찾을 수 있습니다.
+ * - 중복 제거: 각 청크는 자기 구간(겹친 부분 제외) 안에서 "시작하는" 매칭만 보고합니다.
+ *   겹친 부분에서 시작하는 매칭은 다음 청크의 몫이므로, 모든 매칭이 정확히 한 번 보고됩니다.
+ * - 병합: 청크별 결과를 청크 순서대로 이어 붙이므로 결과는 시작 위치 순으로 정렬됩니다.
+ *   (다중 패턴 엔진은 끝 위치 순으로 보고할 수 있으므로 청크 안에서 (시작 위치, 패턴 ID) 순으로 정렬합니다.)
+ * - 스레드 풀: OpenMP 스레드 팀이 청크를 동적 스케줄링(schedule(dynamic))으로 나눠 가집니다.
+ *   매칭이 몰린 청크가 있어도 먼저 끝난 스레드가 남은 청크를 가져갑니다.
+ * - 엔진: 어댑터가 청크를 (text, textLen)으로 받으므로 텍스트 안에 NUL 바이트가 있어도 됩니다.
+ *   다중 패턴은 ac_search_bytes처럼 길이를 받는 엔진을 그대로 씁니다. 단일 패턴 엔진(kmp_search, boyer_moore_search,
+ *   rabinKarpSearch 등)은 NUL로 끝나는 문자열을 받으므로 search_cstring_segments로 NUL 사이 구간마다 검색합니다.
+ *   (패턴에는 NUL이 없으므로 NUL에 걸친 매칭은 없습니다.) 엔진은 int 인덱스를 쓰지만 청크 안의 위치만 보고하므로,
+ *   결과 위치를 텍스트 전체 기준(size_t / uint64_t)으로 바꾸면 2GB가 넘는 텍스트도 검색할 수 있습니다.
+ * - 파일: parallel_search_file은 파일을 PARALLEL_FILE_BLOCK 단위로 읽어, 블록마다 청크 병렬 검색을 합니다.
+ *   블록 사이에는 앞 블록의 마지막 (겹침)바이트를 다음 블록 앞에 붙여 경계 매칭을 찾습니다. 메모리 사용량은 파일 크기와 무관합니다.
+ *
+ * 사용 예:
+ *   // 단일 패턴: NUL로 끝나는 문자열을 받는 엔진은 search_cstring_segments로 감싼 어댑터를 넘김
+ *   static int *bmChunk(const char *text, size_t textLen, const char *pattern, int *matchCount) {
+ *       return search_cstring_segments(boyer_moore_search, text, textLen, pattern, matchCount);
+ *   }
+ *   ParallelSearchJob job = single_pattern_job("ERROR", bmChunk);
+ *   size_t matchCount = 0;
+ *   ParallelMatch *matches = parallel_search(&job, text, textLen, &matchCount);
+ *   for (size_t i = 0; i < matchCount; i++)
+ *       printf("패턴 발견 위치: %llu\n", (unsigned long long)matches[i].start);
+ *   free(matches);
+ *
+ *   // 다중 패턴: 엔진 객체를 받는 어댑터를 만들어 넘김
+ *   static Occurrence *acChunk(const char *text, size_t textLen, void *engine, int *matchCount) {
+ *       return ac_search_bytes((const ACAutomaton *)engine, (const unsigned char *)text, textLen, matchCount);
+ *   }
+ *   ParallelSearchJob job = multi_pattern_job(acChunk, ac, maxPatternLength);
+ *   ParallelMatch *matches = parallel_search_file(&job, "access.log", &matchCount);
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define PARALLEL_SEARCH_LIBRARY 후 #include "parallel_search.c" (엔진과 데모 main 제외)
+ * 컴파일 예시: gcc -O2 -march=native -fopenmp parallel_search.c -o parallel_search
+ * 실행 예시: ./parallel_search 256   (256MB 로그 텍스트에서 엔진별 단일 스레드 / 병렬 검색 비교)
+ *           ./parallel_search -f access.log ERROR timeout   (파일을 블록 단위로 읽으며 병렬 검색)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <omp.h>
+
+// 포함하기 전에 정의하여 바꿀 수 있음
+#ifndef PARALLEL_CHUNK_SIZE
+#define PARALLEL_CHUNK_SIZE ((size_t)4 << 20)    // 청크 하나가 맡는 텍스트 크기 (겹침 제외)
+#endif
+#ifndef PARALLEL_FILE_BLOCK
+#define PARALLEL_FILE_BLOCK ((size_t)256 << 20)  // parallel_search_file이 한 번에 읽는 크기
+#endif
+
+// 검색 결과를 저장하는 구조체 (다른 검색 엔진과 함께 포함될 때 한 번만 정의)
+#ifndef SEARCH_OCCURRENCE_DEFINED
+#define SEARCH_OCCURRENCE_DEFINED
+typedef struct {
+    int patternId; // 매칭된 패턴의 ID
+    int start;     // 텍스트에서 패턴이 시작하는 인덱스 (0 기반)
+} Occurrence;
+#endif
+
+// 단일 패턴 엔진 어댑터: text[0..textLen)을 검색 (NUL 포함 가능, 드라이버가 text[textLen] = NUL을 보장)
+typedef int *(*SingleSearchFunc)(const char *text, size_t textLen, const char *pattern, int *matchCount);
+// 다중 패턴 엔진 어댑터: engine은 미리 만든 자동자/트라이 등 (여러 스레드가 동시에 읽으므로 검색 중 수정 금지)
+typedef Occurrence *(*MultiSearchFunc)(const char *text, size_t textLen, void *engine, int *matchCount);
+// NUL로 끝나는 문자열을 받는 단일 패턴 엔진: kmp_search, boyer_moore_search, rabinKarpSearch, hybrid_pattern_search 등
+typedef int *(*CStringSearchFunc)(const char *text, const char *pattern, int *matchCount);
+
+/* 병렬 검색 작업: 어떤 엔진으로 무엇을 찾을지와 청크 사이 겹침 크기 */
+typedef struct {
+    SingleSearchFunc single;   // 단일 패턴 엔진 어댑터 (NULL이면 multi 사용)
+    const char *pattern;       // 단일 패턴
+    MultiSearchFunc multi;     // 다중 패턴 엔진 어댑터
+    void *engine;              // 어댑터에 넘길 엔진 객체
+    size_t overlap;            // 청크 뒤에 겹쳐 붙이는 바이트 수 (가장 긴 패턴 길이 - 1)
+    size_t minLength;          // 이보다 짧은 청크는 매칭이 있을 수 없으므로 건너뜀
+} ParallelSearchJob;
+
+/* 병렬 검색 결과: 텍스트(또는 파일) 전체 기준 위치 */
+typedef struct {
+    int patternId;     // 매칭된 패턴의 ID (단일 패턴이면 0)
+    uint64_t start;    // 패턴이 시작하는 위치 (0 기반)
+} ParallelMatch;
+
+/* 청크 하나의 결과 */
+typedef struct {
+    ParallelMatch *matches;
+    size_t count;
+} ChunkResult;
+
+static void *parallelAlloc(size_t bytes, const char *what) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        fprintf(stderr, "메모리 할당 실패: %s\n", what);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// 단일 패턴 작업 생성: 겹침은 패턴 길이 - 1
+ParallelSearchJob single_pattern_job(const char *pattern, SingleSearchFunc search) {
+    ParallelSearchJob job = {0};
+    size_t m = strlen(pattern);
+    job.single = search;
+    job.pattern = pattern;
+    job.overlap = m > 0 ? m - 1 : 0;
+    job.minLength = m;
+    return job;
+}
+
+// 다중 패턴 작업 생성: 겹침은 가장 긴 패턴 길이 - 1
+ParallelSearchJob multi_pattern_job(MultiSearchFunc search, void *engine, int maxPatternLength) {
+    ParallelSearchJob job = {0};
+    job.multi = search;
+    job.engine = engine;
+    job.overlap = maxPatternLength > 0 ? (size_t)maxPatternLength - 1 : 0;
+    job.minLength = 1;
+    return job;
+}
+
+/*
+ * search_cstring_segments
+ *
+ * NUL로 끝나는 문자열을 받는 엔진으로 text[0..textLen)을 검색합니다. (text[textLen]은 NUL이어야 함)
+ * 텍스트를 NUL 바이트로 나눈 구간마다 엔진을 호출하고 위치를 text 기준으로 옮깁니다.
+ * 패턴에는 NUL이 없으므로 NUL에 걸친 매칭은 없고, 결과는 시작 위치 순입니다.
+ * 반환: 위치 배열 (동적 할당, 매칭이 없으면 NULL일 수 있음), 엔진이 실패하면 NULL (*matchCount = -1)
+ */
+int *search_cstring_segments(CStringSearchFunc search, const char *text, size_t textLen, const char *pattern,
+                             int *matchCount) {
+    size_t m = strlen(pattern);
+    int *positions = NULL;
+    int total = 0;
+    size_t begin = 0;
+    while (begin < textLen) {
+        const char *nul = (const char *)memchr(text + begin, '\0', textLen - begin);
+        size_t end = nul ? (size_t)(nul - text) : textLen;
+        if (end - begin >= m) {
+            int count = 0;
+            int *found = search(text + begin, pattern, &count);
+            if (count < 0) {
+                free(found);
+                free(positions);
+                *matchCount = -1;
+                return NULL;
+            }
+            if (count > 0 && begin == 0 && end == textLen) {
+                positions = found;   // NUL이 없는 흔한 경우: 엔진 결과를 그대로 반환
+                total = count;
+                break;
+            }
+            if (count > 0) {
+                int *grown = (int *)realloc(positions, ((size_t)total + (size_t)count) * sizeof(int));
+                if (!grown) {
+                    fprintf(stderr, "결과 배열 재할당 실패 (search_cstring_segments)\n");
+                    exit(EXIT_FAILURE);
+                }
+                positions = grown;
+                for (int i = 0; i < count; i++)
+                    positions[total + i] = found[i] + (int)begin;
+                total += count;
+            }
+            free(found);
+        }
+        begin = end + 1;
+    }
+    *matchCount = total;
+    return positions;
+}
+
+static int compareParallelMatch(const void *a, const void *b) {
+    const ParallelMatch *x = (const ParallelMatch *)a, *y = (const ParallelMatch *)b;
+    if (x->start != y->start)
+        return x->start < y->start ? -1 : 1;
+    return (x->patternId > y->patternId) - (x->patternId < y->patternId);
+}
+
+/*
+ * searchChunk
+ *
+ * buffer[0..length) (length = owned + 겹침, buffer[length]는 NUL)를 엔진으로 검색하여, 시작 위치가 owned 미만인 매칭만
+ * base를 더한 전체 기준 위치로 돌려줍니다.
+ */
+static ChunkResult searchChunk(const ParallelSearchJob *job, const char *buffer, size_t length, size_t owned,
+                               uint64_t base) {
+    ChunkResult r = {NULL, 0};
+    int count = 0;
+    if (job->single) {
+        int *positions = job->single(buffer, length, job->pattern, &count);
+        if (count < 0) {
+            fprintf(stderr, "청크 검색 실패 (위치 %llu)\n", (unsigned long long)base);
+            exit(EXIT_FAILURE);
+        }
+        if (count > 0) {
+            r.matches = (ParallelMatch *)parallelAlloc((size_t)count * sizeof(ParallelMatch), "청크 결과");
+            for (int i = 0; i < count; i++) {
+                if ((size_t)positions[i] >= owned)
+                    break;   // 단일 패턴 엔진은 시작 위치 순으로 보고함
+                r.matches[r.count].patternId = 0;
+                r.matches[r.count].start = base + (uint64_t)positions[i];
+                r.count++;
+            }
+        }
+        free(positions);
+    } else {
+        Occurrence *occ = job->multi(buffer, length, job->engine, &count);
+        if (count < 0) {
+            fprintf(stderr, "청크 검색 실패 (위치 %llu)\n", (unsigned long long)base);
+            exit(EXIT_FAILURE);
+        }
+        if (count > 0) {
+            r.matches = (ParallelMatch *)parallelAlloc((size_t)count * sizeof(ParallelMatch), "청크 결과");
+            for (int i = 0; i < count; i++) {
+                if ((size_t)occ[i].start >= owned)
+                    continue;
+                r.matches[r.count].patternId = occ[i].patternId;
+                r.matches[r.count].start = base + (uint64_t)occ[i].start;
+                r.count++;
+            }
+            // 엔진마다 보고 순서가 다르므로 (시작 위치, 패턴 ID) 순으로 정렬하고 같은 매칭은 하나만 남김
+            qsort(r.matches, r.count, sizeof(ParallelMatch), compareParallelMatch);
+            size_t unique = 0;
+            for (size_t i = 0; i < r.count; i++)
+                if (unique == 0 || compareParallelMatch(&r.matches[unique - 1], &r.matches[i]) != 0)
+                    r.matches[unique++] = r.matches[i];
+            r.count = unique;
+        }
+        free(occ);
+    }
+    return r;
+}
+
+/*
+ * searchBlock
+ *
+ * text[0..n)에서 시작 위치가 owned 미만인 매칭을 청크 병렬로 찾아, 결과를 out 뒤에 순서대로 덧붙입니다.
+ * (청크는 [0, owned)를 나누어 맡고, 겹침은 n까지 읽음. 위치에는 base를 더함)
+ * 반환: 덧붙인 뒤의 배열 (realloc될 수 있음), *outCount 갱신
+ */
+static ParallelMatch *searchBlock(const ParallelSearchJob *job, const char *text, size_t n, size_t owned,
+                                  uint64_t base, ParallelMatch *out, size_t *outCount) {
+    if (owned == 0 || n < job->minLength)
+        return out;
+    size_t chunkCount = (owned + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    ChunkResult *results = (ChunkResult *)parallelAlloc(chunkCount * sizeof(ChunkResult), "청크 결과 목록");
+
+    #pragma omp parallel if(chunkCount > 1)
+    {
+        // 스레드마다 청크 + 겹침 + NUL 크기의 버퍼를 한 번만 할당
+        char *buffer = (char *)parallelAlloc(PARALLEL_CHUNK_SIZE + job->overlap + 1, "청크 버퍼");
+        #pragma omp for schedule(dynamic)
+        for (size_t c = 0; c < chunkCount; c++) {
+            size_t begin = c * PARALLEL_CHUNK_SIZE;
+            size_t chunkOwned = owned - begin < PARALLEL_CHUNK_SIZE ? owned - begin : PARALLEL_CHUNK_SIZE;
+            size_t length = chunkOwned + job->overlap;
+            if (length > n - begin)
+                length = n - begin;
+            if (length < job->minLength) {
+                results[c].matches = NULL;
+                results[c].count = 0;
+                continue;
+            }
+            memcpy(buffer, text + begin, length);
+            buffer[length] = '\0';
+            results[c] = searchChunk(job, buffer, length, chunkOwned, base + begin);
+        }
+        free(buffer);
+    }
+
+    // 청크 순서대로 이어 붙임
+    size_t total = *outCount;
+    for (size_t c = 0; c < chunkCount; c++)
+        total += results[c].count;
+    if (total > *outCount) {
+        ParallelMatch *grown = (ParallelMatch *)realloc(out, total * sizeof(ParallelMatch));
+        if (!grown) {
+            fprintf(stderr, "결과 배열 재할당 실패 (searchBlock)\n");
+            exit(EXIT_FAILURE);
+        }
+        out = grown;
+    }
+    for (size_t c = 0; c < chunkCount; c++) {
+        if (results[c].count > 0)
+            memcpy(out + *outCount, results[c].matches, results[c].count * sizeof(ParallelMatch));
+        *outCount += results[c].count;
+        free(results[c].matches);
+    }
+    free(results);
+    return out;
+}
+
+/*
+ * parallel_search
+ *
+ * 메모리에 있는 텍스트 text[0..n)을 청크 병렬로 검색합니다.
+ * 반환: 시작 위치 순으로 정렬된 ParallelMatch 배열 (동적 할당, 매칭이 없어도 NULL이 아님, 호출자가 free()로 해제)
+ *       인자가 잘못되었으면(빈 패턴 등) NULL
+ */
+ParallelMatch *parallel_search(const ParallelSearchJob *job, const char *text, size_t n, size_t *matchCount) {
+    *matchCount = 0;
+    if (!job || !text || (!job->single && !job->multi) || (job->single && (!job->pattern || job->minLength == 0)))
+        return NULL;
+    ParallelMatch *out = (ParallelMatch *)parallelAlloc(sizeof(ParallelMatch), "결과 배열");
+    return searchBlock(job, text, n, n, 0, out, matchCount);
+}
+
+/*
+ * parallel_search_file
+ *
+ * 파일을 PARALLEL_FILE_BLOCK 단위로 읽으며 블록마다 청크 병렬 검색을 합니다.
+ * 각 블록의 마지막 overlap바이트는 다음 블록 앞에 다시 붙이므로, 그 구간에서 시작하는 매칭은 다음 블록이 보고합니다.
+ * (블록 경계에 걸친 매칭을 찾고, 겹친 구간 안에 들어가는 짧은 패턴의 매칭도 한 번만 보고함)
+ * 반환: 파일 전체 기준 위치 순으로 정렬된 ParallelMatch 배열 (매칭이 없어도 NULL이 아님),
+ *       인자가 잘못되었거나 파일을 열거나 읽지 못하면 NULL (*matchCount = 0)
+ */
+ParallelMatch *parallel_search_file(const ParallelSearchJob *job, const char *path, size_t *matchCount) {
+    *matchCount = 0;
+    if (!job || !path || (!job->single && !job->multi) || (job->single && (!job->pattern || job->minLength == 0)))
+        return NULL;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return NULL;
+    }
+    char *block = (char *)parallelAlloc(job->overlap + PARALLEL_FILE_BLOCK, "파일 블록");
+    ParallelMatch *out = (ParallelMatch *)parallelAlloc(sizeof(ParallelMatch), "결과 배열");
+    size_t carry = 0;        // 블록 앞에 남겨 둔 앞 블록의 끝부분 길이
+    uint64_t base = 0;       // block[0]의 파일 내 위치
+    size_t bytesRead;
+    while ((bytesRead = fread(block + carry, 1, PARALLEL_FILE_BLOCK, fp)) > 0) {
+        size_t length = carry + bytesRead;
+        carry = length < job->overlap ? length : job->overlap;
+        out = searchBlock(job, block, length, length - carry, base, out, matchCount);
+        memmove(block, block + length - carry, carry);
+        base += length - carry;
+    }
+    // 파일 끝: 마지막으로 남겨 둔 구간에서 시작하는 매칭
+    out = searchBlock(job, block, carry, carry, base, out, matchCount);
+    if (ferror(fp)) {
+        perror(path);
+        free(out);
+        out = NULL;
+        *matchCount = 0;
+    }
+    fclose(fp);
+    free(block);
+    return out;
+}
+
+#ifndef PARALLEL_SEARCH_LIBRARY
+/* 데모와 벤치마크: 단일 패턴 엔진들(HPM이 포함), 라빈-카프, Aho-Corasick을 병렬 드라이버로 실행 */
+
+#define HYBRID_PATTERN_LIBRARY
+#include "hybrid/HPM/main.c"
+#define RABIN_KARP_LIBRARY
+#include "RabinKarp/main.c"
+#define AHO_CORASICK_LIBRARY
+#include "AhoCorasick/main.c"
+
+// 단일 패턴 어댑터: NUL로 끝나는 문자열을 받는 엔진을 NUL 사이 구간마다 호출
+static int *rabinKarpChunkSearch(const char *text, size_t textLen, const char *pattern, int *matchCount) {
+    return search_cstring_segments(rabinKarpSearch, text, textLen, pattern, matchCount);
+}
+
+static int *kmpChunkSearch(const char *text, size_t textLen, const char *pattern, int *matchCount) {
+    return search_cstring_segments(kmp_search, text, textLen, pattern, matchCount);
+}
+
+static int *boyerMooreChunkSearch(const char *text, size_t textLen, const char *pattern, int *matchCount) {
+    return search_cstring_segments(boyer_moore_search, text, textLen, pattern, matchCount);
+}
+
+static int *hybridChunkSearch(const char *text, size_t textLen, const char *pattern, int *matchCount) {
+    return search_cstring_segments(hybrid_pattern_search, text, textLen, pattern, matchCount);
+}
+
+// Aho-Corasick 어댑터: 컴파일된 자동자를 여러 스레드가 공유 (검색은 읽기만 함), 바이트열 검색이라 NUL도 그대로 처리
+static Occurrence *acChunkSearch(const char *text, size_t textLen, void *engine, int *matchCount) {
+    return ac_search_bytes((const ACAutomaton *)engine, (const unsigned char *)text, textLen, matchCount);
+}
+
+// 벤치마크용 로그 텍스트 생성: INFO 줄이 대부분이고 가끔 WARN/ERROR 줄이 섞임
+static char *makeParallelLogText(size_t size) {
+    char *text = (char *)parallelAlloc(size + 1, "텍스트");
+    uint64_t state = 88172645463325252ULL;
+    size_t len = 0;
+    char line[160];
+    while (len < size) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        unsigned r = (unsigned)(state >> 32);
+        int lineLen;
+        if (r % 1000 == 0)
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u ERROR connection refused by upstream host\n",
+                               r % 60, (r >> 8) % 60);
+        else if (r % 100 == 1)
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u WARN slow response (timeout=%us)\n",
+                               r % 60, (r >> 8) % 60, (r >> 12) % 60);
+        else
+            lineLen = snprintf(line, sizeof(line), "2024-05-01 12:%02u:%02u INFO request id=%u status=200 took %ums\n",
+                               r % 60, (r >> 8) % 60, r >> 8, (r >> 4) % 500);
+        if (len + (size_t)lineLen > size)
+            lineLen = (int)(size - len);
+        memcpy(text + len, line, (size_t)lineLen);
+        len += (size_t)lineLen;
+    }
+    text[size] = '\0';
+    return text;
+}
+
+// 같은 작업을 스레드 1개와 최대 스레드로 실행해 시간과 결과를 비교
+static void benchmarkJob(const char *name, const ParallelSearchJob *job, const char *text, size_t n) {
+    int maxThreads = omp_get_max_threads();
+    size_t counts[2];
+    ParallelMatch *results[2];
+    double seconds[2];
+    for (int run = 0; run < 2; run++) {
+        omp_set_num_threads(run == 0 ? 1 : maxThreads);
+        double start = omp_get_wtime();
+        results[run] = parallel_search(job, text, n, &counts[run]);
+        seconds[run] = omp_get_wtime() - start;
+    }
+    omp_set_num_threads(maxThreads);
+    int same = counts[0] == counts[1];
+    for (size_t i = 0; same && i < counts[0]; i++)
+        same = compareParallelMatch(&results[0][i], &results[1][i]) == 0;
+    printf("  %-22s 스레드 1개 %.3f초, %d개 %.3f초 (%.1f배), 매칭 %zu개%s\n", name, seconds[0], maxThreads,
+           seconds[1], seconds[0] / seconds[1], counts[1], same ? "" : " (결과 불일치!)");
+    free(results[0]);
+    free(results[1]);
+}
+
+static void benchmark(int megabytes) {
+    size_t n = (size_t)megabytes << 20;
+    char *text = makeParallelLogText(n);
+    printf("\n%dMB 로그 텍스트, 청크 %zuMB (스레드 최대 %d개):\n", megabytes, PARALLEL_CHUNK_SIZE >> 20,
+           omp_get_max_threads());
+
+    static const struct { const char *name; SingleSearchFunc search; } engines[] = {
+        {"rabinKarpSearch", rabinKarpChunkSearch}, {"kmp_search", kmpChunkSearch},
+        {"boyer_moore_search", boyerMooreChunkSearch}, {"hybrid_pattern_search", hybridChunkSearch},
+    };
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        ParallelSearchJob job = single_pattern_job("timeout=42s", engines[e].search);
+        benchmarkJob(engines[e].name, &job, text, n);
+    }
+
+    const char *patterns[] = {"ERROR", "timeout=42s", "refused", "id=12345"};
+    int patternCount = (int)(sizeof(patterns) / sizeof(patterns[0]));
+    int maxLength = 0;
+    Trie *trie = createTrie();
+    for (int i = 0; i < patternCount; i++) {
+        insertPattern(trie, patterns[i], i);
+        if ((int)strlen(patterns[i]) > maxLength)
+            maxLength = (int)strlen(patterns[i]);
+    }
+    ACAutomaton *ac = compileAutomaton(trie, AC_MODE_AUTO);
+    freeTrie(trie);
+    ParallelSearchJob job = multi_pattern_job(acChunkSearch, ac, maxLength);
+    benchmarkJob("ac_search_bytes (패턴 4개)", &job, text, n);
+    freeAutomaton(ac);
+    free(text);
+}
+
+// 파일 검색: 패턴이 하나면 hybrid_pattern_search, 여러 개면 Aho-Corasick
+static int searchFile(const char *path, char **patterns, int patternCount) {
+    ParallelSearchJob job;
+    ACAutomaton *ac = NULL;
+    if (patternCount == 1) {
+        job = single_pattern_job(patterns[0], hybridChunkSearch);
+    } else {
+        int maxLength = 0;
+        Trie *trie = createTrie();
+        for (int i = 0; i < patternCount; i++) {
+            insertPattern(trie, patterns[i], i);
+            if ((int)strlen(patterns[i]) > maxLength)
+                maxLength = (int)strlen(patterns[i]);
+        }
+        ac = compileAutomaton(trie, AC_MODE_AUTO);
+        freeTrie(trie);
+        job = multi_pattern_job(acChunkSearch, ac, maxLength);
+    }
+
+    double start = omp_get_wtime();
+    size_t matchCount = 0;
+    ParallelMatch *matches = parallel_search_file(&job, path, &matchCount);
+    double elapsed = omp_get_wtime() - start;
+    if (ac)
+        freeAutomaton(ac);
+    if (!matches)
+        return EXIT_FAILURE;
+
+    uint64_t *counts = (uint64_t *)calloc((size_t)patternCount, sizeof(uint64_t));
+    if (!counts) {
+        fprintf(stderr, "메모리 할당 실패: counts\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < matchCount; i++)
+        counts[matches[i].patternId]++;
+    printf("%s (%.3f초, 스레드 %d개):\n", path, elapsed, omp_get_max_threads());
+    for (int i = 0; i < patternCount; i++)
+        printf("  \"%s\": %llu회\n", patterns[i], (unsigned long long)counts[i]);
+    if (matchCount > 0)
+        printf("  첫 매칭 위치: %llu\n", (unsigned long long)matches[0].start);
+    free(counts);
+    free(matches);
+    return EXIT_SUCCESS;
+}
+
+// main 함수: 병렬 청크 검색 데모
+int main(int argc, char *argv[]) {
+    if (argc > 3 && strcmp(argv[1], "-f") == 0)
+        return searchFile(argv[2], argv + 3, argc - 3);
+
+    // 청크 경계에 걸친 매칭: 청크 크기 바로 앞에 패턴을 놓아도 한 번만 보고됨
+    // 텍스트 중간의 NUL 바이트도 매칭을 가리지 않음
+    size_t n = PARALLEL_CHUNK_SIZE * 3 + 100;
+    char *text = (char *)parallelAlloc(n + 1, "텍스트");
+    memset(text, '.', n);
+    text[n] = '\0';
+    const char *pattern = "boundary";
+    size_t places[] = {0, PARALLEL_CHUNK_SIZE - 3, PARALLEL_CHUNK_SIZE * 2 - 7, n - 8};
+    for (size_t i = 0; i < sizeof(places) / sizeof(places[0]); i++)
+        memcpy(text + places[i], pattern, strlen(pattern));
+    text[PARALLEL_CHUNK_SIZE - 4] = '\0';
+
+    ParallelSearchJob job = single_pattern_job(pattern, kmpChunkSearch);
+    size_t matchCount = 0;
+    ParallelMatch *matches = parallel_search(&job, text, n, &matchCount);
+    printf("패턴 \"%s\" (청크 %zu바이트, 겹침 %zu바이트) 발견 위치:\n", pattern, PARALLEL_CHUNK_SIZE, job.overlap);
+    for (size_t i = 0; i < matchCount; i++)
+        printf("  %llu\n", (unsigned long long)matches[i].start);
+    free(matches);
+    free(text);
+
+    benchmark(argc > 1 ? atoi(argv[1]) : 256);
+    return 0;
+}
+#endif /* PARALLEL_SEARCH_LIBRARY */
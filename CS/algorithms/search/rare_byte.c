@@ -0,0 +1,169 @@
+/**
+ * rare_byte.c
+ *
+ * 단일 패턴 검색용 공용 SIMD 전처리(front-end): 드문 바이트 후보 찾기
+ * - 패턴에서 가장 드문 바이트 두 개(바이트 빈도표 기준)와 그 위치를 고릅니다.
+ * - 텍스트를 32바이트(AVX2) 또는 16바이트(SSE2)씩 읽어, 두 바이트가 모두 제자리에 있는 시작 위치만 후보로 돌려줍니다.
+ *   (memchr처럼 한 바이트만 보는 것보다 거짓 후보가 훨씬 적음)
+ * - KMP, Boyer-Moore, Z, Two-Way, SBOM 구현이 이 파일을 포함하여, 부분 일치 정보가 없을 때 다음 후보 위치로 바로 건너뜁니다.
+ *   각 알고리즘은 후보 위치에서만 원래 방식으로 검증하므로 결과는 그대로입니다.
+ * - 패턴의 가장 드문 바이트도 흔한 바이트(공백, 'e' 등)이면 후보가 너무 많아 손해이므로 useful = 0으로 두고 쓰지 않습니다.
+ *
+ * 바이트 빈도표:
+ * - 영어 문장, 소스 코드, 로그를 기준으로 한 대략적인 순위(0: 드묾 ~ 255: 흔함)입니다.
+ * - 한글 UTF-8 본문에서 흔한 선두 바이트(0xEA~0xED)와 후속 바이트(0x80~0xBF)도 중간 정도로 둡니다.
+ *
+ * 사용 예:
+ *   RareBytePrefilter rb;
+ *   rare_byte_init(&rb, pattern, m);
+ *   int s = 0;
+ *   while ((s = rare_byte_find(&rb, text, s, n - m)) >= 0) {
+ *       if (memcmp(text + s, pattern, m) == 0)
+ *           printf("패턴 발견 위치: %d\n", s);
+ *       s++;
+ *   }
+ *
+ * 다른 파일에서 라이브러리로 쓸 때: #define RARE_BYTE_LIBRARY 후 #include "rare_byte.c" (데모 main 제외)
+ * 컴파일 예시: gcc -O2 -march=native rare_byte.c -o rare_byte
+ */
+
+#ifndef RARE_BYTE_C
+#define RARE_BYTE_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define RARE_BYTE_MAX_RANK 240   // 가장 드문 바이트의 순위가 이보다 높으면(흔하면) 전처리를 쓰지 않음
+
+// 0이면 모든 검색에서 전처리를 끔 (벤치마크에서 전처리 유무 비교용)
+static int rareBytePrefilterEnabled = 1;
+
+// 바이트별 대략적인 출현 빈도 순위 (0: 드묾 ~ 255: 흔함)
+static const uint8_t rareByteRank[256] = {
+     20,   8,   8,   8,   8,   8,   8,   8,   8, 170, 215,   8,   8, 120,   8,   8,  // 0x00
+      8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,  // 0x10
+    255, 110, 175, 115, 100, 105, 105, 150, 160, 160, 115, 120, 185, 190, 200, 175,  // 0x20
+    205, 202, 199, 196, 193, 190, 187, 184, 181, 178, 190, 150, 120, 170, 125, 105,  // 0x30
+    100, 174, 123, 147, 150, 180, 138, 132, 156, 168, 111, 117, 153, 141, 165, 171,  // 0x40
+    135, 108, 159, 162, 177, 144, 120, 129, 114, 126, 105, 140,  95, 140,  70, 165,  // 0x50
+     60, 238, 136, 184, 190, 250, 166, 154, 202, 226, 106, 122, 196, 172, 220, 232,  // 0x60
+    160,  98, 208, 214, 244, 178, 130, 148, 114, 142,  90, 125, 100, 125,  65,   4,  // 0x70
+     60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  // 0x80
+     60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  // 0x90
+     60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  // 0xA0
+     60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  // 0xB0
+      2,   2,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  // 0xC0
+     30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  // 0xD0
+     30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  70,  70,  70,  70,  30,  30,  // 0xE0
+     30,  30,  30,  30,  30,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,  // 0xF0
+};
+
+/* 드문 바이트 전처리 정보 */
+typedef struct {
+    int offset1, offset2;          // 패턴 안에서 가장 드문 바이트와 두 번째로 드문 바이트의 위치 (m == 1이면 같음)
+    unsigned char byte1, byte2;    // 그 위치의 바이트
+    int useful;                    // 0이면 후보가 너무 많을 것으로 보고 전처리를 쓰지 않음
+} RareBytePrefilter;
+
+/*
+ * rare_byte_init
+ *
+ * 패턴(길이 m >= 1)에서 빈도표 기준으로 가장 드문 바이트 두 개를 고릅니다.
+ * 두 번째 바이트는 가능하면 첫 번째와 다른 값으로 골라 거짓 후보를 줄입니다.
+ */
+void rare_byte_init(RareBytePrefilter *rb, const char *pattern, int m) {
+    const unsigned char *p = (const unsigned char *)pattern;
+    int first = 0;
+    for (int i = 1; i < m; i++)
+        if (rareByteRank[p[i]] < rareByteRank[p[first]])
+            first = i;
+    int second = -1;
+    for (int i = 0; i < m; i++) {
+        if (i == first)
+            continue;
+        if (second < 0) {
+            second = i;
+            continue;
+        }
+        // 첫 번째와 다른 바이트를 우선, 같은 조건이면 더 드문 바이트
+        int diffI = p[i] != p[first], diffS = p[second] != p[first];
+        if (diffI > diffS || (diffI == diffS && rareByteRank[p[i]] < rareByteRank[p[second]]))
+            second = i;
+    }
+    if (second < 0)
+        second = first;
+    rb->offset1 = first;
+    rb->offset2 = second;
+    rb->byte1 = p[first];
+    rb->byte2 = p[second];
+    rb->useful = rareBytePrefilterEnabled && rareByteRank[p[first]] <= RARE_BYTE_MAX_RANK;
+}
+
+/*
+ * rare_byte_find
+ *
+ * from 이상 last 이하의 시작 위치 s 중 text[s + offset1] == byte1, text[s + offset2] == byte2인 첫 위치를 반환합니다.
+ * (last = n - m) 없으면 -1을 반환합니다. 읽는 범위는 text[from .. last + m)을 넘지 않습니다.
+ */
+int rare_byte_find(const RareBytePrefilter *rb, const char *text, int from, int last) {
+    const unsigned char *t = (const unsigned char *)text;
+    const unsigned char *t1 = t + rb->offset1, *t2 = t + rb->offset2;
+    int s = from;
+#if defined(__AVX2__)
+    const __m256i v1 = _mm256_set1_epi8((char)rb->byte1);
+    const __m256i v2 = _mm256_set1_epi8((char)rb->byte2);
+    for (; s + 31 <= last; s += 32) {
+        __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(t1 + s)), v1);
+        __m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(t2 + s)), v2);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(eq1, eq2));
+        if (mask)
+            return s + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    const __m128i v1 = _mm_set1_epi8((char)rb->byte1);
+    const __m128i v2 = _mm_set1_epi8((char)rb->byte2);
+    for (; s + 15 <= last; s += 16) {
+        __m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(t1 + s)), v1);
+        __m128i eq2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(t2 + s)), v2);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(eq1, eq2));
+        if (mask)
+            return s + __builtin_ctz(mask);
+    }
+#endif
+    for (; s <= last; s++)
+        if (t1[s] == rb->byte1 && t2[s] == rb->byte2)
+            return s;
+    return -1;
+}
+
+#ifndef RARE_BYTE_LIBRARY
+// main 함수: 패턴별로 고른 드문 바이트와 후보 수 데모
+int main(void) {
+    const char *text = "2024-05-01 12:00:01 INFO request ok\n"
+                       "2024-05-01 12:00:02 WARN slow response (timeout=30s)\n"
+                       "2024-05-01 12:00:03 ERROR connection refused\n";
+    const char *patterns[] = {"ERROR", "timeout", "the", "e"};
+    int n = (int)strlen(text);
+    for (int p = 0; p < 4; p++) {
+        int m = (int)strlen(patterns[p]);
+        RareBytePrefilter rb;
+        rare_byte_init(&rb, patterns[p], m);
+        int candidates = 0, matches = 0;
+        for (int s = 0; (s = rare_byte_find(&rb, text, s, n - m)) >= 0; s++) {
+            candidates++;
+            if (memcmp(text + s, patterns[p], (size_t)m) == 0)
+                matches++;
+        }
+        printf("패턴 \"%s\": 드문 바이트 '%c'(%d번째), '%c'(%d번째), 사용 %s, 후보 %d개, 매칭 %d개\n",
+               patterns[p], rb.byte1, rb.offset1, rb.byte2, rb.offset2, rb.useful ? "O" : "X", candidates, matches);
+    }
+    return 0;
+}
+#endif /* RARE_BYTE_LIBRARY */
+
+#endif /* RARE_BYTE_C */
@@ -0,0 +1,488 @@
+/**
+ * bench.c
+ *
+ * 정렬 알고리즘 통합 벤치마크
+ * - 이 디렉터리와 hybrid/의 정렬 예제들을 하나의 실행 파일로 묶어 같은 인터페이스(void sort(int *arr, size_t n))로 측정합니다.
+ * - 크기(기본 1K ~ 100M, 10배씩)와 입력 분포(무작위, 정렬됨, 역순, 중복 많음, 산 모양, Zipf)별로
+ *   원소당 시간(ns/element)과 하드웨어 카운터(캐시 미스, 분기 예측 실패, 명령어 수)를 측정해 CSV로 출력합니다.
+ *
+ * 구성:
+ * - 각 예제 파일을 #include하되, 파일마다 겹치는 이름(main, printArray, insertionSort, ...)을 매크로로 바꿔
+ *   충돌을 피합니다. 예제 파일 자체는 수정하지 않고 그대로 단독 실행할 수 있습니다.
+ * - 하드웨어 카운터는 perf_event_open으로 정렬 호출 구간만 측정합니다. 호출한 스레드만 집계하므로
+ *   병렬 정렬(radix, psort, quick_merge_par)은 다른 스레드의 카운터가 빠집니다. 권한이 없으면(perf_event_paranoid 등) 빈 칸으로 출력합니다.
+ * - 결과 검증: 정렬 후 오름차순인지, 원소의 합/XOR이 입력과 같은지 O(n)으로 확인합니다.
+ * - 느린 조합 건너뛰기: 정렬마다 최대 크기(O(n²) 정렬 등)를 두고, 직전 두 크기의 시간 증가율(최소 선형)로
+ *   다음 크기의 시간을 추정하여 시간 예산(-b)을 넘으면 그 분포의 더 큰 크기는 건너뜁니다.
+ *
+ * 컴파일 예시: gcc -O2 -fopenmp bench.c -o bench -lm
+ * 실행 예시:
+ *   ./bench > result.csv                           (전체: 1K ~ 100M, 약 1.2GB 메모리 필요)
+ *   ./bench -n 1000000 -s intro,time,radix -d random,sorted -r 3
+ *   ./bench -l                                     (정렬/분포 목록)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* ---------- 정렬 예제 포함 (겹치는 이름은 파일별 접두사로 변경) ---------- */
+
+#define main bubbleMain
+#define printArray bubblePrintArray
+#include "bubble.c"
+#undef main
+#undef printArray
+
+#define main bucketMain
+#define printArray bucketPrintArray
+#define benchmark bucketBenchmark
+#include "bucket.c"
+#undef main
+#undef printArray
+#undef benchmark
+
+#define main countingMain
+#define printArray countingPrintArray
+#define benchmark countingBenchmark
+#include "counting.c"
+#undef main
+#undef printArray
+#undef benchmark
+
+#define main heapMain
+#define printArray heapPrintArray
+#define swap heapSwap
+#include "heap.c"
+#undef main
+#undef printArray
+#undef swap
+
+#define main insertionMain
+#define printArray insertionPrintArray
+#include "insertion.c"
+#undef main
+#undef printArray
+
+#define main mergeMain
+#define printArray mergePrintArray
+#include "merge.c"
+#undef main
+#undef printArray
+
+#define main quickMain
+#define printArray quickPrintArray
+#define swap quickSwap
+#include "quick.c"
+#undef main
+#undef printArray
+#undef swap
+
+#define main radixMain
+#define printArray radixPrintArray
+#define benchmark radixBenchmark
+#define nextRandom radixNextRandom
+#include "radix.c"
+#undef main
+#undef printArray
+#undef benchmark
+#undef nextRandom
+
+#define main selectionMain
+#define printArray selectionPrintArray
+#include "selection.c"
+#undef main
+#undef printArray
+
+#define main blockMain
+#define printArray blockPrintArray
+#define insertionSort blockInsertionSort
+#define benchmark blockBenchmark
+#define nowSeconds blockNowSeconds
+#include "hybrid/block.c"
+#undef main
+#undef printArray
+#undef insertionSort
+#undef benchmark
+#undef nowSeconds
+
+#define main quickMergeMain
+#define printArray quickMergePrintArray
+#define insertionSort quickMergeInsertionSort
+#define benchmark quickMergeBenchmark
+#include "hybrid/quick_merge.c"
+#undef main
+#undef printArray
+#undef insertionSort
+#undef benchmark
+#undef THRESHOLD
+
+#define main psortMain
+#define printArray psortPrintArray
+#define insertionSort psortInsertionSort
+#define benchmark psortBenchmark
+#include "hybrid/psort.c"
+#undef main
+#undef printArray
+#undef insertionSort
+#undef benchmark
+#undef THRESHOLD
+
+#define main timMain
+#define printArray timPrintArray
+#define benchmark timBenchmark
+#define nextRandom timNextRandom
+#define nowSeconds timNowSeconds
+#define compareInt timCompareInt
+#include "hybrid/time.c"
+#undef main
+#undef printArray
+#undef benchmark
+#undef nextRandom
+#undef nowSeconds
+#undef compareInt
+
+#define INTRO_SORT_LIBRARY
+#define printArray introPrintArray
+#include "hybrid/intro.c"
+#undef printArray
+
+/* ---------- 공통 인터페이스 ---------- */
+
+// (arr, left, right) 형태의 정렬을 (arr, n) 형태로 맞추는 어댑터
+static void benchBubble(int *arr, size_t n) { bubbleSort(arr, (int)n); }
+static void benchBucket(int *arr, size_t n) { bucketSort(arr, (int)n); }
+static void benchCounting(int *arr, size_t n) { countingSort(arr, (int)n); }
+static void benchHeap(int *arr, size_t n) { heapSort(arr, (int)n); }
+static void benchInsertion(int *arr, size_t n) { insertionSort(arr, (int)n); }
+static void benchMerge(int *arr, size_t n) { mergeSort(arr, 0, (int)n - 1); }
+static void benchQuick(int *arr, size_t n) { quickSort(arr, 0, (int)n - 1); }
+static void benchRadix(int *arr, size_t n) { radixSort(arr, (int)n); }
+static void benchSelection(int *arr, size_t n) { selectionSort(arr, (int)n); }
+static void benchBlock(int *arr, size_t n) { blockSort(arr, (int)n); }
+static void benchQuickMerge(int *arr, size_t n) { quickMergeSort(arr, (int)n); }
+static void benchQuickMergeParallel(int *arr, size_t n) { quickMergeSortParallel(arr, (int)n); }
+static void benchPsort(int *arr, size_t n) { pSort(arr, (int)n); }
+static void benchTim(int *arr, size_t n) { timSort(arr, (int)n); }
+static void benchIntro(int *arr, size_t n) { introSort(arr, (int)n); }
+
+typedef struct {
+    const char *name;
+    void (*sort)(int *arr, size_t n);
+    size_t maxN;            // 이보다 큰 크기는 측정하지 않음 (0이면 제한 없음)
+} SortEntry;
+
+static const SortEntry SORTS[] = {
+    {"bubble", benchBubble, 100000},
+    {"selection", benchSelection, 100000},
+    {"insertion", benchInsertion, 100000},
+    {"bucket", benchBucket, 0},
+    {"counting", benchCounting, 0},
+    {"heap", benchHeap, 0},
+    {"merge", benchMerge, 0},
+    {"quick", benchQuick, 0},
+    {"radix", benchRadix, 0},
+    {"block", benchBlock, 0},
+    {"quick_merge", benchQuickMerge, 0},
+    {"quick_merge_par", benchQuickMergeParallel, 0},
+    {"psort", benchPsort, 0},
+    {"time", benchTim, 0},
+    {"intro", benchIntro, 0},
+};
+#define SORT_COUNT (sizeof(SORTS) / sizeof(SORTS[0]))
+
+/* ---------- 입력 분포 ---------- */
+
+static uint64_t benchRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void fillRandom(int *arr, size_t n, uint64_t *state) {
+    for (size_t i = 0; i < n; i++)
+        arr[i] = (int)(uint32_t)benchRandom(state);
+}
+
+static void fillSorted(int *arr, size_t n, uint64_t *state) {
+    (void)state;
+    for (size_t i = 0; i < n; i++)
+        arr[i] = (int)i;
+}
+
+static void fillReversed(int *arr, size_t n, uint64_t *state) {
+    (void)state;
+    for (size_t i = 0; i < n; i++)
+        arr[i] = (int)(n - i);
+}
+
+// 중복 많음: 서로 다른 값 16개
+static void fillFewUnique(int *arr, size_t n, uint64_t *state) {
+    for (size_t i = 0; i < n; i++)
+        arr[i] = (int)(benchRandom(state) % 16) * 1000003;
+}
+
+// 산 모양: 0, 1, ..., n/2, ..., 1, 0
+static void fillOrganPipe(int *arr, size_t n, uint64_t *state) {
+    (void)state;
+    for (size_t i = 0; i < n; i++)
+        arr[i] = (int)(i < n / 2 ? i : n - i);
+}
+
+// Zipf(s = 1) 근사: [1, n]에서 P(x) ∝ 1/x (로그 균등 분포를 정수로 내림), 작은 값일수록 매우 자주 등장
+static void fillZipf(int *arr, size_t n, uint64_t *state) {
+    double logN = log((double)n + 1.0);
+    for (size_t i = 0; i < n; i++) {
+        double u = (double)(benchRandom(state) >> 11) * 0x1.0p-53;
+        arr[i] = (int)exp(u * logN);
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*fill)(int *arr, size_t n, uint64_t *state);
+} Distribution;
+
+static const Distribution DISTRIBUTIONS[] = {
+    {"random", fillRandom},
+    {"sorted", fillSorted},
+    {"reversed", fillReversed},
+    {"few_unique", fillFewUnique},
+    {"organ_pipe", fillOrganPipe},
+    {"zipf", fillZipf},
+};
+#define DISTRIBUTION_COUNT (sizeof(DISTRIBUTIONS) / sizeof(DISTRIBUTIONS[0]))
+
+/* ---------- 하드웨어 카운터 (perf_event_open) ---------- */
+
+enum { COUNTER_CACHE_MISSES, COUNTER_BRANCH_MISSES, COUNTER_INSTRUCTIONS, COUNTER_COUNT };
+
+typedef struct {
+    int fd[COUNTER_COUNT];
+    bool available;
+} Counters;
+
+static int openCounter(uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group < 0;          // 그룹 리더만 꺼 둔 상태로 만들고, 리더로 그룹 전체를 켜고 끔
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static void countersOpen(Counters *c) {
+    static const uint64_t configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_INSTRUCTIONS,
+    };
+    c->available = true;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        c->fd[i] = openCounter(configs[i], i == 0 ? -1 : c->fd[0]);
+        if (c->fd[i] < 0)
+            c->available = false;
+    }
+    if (!c->available) {
+        for (int i = 0; i < COUNTER_COUNT; i++)
+            if (c->fd[i] >= 0)
+                close(c->fd[i]);
+        fprintf(stderr, "bench: perf_event_open을 사용할 수 없어 하드웨어 카운터 열은 비워 둡니다\n");
+    }
+}
+
+static void countersStart(const Counters *c) {
+    if (!c->available)
+        return;
+    ioctl(c->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(c->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static bool countersStop(const Counters *c, uint64_t values[COUNTER_COUNT]) {
+    if (!c->available)
+        return false;
+    ioctl(c->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    uint64_t buf[1 + COUNTER_COUNT];   // {nr, value[nr]}
+    if (read(c->fd[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf))
+        return false;
+    memcpy(values, buf + 1, sizeof(uint64_t) * COUNTER_COUNT);
+    return true;
+}
+
+/* ---------- 측정 ---------- */
+
+static double benchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 정렬 결과 검증용 요약: 합과 XOR은 순서와 무관하므로 정렬 전후가 같아야 함
+typedef struct {
+    uint64_t sum, xor;
+} Summary;
+
+static Summary summarize(const int *arr, size_t n) {
+    Summary s = {0, 0};
+    for (size_t i = 0; i < n; i++) {
+        s.sum += (uint64_t)(uint32_t)arr[i];
+        s.xor ^= (uint64_t)(uint32_t)arr[i] * 0x9e3779b97f4a7c15ULL;
+    }
+    return s;
+}
+
+static bool verify(const int *arr, size_t n, Summary expected) {
+    for (size_t i = 1; i < n; i++)
+        if (arr[i - 1] > arr[i])
+            return false;
+    Summary s = summarize(arr, n);
+    return s.sum == expected.sum && s.xor == expected.xor;
+}
+
+// 쉼표로 구분된 목록 filter에 name이 있는지 (filter가 NULL이면 모두 허용)
+static bool selected(const char *filter, const char *name) {
+    if (filter == NULL)
+        return true;
+    size_t len = strlen(name);
+    for (const char *p = filter; *p;) {
+        const char *end = strchr(p, ',');
+        size_t tokenLen = end ? (size_t)(end - p) : strlen(p);
+        if (tokenLen == len && strncmp(p, name, len) == 0)
+            return true;
+        if (end == NULL)
+            break;
+        p = end + 1;
+    }
+    return false;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "사용법: %s [-n 최대크기] [-m 최소크기] [-s 정렬,...] [-d 분포,...] [-r 반복] [-b 시간예산(초)] [-l]\n",
+            prog);
+}
+
+// main 함수: 정렬 × 분포 × 크기 조합을 측정해 CSV로 출력
+int main(int argc, char *argv[]) {
+    size_t minN = 1000, maxN = 100000000;
+    const char *sortFilter = NULL, *distFilter = NULL;
+    int reps = 1;
+    double budget = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0) {
+            printf("정렬:");
+            for (size_t s = 0; s < SORT_COUNT; s++)
+                printf(" %s", SORTS[s].name);
+            printf("\n분포:");
+            for (size_t d = 0; d < DISTRIBUTION_COUNT; d++)
+                printf(" %s", DISTRIBUTIONS[d].name);
+            printf("\n");
+            return 0;
+        } else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) {
+            maxN = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "-m") == 0) {
+            minN = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            sortFilter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-d") == 0) {
+            distFilter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-r") == 0) {
+            reps = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-b") == 0) {
+            budget = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (minN < 2 || maxN < minN || maxN > INT32_MAX || reps < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int *input = (int *)malloc(maxN * sizeof(int));
+    int *work = (int *)malloc(maxN * sizeof(int));
+    if (input == NULL || work == NULL) {
+        fprintf(stderr, "bench: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    Counters counters;
+    countersOpen(&counters);
+
+    printf("sort,distribution,n,seconds,ns_per_element,cache_misses,branch_misses,instructions,ok\n");
+    for (size_t d = 0; d < DISTRIBUTION_COUNT; d++) {
+        const Distribution *dist = &DISTRIBUTIONS[d];
+        if (!selected(distFilter, dist->name))
+            continue;
+        bool skip[SORT_COUNT] = {false};   // 시간 예산을 넘을 것으로 추정되어 더 큰 크기를 건너뛸 정렬
+        double previous[SORT_COUNT] = {0};  // 직전 크기에서의 시간
+
+        for (size_t n = minN; n <= maxN; n = n * 10 > maxN && n < maxN ? maxN : n * 10) {
+            uint64_t state = 88172645463325252ULL ^ (uint64_t)n;
+            dist->fill(input, n, &state);
+            Summary expected = summarize(input, n);
+
+            for (size_t s = 0; s < SORT_COUNT; s++) {
+                const SortEntry *sort = &SORTS[s];
+                if (!selected(sortFilter, sort->name) || skip[s] || (sort->maxN && n > sort->maxN))
+                    continue;
+
+                // 반복 중 가장 빠른 측정값을 기록 (카운터도 그 측정의 값)
+                double best = 0;
+                uint64_t bestCounts[COUNTER_COUNT] = {0};
+                bool haveCounts = false, ok = true;
+                for (int r = 0; r < reps; r++) {
+                    memcpy(work, input, n * sizeof(int));
+                    uint64_t counts[COUNTER_COUNT];
+                    countersStart(&counters);
+                    double start = benchNow();
+                    sort->sort(work, n);
+                    double elapsed = benchNow() - start;
+                    bool counted = countersStop(&counters, counts);
+                    ok = ok && verify(work, n, expected);
+                    if (r == 0 || elapsed < best) {
+                        best = elapsed;
+                        haveCounts = counted;
+                        memcpy(bestCounts, counts, sizeof(counts));
+                    }
+                }
+
+                printf("%s,%s,%zu,%.6f,%.3f,", sort->name, dist->name, n, best, best * 1e9 / (double)n);
+                if (haveCounts)
+                    printf("%llu,%llu,%llu,", (unsigned long long)bestCounts[COUNTER_CACHE_MISSES],
+                           (unsigned long long)bestCounts[COUNTER_BRANCH_MISSES],
+                           (unsigned long long)bestCounts[COUNTER_INSTRUCTIONS]);
+                else
+                    printf(",,,");
+                printf("%s\n", ok ? "true" : "false");
+                fflush(stdout);
+
+                // 다음 크기(10배)의 시간을 추정해 예산을 넘으면 이 분포에서 그만 측정
+                // 증가율은 최소 선형(10배)으로 보고, 직전 크기 대비 증가율이 더 크면(예: O(n²)) 그 비율을 사용
+                double growth = previous[s] > 0 && best / previous[s] > 10.0 ? best / previous[s] : 10.0;
+                if (best * growth > budget)
+                    skip[s] = true;
+                previous[s] = best;
+            }
+            if (n == maxN)
+                break;
+        }
+    }
+
+    free(input);
+    free(work);
+    return 0;
+}
@@ -2,114 +2,230 @@
  * bucket.c
  *
  * 최적화된 버킷 정렬 (Bucket Sort) 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
- * - 입력 데이터의 범위를 기반으로 여러 버킷으로 나누고, 
+ * - 배열의 요소를 오름차순으로 정렬합니다. (안정 정렬)
+ * - 입력 데이터의 범위를 기반으로 여러 버킷으로 나누고,
  *   각 버킷을 개별적으로 정렬한 후 결과를 합칩니다.
  *
- * 참고: 이 구현은 정수 배열에 대해 동작하며, 
- *       데이터 분포가 균등할 때 가장 효과적입니다.
+ * 최적화:
+ * - key/value 쌍 정렬: key 순서대로 value(예: 행 번호)도 함께 이동합니다.
+ * - 버킷 번호는 (key - min) >> shift로 구합니다. 버킷 수는 원소 수의 절반 정도(2의 거듭제곱, 최대 2^BUCKET_MAX_BITS)로 정하여
+ *   버킷당 평균 원소가 2개 안팎이 되게 합니다. 범위가 버킷 수 이하이면 버킷 하나가 값 하나이므로 버킷 안 정렬이 필요 없습니다.
+ * - 버킷 배열을 원소 하나씩 늘리지 않습니다: 스레드마다 개인 히스토그램으로 버킷 크기를 먼저 세고 (OpenMP),
+ *   "버킷 순서 → 같은 버킷 안에서는 스레드 순서"로 누적한 위치에 미리 할당된 출력 배열로 바로 흩뿌립니다.
+ * - 버킷 안 정렬: 작은 버킷은 삽입 정렬, 큰 버킷은 하위 shift비트(최대 BUCKET_MAX_SHIFT비트)에 대한 계수 정렬로 정렬하며,
+ *   버킷들을 여러 스레드가 나누어 처리합니다.
+ * - 버킷 하나가 덮는 값의 폭이 2^BUCKET_MAX_SHIFT를 넘을 만큼 범위가 넓으면, 분포가 조금만 치우쳐도 버킷이 커지므로
+ *   전체를 기수 정렬(radix.c)로 대체합니다. (범위 계산은 부호 없는 32비트로 하여 int 전체 범위에서도 오버플로가 없습니다.)
+ *
+ * 컴파일 예시: gcc -O2 -fopenmp bucket.c -o bucket   (radix.c와 같은 디렉터리에서)
+ * 실행 예시: ./bucket 100000000   (1억 개 key/value 쌍 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <omp.h>
 
-// 버킷 구조체: 동적 배열과 현재 요소 개수, 그리고 용량을 관리합니다.
-typedef struct {
-    int *data;
-    int count;
-    int capacity;
-} Bucket;
-
-// 버킷 초기화: 초기 용량은 initCap으로 설정합니다.
-void initBucket(Bucket *bucket, int initCap) {
-    bucket->data = (int *)malloc(initCap * sizeof(int));
-    if (bucket->data == NULL) {
-        fprintf(stderr, "메모리 할당 실패\n");
-        exit(EXIT_FAILURE);
+#define RADIX_SORT_LIBRARY
+#include "radix.c"
+
+#define BUCKET_MAX_BITS 16            // 버킷 수 상한 2^16 (스레드별 히스토그램 512KB)
+#define BUCKET_MAX_SHIFT 8            // 버킷 하나가 덮는 값의 폭 상한 2^8 (넘으면 기수 정렬로 대체)
+#define BUCKET_INSERTION_MAX 32       // 이 크기 이하의 버킷은 삽입 정렬, 더 크면 계수 정렬
+#define BUCKET_PARALLEL_MIN 65536     // 이보다 작은 배열은 한 스레드로 정렬
+
+// key/value 쌍 삽입 정렬 (values가 NULL이면 key만)
+static void insertionSortPairs(int32_t keys[], uint32_t values[], size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int32_t key = keys[i];
+        uint32_t value = values != NULL ? values[i] : 0;
+        size_t j = i;
+        while (j > 0 && keys[j - 1] > key) {
+            keys[j] = keys[j - 1];
+            if (values != NULL)
+                values[j] = values[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        if (values != NULL)
+            values[j] = value;
     }
-    bucket->count = 0;
-    bucket->capacity = initCap;
 }
 
-// 버킷에 요소 추가: 용량 부족 시 재할당합니다.
-void insertBucket(Bucket *bucket, int value) {
-    if (bucket->count == bucket->capacity) {
-        bucket->capacity *= 2;
-        bucket->data = (int *)realloc(bucket->data, bucket->capacity * sizeof(int));
-        if (bucket->data == NULL) {
-            fprintf(stderr, "메모리 재할당 실패\n");
-            exit(EXIT_FAILURE);
-        }
+/*
+ * 큰 버킷 정렬: 버킷 안의 key는 (key - min)의 하위 shift비트만 다르므로, 2^shift개 카운터로 계수 정렬
+ * scratch로 옮긴 뒤 정해진 위치에 되돌려 놓습니다. (안정)
+ */
+static void countingSortBucket(int32_t keys[], uint32_t values[], size_t n, int32_t min, int shift,
+                               int32_t scratchKeys[], uint32_t scratchValues[]) {
+    size_t count[1 << BUCKET_MAX_SHIFT] = {0};
+    uint32_t mask = (1u << shift) - 1;
+    for (size_t i = 0; i < n; i++)
+        count[((uint32_t)keys[i] - (uint32_t)min) & mask]++;
+    size_t offset = 0;
+    for (uint32_t d = 0; d <= mask; d++) {
+        size_t c = count[d];
+        count[d] = offset;
+        offset += c;
+    }
+    memcpy(scratchKeys, keys, n * sizeof(int32_t));
+    if (values != NULL)
+        memcpy(scratchValues, values, n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        size_t pos = count[((uint32_t)scratchKeys[i] - (uint32_t)min) & mask]++;
+        keys[pos] = scratchKeys[i];
+        if (values != NULL)
+            values[pos] = scratchValues[i];
     }
-    bucket->data[bucket->count++] = value;
 }
 
-// 간단한 삽입 정렬: 버킷 내부의 배열을 오름차순으로 정렬합니다.
-void insertionSort(int arr[], int n) {
-    for (int i = 1; i < n; i++) {
-        int key = arr[i];
-        int j = i - 1;
-        while (j >= 0 && arr[j] > key) {
-            arr[j + 1] = arr[j];
-            j--;
-        }
-        arr[j + 1] = key;
+// 배열의 최소값과 최대값 (n > 0)
+static void bucketMinMax(const int32_t arr[], size_t n, int32_t *min, int32_t *max) {
+    int32_t lo = arr[0], hi = arr[0];
+    #pragma omp parallel for reduction(min:lo) reduction(max:hi) if(n >= BUCKET_PARALLEL_MIN)
+    for (size_t i = 1; i < n; i++) {
+        if (arr[i] < lo)
+            lo = arr[i];
+        if (arr[i] > hi)
+            hi = arr[i];
     }
+    *min = lo;
+    *max = hi;
 }
 
-// 버킷 정렬 함수: 배열 arr를 n 크기를 기준으로 정렬
-void bucketSort(int arr[], int n) {
-    if (n <= 0) return;
+/*
+ * 버킷 정렬 (key/value 쌍, 출력 배열 지정): keys[0..n)을 정렬하여 outKeys에 쓰고, values도 같은 순서로 outValues에 씀
+ * values가 NULL이면 key만 정렬합니다. 입력과 출력은 겹치면 안 됩니다.
+ */
+void bucketSortPairsTo(const int32_t keys[], const uint32_t values[], size_t n,
+                       int32_t outKeys[], uint32_t outValues[]) {
+    if (n == 0)
+        return;
+    int32_t min, max;
+    bucketMinMax(keys, n, &min, &max);
+    uint32_t span = (uint32_t)max - (uint32_t)min;   // max - min (부호 없는 연산이라 오버플로 없음)
 
-    // 배열의 최소값과 최대값 찾기
-    int min = arr[0], max = arr[0];
-    for (int i = 1; i < n; i++) {
-        if (arr[i] < min) 
-            min = arr[i];
-        if (arr[i] > max) 
-            max = arr[i];
-    }
-    
-    // 만약 모든 값이 동일하면 정렬할 필요 없음
-    if (min == max)
+    int rangeBits = 0, bucketBits = 0;
+    while (rangeBits < 32 && (span >> rangeBits) != 0)
+        rangeBits++;
+    while (bucketBits < BUCKET_MAX_BITS && ((size_t)2 << bucketBits) <= n)
+        bucketBits++;
+    int shift = rangeBits > bucketBits ? rangeBits - bucketBits : 0;
+
+    if (shift > BUCKET_MAX_SHIFT) {
+        // 범위가 너무 넓음: 출력 배열로 옮긴 뒤 기수 정렬
+        memcpy(outKeys, keys, n * sizeof(int32_t));
+        if (values != NULL) {
+            memcpy(outValues, values, n * sizeof(uint32_t));
+            radixSortPairsInt32(outKeys, outValues, n);
+        } else {
+            radixSortInt32(outKeys, n);
+        }
         return;
-    
-    // 입력 배열 크기만큼의 버킷 생성 (최대 n개의 버킷)
-    int bucketCount = n;
-    Bucket *buckets = (Bucket *)malloc(bucketCount * sizeof(Bucket));
-    if (buckets == NULL) {
+    }
+
+    size_t buckets = ((size_t)span >> shift) + 1;
+    int threads = n >= BUCKET_PARALLEL_MIN ? omp_get_max_threads() : 1;
+    size_t *counts = (size_t *)calloc((size_t)threads * buckets, sizeof(size_t));
+    size_t *bucketStart = (size_t *)malloc((buckets + 1) * sizeof(size_t));
+    if (counts == NULL || bucketStart == NULL) {
         fprintf(stderr, "메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    
-    // 각 버킷 초기화 (초기 용량은 10)
-    for (int i = 0; i < bucketCount; i++) {
-        initBucket(&buckets[i], 10);
-    }
-    
-    // 각 요소를 적절한 버킷에 분배
-    // 버킷 인덱스: 0 ~ bucketCount-1
-    for (int i = 0; i < n; i++) {
-        int index = (long long)(arr[i] - min) * (bucketCount - 1) / (max - min);
-        insertBucket(&buckets[index], arr[i]);
-    }
-    
-    // 각 버킷 내에서 삽입 정렬 수행
-    for (int i = 0; i < bucketCount; i++) {
-        if (buckets[i].count > 0) {
-            insertionSort(buckets[i].data, buckets[i].count);
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        size_t begin = n * t / nt, end = n * (t + 1) / nt;
+        size_t *count = counts + (size_t)t * buckets;
+
+        // 버킷별 원소 수를 스레드 개인 히스토그램에 기록
+        for (size_t i = begin; i < end; i++)
+            count[((uint32_t)keys[i] - (uint32_t)min) >> shift]++;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            // 버킷 순서, 같은 버킷 안에서는 스레드 순서로 누적하여 쓰기 시작 위치로 변환 (안정 정렬)
+            size_t offset = 0;
+            for (size_t b = 0; b < buckets; b++) {
+                bucketStart[b] = offset;
+                for (int u = 0; u < nt; u++) {
+                    size_t c = counts[(size_t)u * buckets + b];
+                    counts[(size_t)u * buckets + b] = offset;
+                    offset += c;
+                }
+            }
+            bucketStart[buckets] = offset;
         }
-    }
-    
-    // 정렬된 버킷들을 원본 배열에 병합
-    int idx = 0;
-    for (int i = 0; i < bucketCount; i++) {
-        for (int j = 0; j < buckets[i].count; j++) {
-            arr[idx++] = buckets[i].data[j];
+
+        // 자기 구간을 앞에서부터 출력 배열의 버킷 위치로 흩뿌림
+        for (size_t i = begin; i < end; i++) {
+            size_t pos = count[((uint32_t)keys[i] - (uint32_t)min) >> shift]++;
+            outKeys[pos] = keys[i];
+            if (values != NULL)
+                outValues[pos] = values[i];
         }
-        free(buckets[i].data); // 각 버킷 동적 메모리 해제
+        // 모든 스레드가 흩뿌리기를 마친 뒤에야 버킷 내용이 완성되므로, 버킷 정렬 전에 기다림
+        #pragma omp barrier
+
+        // 각 버킷 정렬 (버킷 하나가 값 하나이면 이미 정렬됨), 계수 정렬용 scratch는 스레드마다 필요한 만큼 늘림
+        if (shift > 0) {
+            int32_t *scratchKeys = NULL;
+            uint32_t *scratchValues = NULL;
+            size_t scratchCapacity = 0;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t b = 0; b < buckets; b++) {
+                size_t size = bucketStart[b + 1] - bucketStart[b];
+                int32_t *bucketKeys = outKeys + bucketStart[b];
+                uint32_t *bucketValues = values != NULL ? outValues + bucketStart[b] : NULL;
+                if (size <= BUCKET_INSERTION_MAX) {
+                    insertionSortPairs(bucketKeys, bucketValues, size);
+                    continue;
+                }
+                if (size > scratchCapacity) {
+                    scratchCapacity = size * 2;
+                    scratchKeys = (int32_t *)realloc(scratchKeys, scratchCapacity * sizeof(int32_t));
+                    scratchValues = (uint32_t *)realloc(scratchValues, scratchCapacity * sizeof(uint32_t));
+                    if (scratchKeys == NULL || scratchValues == NULL) {
+                        fprintf(stderr, "메모리 할당 실패\n");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                countingSortBucket(bucketKeys, bucketValues, size, min, shift, scratchKeys, scratchValues);
+            }
+            free(scratchKeys);
+            free(scratchValues);
+        }
+    }
+    free(counts);
+    free(bucketStart);
+}
+
+// 버킷 정렬 (key/value 쌍, 제자리): 보조 배열에 정렬한 뒤 되돌려 복사
+void bucketSortPairs(int32_t keys[], uint32_t values[], size_t n) {
+    if (n == 0)
+        return;
+    int32_t *tmpKeys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *tmpValues = values != NULL ? (uint32_t *)malloc(n * sizeof(uint32_t)) : NULL;
+    if (tmpKeys == NULL || (values != NULL && tmpValues == NULL)) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
     }
-    free(buckets);
+    bucketSortPairsTo(keys, values, n, tmpKeys, tmpValues);
+    memcpy(keys, tmpKeys, n * sizeof(int32_t));
+    if (values != NULL)
+        memcpy(values, tmpValues, n * sizeof(uint32_t));
+    free(tmpKeys);
+    free(tmpValues);
+}
+
+// 버킷 정렬 함수: 배열 arr를 n 크기를 기준으로 정렬
+void bucketSort(int arr[], int n) {
+    if (n <= 0) return;
+    bucketSortPairs((int32_t *)arr, NULL, (size_t)n);
 }
 
 // 배열의 요소를 출력하는 함수
@@ -120,8 +236,95 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 정렬 결과 확인: 키 오름차순, value(원래 위치)가 key를 따라 이동, 같은 key 안에서는 원래 순서 (안정 정렬)
+static bool checkSortedPairs(const int32_t keys[], const int32_t outKeys[], const uint32_t outValues[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (keys[outValues[i]] != outKeys[i])
+            return false;
+        if (i > 0 && !(outKeys[i - 1] < outKeys[i] || (outKeys[i - 1] == outKeys[i] && outValues[i - 1] < outValues[i])))
+            return false;
+    }
+    return true;
+}
+
+// 대용량 벤치마크: 샤드 ID(2^20 범위, 버킷 정렬)와 int 전체 범위(기수 정렬 대체) key/value 쌍 정렬
+static void benchmark(size_t n) {
+    int32_t *keys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *values = (uint32_t *)malloc(n * sizeof(uint32_t));
+    int32_t *outKeys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *outValues = (uint32_t *)malloc(n * sizeof(uint32_t));
+    if (keys == NULL || values == NULL || outKeys == NULL || outValues == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *names[] = {"ID 2^20 범위", "int 전체 범위"};
+    printf("\n%zu개 key/value 쌍 정렬 (스레드 %d개):\n", n, omp_get_max_threads());
+    for (int p = 0; p < 2; p++) {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < n; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            keys[i] = p == 0 ? (int32_t)(state % (1u << 20)) : (int32_t)state;
+            values[i] = (uint32_t)i;
+        }
+        double start = omp_get_wtime();
+        bucketSortPairsTo(keys, values, n, outKeys, outValues);
+        double elapsed = omp_get_wtime() - start;
+        bool ok = checkSortedPairs(keys, outKeys, outValues, n);
+        printf("  %s: %.3f초 %s\n", names[p], elapsed, ok ? "" : "(정렬 실패!)");
+    }
+    free(keys);
+    free(values);
+    free(outKeys);
+    free(outValues);
+}
+
+// 여러 스레드 수와 입력 분포로 정렬 결과를 확인 (코어가 하나뿐이어도 스레드 수를 강제로 늘려 병렬 경로를 검사)
+static void checkThreads(size_t n) {
+    const char *names[] = {"무작위", "정렬됨", "역순", "중복 많음"};
+    const int threadCounts[] = {1, 2, 4, 8};
+    int32_t *keys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *values = (uint32_t *)malloc(n * sizeof(uint32_t));
+    int32_t *outKeys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *outValues = (uint32_t *)malloc(n * sizeof(uint32_t));
+    if (keys == NULL || values == NULL || outKeys == NULL || outValues == NULL) {
+        fprintf(stderr, "checkThreads: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    int maxThreads = omp_get_max_threads();
+    printf("\n%zu개 key/value 쌍 멀티스레드 검증:\n", n);
+    for (int d = 0; d < 4; d++) {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < n; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            switch (d) {
+            case 0: keys[i] = (int32_t)(state % (1u << 20)); break;
+            case 1: keys[i] = (int32_t)i; break;
+            case 2: keys[i] = (int32_t)(n - i); break;
+            default: keys[i] = (int32_t)(state % 16) * 1000; break;
+            }
+            values[i] = (uint32_t)i;
+        }
+        printf("  %s:", names[d]);
+        for (int t = 0; t < 4; t++) {
+            omp_set_num_threads(threadCounts[t]);
+            bucketSortPairsTo(keys, values, n, outKeys, outValues);
+            printf(" 스레드 %d개 %s", threadCounts[t], checkSortedPairs(keys, outKeys, outValues, n) ? "통과" : "(정렬 실패!)");
+        }
+        printf("\n");
+    }
+    omp_set_num_threads(maxThreads);
+    free(keys);
+    free(values);
+    free(outKeys);
+    free(outValues);
+}
+
 // main 함수: 버킷 정렬 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {29, 25, 3, 49, 9, 37, 21, 43};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -133,5 +336,8 @@ int main(void) {
     printf("Sorted array:\n");
     printArray(arr, n);
 
+    checkThreads(1000000);
+    benchmark(argc > 1 ? (size_t)atol(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
@@ -5,70 +5,138 @@
  * - 배열의 요소를 오름차순으로 정렬합니다.
  * - 배열 내 요소들의 범위를 기반으로 각 요소의 등장 빈도를 계산하여 정렬합니다.
  * - 안정적인 정렬을 위해 입력 배열의 순서를 보존합니다.
+ *
+ * 최적화:
+ * - key/value 쌍 정렬: key(예: 테넌트, 샤드 ID) 순서대로 value(예: 행 번호)도 함께 이동합니다.
+ * - 병렬 히스토그램 (OpenMP): 스레드마다 자기 구간의 빈도를 개인 카운트 배열에 세므로 원자 연산이나 공유 카운터 경합이 없습니다.
+ *   "값 순서 → 같은 값 안에서는 스레드 순서"로 누적하여 스레드별 쓰기 시작 위치를 구하므로 안정 정렬이 유지됩니다.
+ * - 미리 할당된 출력 배열로 바로 흩뿌림(scatter): countingSortPairsTo는 한 번의 분배로 결과를 만들고 복사하지 않습니다.
+ * - 값의 범위(max - min + 1)가 COUNTING_MAX_RANGE를 넘거나 원소 수에 비해 너무 넓으면, 카운트 배열이 캐시에 들어가지 않으므로
+ *   기수 정렬(radix.c)로 대체합니다. (범위 계산은 64비트로 하여 int 전체 범위에서도 오버플로가 없습니다.)
+ *
+ * 컴파일 예시: gcc -O2 -fopenmp counting.c -o counting   (radix.c와 같은 디렉터리에서)
+ * 실행 예시: ./counting 100000000   (1억 개 key/value 쌍 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <omp.h>
 
-// 배열의 최소값과 최대값을 찾는 함수
-void findMinMax(int arr[], int n, int *min, int *max) {
-    *min = arr[0];
-    *max = arr[0];
-    for (int i = 1; i < n; i++) {
-        if (arr[i] < *min) {
-            *min = arr[i];
-        }
-        if (arr[i] > *max) {
-            *max = arr[i];
-        }
+#define RADIX_SORT_LIBRARY
+#include "radix.c"
+
+#define COUNTING_MAX_RANGE 65536      // 스레드별 카운트 배열 크기 상한 (size_t 64K개 = 512KB, L2에 들어가는 크기)
+#define COUNTING_PARALLEL_MIN 65536   // 이보다 작은 배열은 한 스레드로 정렬
+
+// 배열의 최소값과 최대값을 찾는 함수 (n > 0)
+void findMinMax(const int32_t arr[], size_t n, int32_t *min, int32_t *max) {
+    int32_t lo = arr[0], hi = arr[0];
+    #pragma omp parallel for reduction(min:lo) reduction(max:hi) if(n >= COUNTING_PARALLEL_MIN)
+    for (size_t i = 1; i < n; i++) {
+        if (arr[i] < lo)
+            lo = arr[i];
+        if (arr[i] > hi)
+            hi = arr[i];
     }
+    *min = lo;
+    *max = hi;
 }
 
-// 계수 정렬 함수: arr 배열을 n 크기 기준으로 오름차순 정렬
-void countingSort(int arr[], int n) {
-    int min, max;
-    findMinMax(arr, n, &min, &max);
-    
-    int range = max - min + 1; // 배열 내 값의 범위
-    int *count = (int *)calloc(range, sizeof(int)); // count 배열 초기화
-    if (count == NULL) {
+/*
+ * 계수 정렬 (key/value 쌍, 출력 배열 지정): keys[0..n)을 정렬하여 outKeys에 쓰고, values도 같은 순서로 outValues에 씀
+ * values가 NULL이면 key만 정렬합니다. 입력과 출력은 겹치면 안 됩니다.
+ */
+void countingSortPairsTo(const int32_t keys[], const uint32_t values[], size_t n,
+                         int32_t outKeys[], uint32_t outValues[]) {
+    if (n == 0)
+        return;
+    int32_t min, max;
+    findMinMax(keys, n, &min, &max);
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+
+    if (range > COUNTING_MAX_RANGE || range > 2 * (uint64_t)n + 256) {
+        // 범위가 너무 넓음: 출력 배열로 옮긴 뒤 기수 정렬
+        memcpy(outKeys, keys, n * sizeof(int32_t));
+        if (values != NULL) {
+            memcpy(outValues, values, n * sizeof(uint32_t));
+            radixSortPairsInt32(outKeys, outValues, n);
+        } else {
+            radixSortInt32(outKeys, n);
+        }
+        return;
+    }
+
+    int threads = n >= COUNTING_PARALLEL_MIN ? omp_get_max_threads() : 1;
+    size_t *counts = (size_t *)calloc((size_t)threads * range, sizeof(size_t));
+    if (counts == NULL) {
         fprintf(stderr, "메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    
-    // 각 요소의 발생 빈도를 count 배열에 기록
-    for (int i = 0; i < n; i++) {
-        count[arr[i] - min]++;
-    }
-    
-    // count 배열을 누적 합으로 변환 (안정적인 정렬을 위해)
-    for (int i = 1; i < range; i++) {
-        count[i] += count[i - 1];
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        size_t begin = n * t / nt, end = n * (t + 1) / nt;
+        size_t *count = counts + (size_t)t * range;
+
+        // 각 요소의 발생 빈도를 스레드 개인 카운트 배열에 기록
+        for (size_t i = begin; i < end; i++)
+            count[(uint32_t)(keys[i] - min)]++;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            // 값 순서, 같은 값 안에서는 스레드 순서로 누적하여 쓰기 시작 위치로 변환 (안정 정렬)
+            size_t offset = 0;
+            for (uint64_t v = 0; v < range; v++) {
+                for (int u = 0; u < nt; u++) {
+                    size_t c = counts[(size_t)u * range + v];
+                    counts[(size_t)u * range + v] = offset;
+                    offset += c;
+                }
+            }
+        }
+
+        // 자기 구간을 앞에서부터 출력 배열의 정해진 위치로 흩뿌림
+        if (values != NULL) {
+            for (size_t i = begin; i < end; i++) {
+                size_t pos = count[(uint32_t)(keys[i] - min)]++;
+                outKeys[pos] = keys[i];
+                outValues[pos] = values[i];
+            }
+        } else {
+            for (size_t i = begin; i < end; i++)
+                outKeys[count[(uint32_t)(keys[i] - min)]++] = keys[i];
+        }
     }
-    
-    // 결과를 저장할 임시 배열 생성
-    int *output = (int *)malloc(n * sizeof(int));
-    if (output == NULL) {
-        free(count);
+    free(counts);
+}
+
+// 계수 정렬 (key/value 쌍, 제자리): 보조 배열에 정렬한 뒤 되돌려 복사
+void countingSortPairs(int32_t keys[], uint32_t values[], size_t n) {
+    if (n == 0)
+        return;
+    int32_t *tmpKeys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *tmpValues = values != NULL ? (uint32_t *)malloc(n * sizeof(uint32_t)) : NULL;
+    if (tmpKeys == NULL || (values != NULL && tmpValues == NULL)) {
         fprintf(stderr, "메모리 할당 실패\n");
         exit(EXIT_FAILURE);
     }
-    
-    // 원래 배열의 요소를 역순으로 탐색하여 안정적으로 정렬된 위치에 배치
-    for (int i = n - 1; i >= 0; i--) {
-        int index = arr[i] - min;
-        output[count[index] - 1] = arr[i];
-        count[index]--;
-    }
-    
-    // 정렬된 결과를 원본 배열에 복사
-    for (int i = 0; i < n; i++) {
-        arr[i] = output[i];
-    }
-    
-    // 동적 할당한 메모리 해제
-    free(count);
-    free(output);
+    countingSortPairsTo(keys, values, n, tmpKeys, tmpValues);
+    memcpy(keys, tmpKeys, n * sizeof(int32_t));
+    if (values != NULL)
+        memcpy(values, tmpValues, n * sizeof(uint32_t));
+    free(tmpKeys);
+    free(tmpValues);
+}
+
+// 계수 정렬 함수: arr 배열을 n 크기 기준으로 오름차순 정렬
+void countingSort(int arr[], int n) {
+    if (n <= 0) return;
+    countingSortPairs((int32_t *)arr, NULL, (size_t)n);
 }
 
 // 배열의 요소를 출력하는 함수
@@ -79,8 +147,45 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 대용량 벤치마크: 작은 범위의 ID(테넌트 1000개)와 넓은 범위(기수 정렬 대체) key/value 쌍 정렬
+static void benchmark(size_t n) {
+    int32_t *keys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *values = (uint32_t *)malloc(n * sizeof(uint32_t));
+    int32_t *outKeys = (int32_t *)malloc(n * sizeof(int32_t));
+    uint32_t *outValues = (uint32_t *)malloc(n * sizeof(uint32_t));
+    if (keys == NULL || values == NULL || outKeys == NULL || outValues == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *names[] = {"ID 1000종", "int 전체 범위"};
+    printf("\n%zu개 key/value 쌍 정렬 (스레드 %d개):\n", n, omp_get_max_threads());
+    for (int p = 0; p < 2; p++) {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < n; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            keys[i] = p == 0 ? (int32_t)(state % 1000) : (int32_t)state;
+            values[i] = (uint32_t)i;
+        }
+        double start = omp_get_wtime();
+        countingSortPairsTo(keys, values, n, outKeys, outValues);
+        double elapsed = omp_get_wtime() - start;
+        // value(원래 위치)가 key를 따라 이동했는지, 같은 key 안에서 원래 순서인지 확인
+        bool ok = true;
+        for (size_t i = 0; i < n && ok; i++)
+            ok = keys[outValues[i]] == outKeys[i] &&
+                 (i == 0 || outKeys[i - 1] < outKeys[i] || (outKeys[i - 1] == outKeys[i] && outValues[i - 1] < outValues[i]));
+        printf("  %s: %.3f초 %s\n", names[p], elapsed, ok ? "" : "(정렬 실패!)");
+    }
+    free(keys);
+    free(values);
+    free(outKeys);
+    free(outValues);
+}
+
 // main 함수: 계수 정렬 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {4, 2, -3, 6, 1, 0, -1, 3, 2};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -92,5 +197,7 @@ int main(void) {
     printf("Sorted array:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? (size_t)atol(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
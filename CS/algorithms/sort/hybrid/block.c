@@ -1,24 +1,56 @@
 /**
  * block.c
  *
- * 최적화된 블록 정렬 (Block Sort) 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
- * - 데이터를 고정 크기의 블록으로 분할한 후, 각 블록을 삽입 정렬로 정렬합니다.
- * - 정렬된 블록들을 반복적인 병합 과정을 통해 전체 정렬을 완성합니다.
+ * 최적화된 블록 정렬 (Block Merge Sort) 구현 예제
+ * - 배열의 요소를 오름차순으로 정렬합니다. (안정 정렬)
+ * - 추가 메모리 O(1): 병합에 필요한 버퍼를 malloc하지 않고 배열 안에서 만들어 씁니다. (재귀도 사용하지 않음)
  *
- * 참고: 이 구현은 블록 기반 정렬의 간단한 형태로, 데이터가 균일하게 분포되어 있을 때
- *       캐시 최적화와 지역성을 활용하여 성능을 향상시킬 수 있습니다.
+ * 구성:
+ * 1) 내부 버퍼 추출: 배열 앞쪽에서 서로 다른 값(각 값의 첫 등장) 약 3√n개를 모아 배열 맨 앞으로 옮깁니다.
+ *    나머지 원소의 상대 순서는 회전(rotation)으로만 옮기므로 그대로 유지됩니다.
+ *    모은 값의 앞부분은 블록 태그(tag), 뒷부분(√n 이상, 2의 거듭제곱 b개)은 병합용 스왑 버퍼로 씁니다.
+ * 2) 나머지 구간을 RUN_LENGTH 단위로 삽입 정렬한 뒤, 길이를 2배씩 늘리며 인접한 두 run A, B를 병합합니다.
+ *    - |A| <= b: A를 버퍼와 교환(swap)해 두고 버퍼와 B에서 작은 값을 차례로 제자리로 교환하는 버퍼 병합
+ *    - |A| > b: 블록 병합
+ *      a) A와 B를 크기 b의 블록으로 나누고 블록마다 태그를 붙인 뒤, (첫 원소, 태그) 순으로 블록을 선택 정렬
+ *         (블록 교환은 O(n/b)번이므로 이동량 O(n)) - 같은 값이면 A 블록이 먼저, 같은 쪽 블록끼리는 원래 순서 유지
+ *      b) 앞에서부터 출처(A/B)가 바뀌는 지점마다 "아직 확정되지 않은 꼬리"와 다음 블록을 버퍼 병합 (Kronrod 방식)
+ *      c) 블록으로 나누고 남은 B의 끝부분(b 미만)은 버퍼를 이용해 뒤에서부터 병합
+ * 3) 마지막으로 버퍼(순서가 섞임)를 삽입 정렬하고, 회전 기반 제자리 병합으로 나머지와 합칩니다.
+ *    버퍼 값은 각 값의 첫 등장이므로 같은 값보다 앞에 놓이면 안정성이 유지됩니다.
+ *
+ * - 서로 다른 값이 부족하면(중복이 매우 많은 입력, 값 종류 K < 약 3√n) run 길이에 따라 병합 방식을 바꿉니다.
+ *   - run이 K 이하: 모은 값 전체를 버퍼로 쓰는 버퍼 병합
+ *   - 태그가 충분한 동안: 모은 값의 뒷부분(K/4 ~ K/2)을 버퍼로, 앞부분을 태그로 쓰는 작은 블록의 블록 병합
+ *   - 그보다 긴 run: 모은 값 전체를 태그로 쓰고 블록을 키운 뒤, 버퍼 없이 회전으로 블록을 병합
+ *     (회전 병합의 반복 횟수는 값 종류 수 이하이고, 블록 수가 K 정도이므로 단계마다 O(n))
+ *   따라서 값 종류와 상관없이 O(n log n)입니다.
+ * - BLOCK_LESS를 key 일부만 비교하도록 정의하면 (예: 상위 비트) 안정성을 확인할 수 있습니다.
+ *
+ * 컴파일 예시: gcc -O2 block.c -o block
+ * 실행 예시: ./block 10000000   (1000만 개 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define RUN_LENGTH 16          // 처음 삽입 정렬하는 run의 길이
+#define MIN_BLOCK_SORT 256     // 이보다 작은 배열은 전체를 삽입 정렬
 
-// 작은 구간에 대해 삽입 정렬을 수행하는 함수
+#ifndef BLOCK_LESS
+#define BLOCK_LESS(a, b) ((a) < (b))
+#endif
+
+// 작은 구간에 대해 삽입 정렬을 수행하는 함수: arr[left..right] (안정)
 void insertionSort(int arr[], int left, int right) {
     for (int i = left + 1; i <= right; i++) {
         int key = arr[i];
         int j = i - 1;
-        while (j >= left && arr[j] > key) {
+        while (j >= left && BLOCK_LESS(key, arr[j])) {
             arr[j + 1] = arr[j];
             j--;
         }
@@ -26,62 +58,333 @@ void insertionSort(int arr[], int left, int right) {
     }
 }
 
-// 두 정렬된 구간을 병합하는 함수: arr[left..mid]와 arr[mid+1..right]를 병합
-void merge(int arr[], int left, int mid, int right) {
-    int len1 = mid - left + 1;
-    int len2 = right - mid;
-    
-    int *leftArr = (int *)malloc(len1 * sizeof(int));
-    int *rightArr = (int *)malloc(len2 * sizeof(int));
-    
-    for (int i = 0; i < len1; i++) {
-        leftArr[i] = arr[left + i];
+// arr[a..a+len)과 arr[b..b+len)을 교환 (두 구간은 겹치지 않음)
+static void swapRange(int arr[], int a, int b, int len) {
+    for (int i = 0; i < len; i++) {
+        int temp = arr[a + i];
+        arr[a + i] = arr[b + i];
+        arr[b + i] = temp;
     }
-    for (int j = 0; j < len2; j++) {
-        rightArr[j] = arr[mid + 1 + j];
+}
+
+// arr[lo..hi) 뒤집기
+static void reverseRange(int arr[], int lo, int hi) {
+    for (hi--; lo < hi; lo++, hi--) {
+        int temp = arr[lo];
+        arr[lo] = arr[hi];
+        arr[hi] = temp;
     }
-    
-    int i = 0, j = 0, k = left;
-    while (i < len1 && j < len2) {
-        if (leftArr[i] <= rightArr[j])
-            arr[k++] = leftArr[i++];
+}
+
+// 회전: arr[first..middle)과 arr[middle..last)의 위치를 맞바꿈 (세 번 뒤집기, 이동량 O(last - first))
+static void rotate(int arr[], int first, int middle, int last) {
+    if (first == middle || middle == last)
+        return;
+    reverseRange(arr, first, middle);
+    reverseRange(arr, middle, last);
+    reverseRange(arr, first, last);
+}
+
+// arr[lo..hi)에서 value 이상인 첫 위치
+static int lowerBound(const int arr[], int lo, int hi, int value) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (BLOCK_LESS(arr[mid], value))
+            lo = mid + 1;
         else
-            arr[k++] = rightArr[j++];
+            hi = mid;
+    }
+    return lo;
+}
+
+// arr[lo..hi)에서 value보다 큰 첫 위치
+static int upperBound(const int arr[], int lo, int hi, int value) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (BLOCK_LESS(value, arr[mid]))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+/*
+ * 내부 버퍼 추출: 서로 다른 값을 최대 want개 모아 arr[0..found)에 오름차순으로 놓고 found를 반환
+ * 모은 값 묶음을 다음 새 값 바로 앞까지 회전으로 끌고 가며 삽입하므로, 나머지 원소의 순서는 유지됩니다.
+ * (이동량: 건너뛴 원소 수 + found²)
+ */
+static int collectKeys(int arr[], int n, int want) {
+    int keysStart = 0, found = 1;
+    for (int i = 1; i < n && found < want; i++) {
+        int pos = lowerBound(arr, keysStart, keysStart + found, arr[i]);
+        if (pos < keysStart + found && !BLOCK_LESS(arr[i], arr[pos]))
+            continue;   // 이미 모은 값과 같음
+        rotate(arr, keysStart, keysStart + found, i);
+        pos += i - found - keysStart;
+        keysStart = i - found;
+        rotate(arr, pos, i, i + 1);
+        found++;
+    }
+    rotate(arr, 0, keysStart, keysStart + found);
+    return found;
+}
+
+/*
+ * 회전 기반 제자리 병합: arr[a..m)과 arr[m..e)를 병합 (추가 메모리 없음)
+ * A의 첫 원소보다 작은 B의 앞부분을 A 앞으로 회전시키고, 그다음 B 원소 이하인 A의 앞부분은 확정하는 과정을 반복
+ */
+static void mergeInPlace(int arr[], int a, int m, int e) {
+    while (a < m && m < e) {
+        int cut = lowerBound(arr, m, e, arr[a]);
+        if (cut > m) {
+            rotate(arr, a, m, cut);
+            a += cut - m;
+            m = cut;
+            if (m == e)
+                break;
+        }
+        a = upperBound(arr, a, m, arr[m]);
+    }
+}
+
+/*
+ * 버퍼 병합 (앞에서부터): P = arr[p..p+lenP)와 바로 뒤의 C = arr[p+lenP..p+lenP+lenC)를 병합
+ * P를 버퍼 arr[buf..buf+lenP)와 교환해 두고, 버퍼와 C 중 작은 값을 p부터 차례로 교환해 넣습니다.
+ * 원소를 교환만 하므로 버퍼의 값(순서는 바뀜)은 보존됩니다.
+ * pFirstOnTie: 같은 값이면 P를 먼저 (P가 원래 앞쪽 run일 때 true)
+ * 한쪽이 먼저 바닥나면 멈추고, 남은 쪽(뒤쪽 끝에 놓임)의 길이를 반환합니다. *pRemains는 남은 쪽이 P인지 여부
+ */
+static int mergeForward(int arr[], int p, int lenP, int lenC, int buf, bool pFirstOnTie, bool *pRemains) {
+    swapRange(arr, buf, p, lenP);
+    int i = 0, j = p + lenP, k = p, end = p + lenP + lenC;
+    while (i < lenP && j < end) {
+        bool takeP = pFirstOnTie ? !BLOCK_LESS(arr[j], arr[buf + i]) : BLOCK_LESS(arr[buf + i], arr[j]);
+        int from = takeP ? buf + i++ : j++;
+        int temp = arr[k];
+        arr[k++] = arr[from];
+        arr[from] = temp;
+    }
+    if (i < lenP) {
+        // C가 먼저 바닥남: 남은 P를 끝 [k, end)로
+        swapRange(arr, k, buf + i, lenP - i);
+        *pRemains = true;
+        return lenP - i;
+    }
+    *pRemains = false;
+    return end - j;
+}
+
+/*
+ * 회전 병합 (앞에서부터, 버퍼 없음): mergeForward와 같은 규칙으로 P = arr[p..p+lenP)와 바로 뒤의 C를 병합
+ * P 맨 앞 원소보다 먼저 올 C의 앞부분을 P 앞으로 회전시키고, C 맨 앞 원소보다 먼저 올 P의 앞부분은 확정하는 과정을 반복
+ * 반복 횟수는 두 구간의 서로 다른 값 수 이하이므로 이동량은 O(lenP × 값 종류 + lenC)
+ */
+static int mergeForwardInPlace(int arr[], int p, int lenP, int lenC, bool pFirstOnTie, bool *pRemains) {
+    int a = p, m = p + lenP, e = m + lenC;
+    while (a < m) {
+        int cut = pFirstOnTie ? lowerBound(arr, m, e, arr[a]) : upperBound(arr, m, e, arr[a]);
+        rotate(arr, a, m, cut);
+        a += cut - m;
+        m = cut;
+        if (m == e) {
+            *pRemains = true;
+            return e - a;
+        }
+        a = pFirstOnTie ? upperBound(arr, a, m, arr[m]) : lowerBound(arr, a, m, arr[m]);
+    }
+    *pRemains = false;
+    return e - m;
+}
+
+/*
+ * 회전 병합 (뒤에서부터, 버퍼 없음): 짧은 B = arr[m..e)를 A = arr[a..m)과 병합
+ * B 마지막 원소보다 큰 A의 끝부분을 맨 뒤로 회전시키고, A 마지막 원소 이상인 B의 끝부분은 확정하는 과정을 반복
+ * 이동량은 O(|A| + |B| × 값 종류)
+ */
+static void mergeBackwardInPlace(int arr[], int a, int m, int e) {
+    while (a < m && m < e) {
+        int cut = upperBound(arr, a, m, arr[e - 1]);
+        rotate(arr, cut, m, e);
+        e -= m - cut;
+        m = cut;
+        if (m == a)
+            break;
+        e = lowerBound(arr, m, e, arr[m - 1]);
     }
-    while (i < len1) {
-        arr[k++] = leftArr[i++];
+}
+
+// 버퍼 병합 (뒤에서부터): 짧은 B = arr[m..e)를 버퍼로 옮기고 A = arr[a..m)과 뒤에서부터 병합
+static void mergeBackward(int arr[], int a, int m, int e, int buf) {
+    int lenB = e - m;
+    swapRange(arr, buf, m, lenB);
+    int i = lenB - 1, j = m - 1, k = e - 1;
+    while (i >= 0 && j >= a) {
+        // 같은 값이면 B를 뒤에 (A 원소가 엄격히 클 때만 A를 뒤로)
+        int from = BLOCK_LESS(arr[buf + i], arr[j]) ? j-- : buf + i--;
+        int temp = arr[k];
+        arr[k--] = arr[from];
+        arr[from] = temp;
     }
-    while (j < len2) {
-        arr[k++] = rightArr[j++];
+    if (i >= 0)
+        swapRange(arr, k - i, buf, i + 1);
+}
+
+/*
+ * 블록 병합: A = arr[a..a+lenA) (lenA는 b의 배수), B = arr[a+lenA..a+lenA+lenB)
+ * tags: 정렬된 서로 다른 값 (A/B 블록 수 + 1개 이상), buf: 크기 b의 버퍼 (-1이면 버퍼 없이 회전으로 병합)
+ */
+static void blockMerge(int arr[], int a, int lenA, int lenB, int tags, int buf, int b) {
+    int blocksA = lenA / b, fullB = lenB / b;
+    int total = blocksA + fullB;
+    int blocksEnd = a + total * b;
+
+    if (fullB > 0) {
+        // a) 태그 t[i]는 처음 i번째 블록 것: t < midTag이면 A 블록 (태그는 블록과 함께 교환)
+        int midTag = arr[tags + blocksA];
+        for (int i = 0; i < total; i++) {
+            int min = i;
+            for (int j = i + 1; j < total; j++) {
+                int x = arr[a + j * b], y = arr[a + min * b];
+                if (BLOCK_LESS(x, y) || (!BLOCK_LESS(y, x) && BLOCK_LESS(arr[tags + j], arr[tags + min])))
+                    min = j;
+            }
+            if (min != i) {
+                swapRange(arr, a + i * b, a + min * b, b);
+                int temp = arr[tags + i];
+                arr[tags + i] = arr[tags + min];
+                arr[tags + min] = temp;
+            }
+        }
+
+        // b) 확정되지 않은 꼬리(pending)는 항상 현재 블록 끝에서 끝나는 한쪽 출처의 구간
+        int pendingLen = b;
+        bool pendingIsA = BLOCK_LESS(arr[tags], midTag);
+        for (int i = 1; i < total; i++) {
+            int start = a + i * b;
+            bool isA = BLOCK_LESS(arr[tags + i], midTag);
+            if (isA == pendingIsA) {
+                pendingLen = b;   // 같은 출처의 다음 블록: 이전 꼬리는 확정
+                continue;
+            }
+            bool pendingRemains;
+            if (buf >= 0)
+                pendingLen = mergeForward(arr, start - pendingLen, pendingLen, b, buf, pendingIsA, &pendingRemains);
+            else
+                pendingLen = mergeForwardInPlace(arr, start - pendingLen, pendingLen, b, pendingIsA, &pendingRemains);
+            if (!pendingRemains)
+                pendingIsA = isA;
+        }
+
+        // 섞인 태그를 다시 정렬 (다음 병합에서 다시 사용)
+        insertionSort(arr, tags, tags + total - 1);
+    }
+
+    // c) 블록으로 나누고 남은 B의 끝부분 (b 미만)
+    if (blocksEnd < a + lenA + lenB) {
+        if (buf >= 0)
+            mergeBackward(arr, a, blocksEnd, a + lenA + lenB, buf);
+        else
+            mergeBackwardInPlace(arr, a, blocksEnd, a + lenA + lenB);
     }
-    
-    free(leftArr);
-    free(rightArr);
 }
 
-// 블록 정렬 함수: 배열을 블록 단위로 정렬 후 병합하여 전체 정렬을 수행
+/*
+ * 서로 다른 값이 found(< want)개뿐일 때, 길이 len인 run 두 개를 병합할 블록 크기를 고름
+ * - 모은 값의 뒷부분 bb개(found/4 < bb <= found/2, 2의 거듭제곱)를 버퍼로, 앞부분을 태그로 써도 태그가 충분하면
+ *   크기 bb 블록의 버퍼 블록 병합 (*buf = found - bb)
+ * - 아니면 모은 값 전체를 태그로 쓰고, 블록 수가 found - 1 이하가 되도록 블록을 키워 버퍼 없이 병합 (*buf = -1)
+ * 반환: 블록 크기 (0이면 값 종류가 2개 이하: 회전 기반 제자리 병합으로 충분)
+ */
+static int fallbackBlockSize(int found, int len, int *buf) {
+    int bb = 1;
+    while (bb * 4 <= found)
+        bb *= 2;
+    if (bb * 2 <= found && 2LL * len / bb + 1 <= found - bb) {
+        *buf = found - bb;
+        return bb;
+    }
+    if (found < 3)
+        return 0;
+    int lb = 1;
+    while (2LL * len / lb + 1 > found)
+        lb *= 2;
+    *buf = -1;
+    return lb;
+}
+
+// 블록 정렬 함수: 배열 전체를 O(1) 추가 메모리로 안정 정렬
 void blockSort(int arr[], int n) {
-    // 블록 크기 정의 (예: 32)
-    int blockSize = 32;
-    
-    // 1단계: 각 블록별로 삽입 정렬 수행
-    for (int i = 0; i < n; i += blockSize) {
-        int right = (i + blockSize - 1 < n) ? i + blockSize - 1 : n - 1;
-        insertionSort(arr, i, right);
-    }
-    
-    // 2단계: 정렬된 블록들을 반복적으로 병합하여 전체 정렬 완성
-    for (int size = blockSize; size < n; size *= 2) {
-        for (int left = 0; left < n; left += 2 * size) {
-            int mid = left + size - 1;
-            if (mid >= n - 1)
+    if (n < MIN_BLOCK_SORT) {
+        insertionSort(arr, 0, n - 1);
+        return;
+    }
+
+    // 블록 크기 b >= √n (2의 거듭제곱), 한 번의 병합에 필요한 최대 블록 수만큼 태그 준비
+    int b = RUN_LENGTH;
+    while ((long long)b * b < n)
+        b *= 2;
+    int maxLen = RUN_LENGTH;
+    while (maxLen < n - maxLen)
+        maxLen *= 2;
+    int tagCount = 2 * maxLen / b + 1;
+    int want = tagCount + b;
+
+    int found = collectKeys(arr, n, want);
+    bool blockMode = found == want;
+    int tags = 0;
+    int buf = blockMode ? tagCount : 0;       // 버퍼 시작 위치
+    int bufSize = blockMode ? b : found;      // 값이 부족하면 모은 값 전체를 버퍼로
+    int start = found;                        // 정렬할 나머지 구간 [start, n)
+
+    // 짧은 run은 삽입 정렬
+    for (int s = start; s < n; s += RUN_LENGTH)
+        insertionSort(arr, s, (s + RUN_LENGTH < n ? s + RUN_LENGTH : n) - 1);
+
+    // 값이 부족할 때: 모은 값을 버퍼로 쓰면 순서가 섞이므로, 태그로 쓰기 전에 다시 정렬
+    bool keysScrambled = false;
+    int lastBuf = -2;
+
+    // run 길이를 2배씩 늘리며 병합
+    for (int len = RUN_LENGTH; len < n - start; len *= 2) {
+        int fbBlock = 0, fbBuf = -1;
+        if (!blockMode && len > bufSize) {
+            fbBlock = fallbackBlockSize(found, len, &fbBuf);
+            if (fbBlock > 0 && (keysScrambled || fbBuf != lastBuf)) {
+                insertionSort(arr, 0, found - 1);
+                keysScrambled = false;
+            }
+            lastBuf = fbBuf;
+        }
+        for (int a = start; a + len < n; a += 2 * len) {
+            int m = a + len, e = (m + len < n) ? m + len : n;
+            if (!BLOCK_LESS(arr[m], arr[m - 1]))
+                continue;                     // 이미 순서대로 이어짐
+            if (BLOCK_LESS(arr[e - 1], arr[a])) {
+                rotate(arr, a, m, e);         // B 전체가 A 전체보다 작음
                 continue;
-            int right = (left + 2 * size - 1 < n) ? left + 2 * size - 1 : n - 1;
-            merge(arr, left, mid, right);
+            }
+            if (len <= bufSize) {
+                bool unused;
+                mergeForward(arr, a, len, e - m, buf, true, &unused);
+                keysScrambled = !blockMode;
+            } else if (blockMode) {
+                blockMerge(arr, a, len, e - m, tags, buf, b);
+            } else if (fbBlock > 0) {
+                blockMerge(arr, a, len, e - m, tags, fbBuf, fbBlock);
+            } else {
+                mergeInPlace(arr, a, m, e);
+            }
         }
     }
+
+    // 버퍼(순서가 섞임)를 정렬하고 나머지와 병합
+    insertionSort(arr, 0, found - 1);
+    mergeInPlace(arr, 0, found, n);
 }
 
+#ifndef BLOCK_SORT_LIBRARY
+
 // 배열의 요소를 출력하는 함수
 void printArray(int arr[], int n) {
     for (int i = 0; i < n; i++) {
@@ -90,8 +393,44 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 대용량 벤치마크: 무작위/중복 많은 입력 정렬 시간과 결과 확인
+static void benchmark(int n) {
+    int *arr = (int *)malloc((size_t)n * sizeof(int));
+    if (arr == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    // 2048종: 서로 다른 값이 내부 버퍼에 필요한 수(약 3√n)보다 적어 값 부족 모드로 병합
+    const char *names[] = {"무작위", "중복 많음(16종)", "중복 많음(2048종)"};
+    const uint64_t kinds[] = {0, 16, 2048};
+    printf("\n%d개 정수 정렬 (추가 메모리 O(1)):\n", n);
+    for (int p = 0; p < 3; p++) {
+        uint64_t state = 88172645463325252ULL;
+        for (int i = 0; i < n; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            arr[i] = p == 0 ? (int)(state >> 33) : (int)(state % kinds[p]);
+        }
+        double start = nowSeconds();
+        blockSort(arr, n);
+        double elapsed = nowSeconds() - start;
+        bool sorted = true;
+        for (int i = 1; i < n && sorted; i++)
+            sorted = arr[i - 1] <= arr[i];
+        printf("  %s: %.3f초 %s\n", names[p], elapsed, sorted ? "" : "(정렬 실패!)");
+    }
+    free(arr);
+}
+
 // main 함수: 블록 정렬 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {42, 23, 4, 16, 8, 15, 9, 55, 0, 34, 12, 3, 28, 17, 6, 11};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -103,5 +442,9 @@ int main(void) {
     printf("정렬된 배열:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? atoi(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
+
+#endif /* BLOCK_SORT_LIBRARY */
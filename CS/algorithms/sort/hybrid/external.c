@@ -0,0 +1,702 @@
+/**
+ * external.c
+ *
+ * 외부 정렬 (External Merge Sort) 구현 예제
+ * - 메모리보다 큰 이진 key 파일(고정 크기 정수 key의 배열)을 오름차순으로 정렬합니다.
+ * - 메모리 사용량은 옵션(memoryBytes, 명령행 -m)으로 정합니다.
+ *
+ * 구성:
+ * 1) run 생성: 입력을 메모리 예산의 절반 크기 청크로 읽어 introSort(intro.c의 pdqsort)로 정렬한 뒤
+ *    임시 파일에 순서대로 기록합니다. 청크 하나를 정렬/기록하는 동안 다음 청크를 비동기로 미리 읽습니다.
+ *    (입력 전체가 청크 하나에 들어가면 임시 파일 없이 바로 출력합니다.)
+ * 2) k-way 병합: 각 run에서 현재 key를 최소 힙에 넣고 가장 작은 key를 차례로 내보냅니다.
+ *    run마다 블록 두 개(이중 버퍼)를 두어, 한 블록을 소비하는 동안 다른 블록을 POSIX AIO로 읽습니다.
+ *    출력도 블록 두 개를 번갈아 비동기로 기록합니다.
+ * 3) 다단계 병합: 메모리 예산 안에서 블록 크기를 MIN_MERGE_BLOCK 이상으로 유지할 수 있는 run 수(fan-in)보다
+ *    run이 많으면, fan-in개씩 묶어 병합한 결과를 다른 임시 파일에 쓰는 단계를 반복합니다.
+ *
+ * - 모든 run은 임시 파일 하나에 이어서 기록하고 (위치, 길이)로 구분하므로, run 수와 관계없이 파일 디스크립터는 몇 개뿐입니다.
+ * - 임시 파일은 만든 즉시 unlink하므로 비정상 종료 시에도 디스크에 남지 않습니다.
+ * - run 생성에 timSort(time.c) 대신 introSort를 쓰는 이유: key만 정렬하므로 안정성이 필요 없고,
+ *   이미 정렬된 입력은 introSort의 패턴 감지가 O(n)에 처리합니다. 또한 DEFINE_INTRO_SORT로 key 타입마다 정렬을 만들 수 있습니다.
+ *
+ * 컴파일 예시: gcc -O2 external.c -o external -lrt
+ * 실행 예시:
+ *   ./external                                   (테스트 파일을 만들어 작은 메모리로 정렬하는 데모)
+ *   ./external --generate keys.bin 100000000 -t u64
+ *   ./external keys.bin sorted.bin -t u64 -m 512 -d /tmp
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <aio.h>
+#include <sys/stat.h>
+
+#define INTRO_SORT_LIBRARY
+#include "intro.c"
+
+#define IO_ALIGN 4096                     // 블록/청크 크기 정렬 단위 (모든 key 크기의 배수)
+#define MIN_MERGE_BLOCK (64 * 1024)       // 병합 시 run당 블록의 최소 크기 (큰 순차 읽기 유지)
+#define MIN_MEMORY (1024 * 1024)          // 허용하는 최소 메모리 예산
+#define DEFAULT_MEMORY (256 * 1024 * 1024)
+
+// key 타입별 정렬/비교 함수
+DEFINE_INTRO_SORT(introSortI32, int32_t, INT_LESS)
+DEFINE_INTRO_SORT(introSortU32, uint32_t, INT_LESS)
+DEFINE_INTRO_SORT(introSortI64, int64_t, INT_LESS)
+DEFINE_INTRO_SORT(introSortU64, uint64_t, INT_LESS)
+
+static void sortI32(void *keys, size_t n) { introSortI32((int32_t *)keys, n); }
+static void sortU32(void *keys, size_t n) { introSortU32((uint32_t *)keys, n); }
+static void sortI64(void *keys, size_t n) { introSortI64((int64_t *)keys, n); }
+static void sortU64(void *keys, size_t n) { introSortU64((uint64_t *)keys, n); }
+
+static bool lessI32(const void *a, const void *b) { return INT_LESS((const int32_t *)a, (const int32_t *)b); }
+static bool lessU32(const void *a, const void *b) { return INT_LESS((const uint32_t *)a, (const uint32_t *)b); }
+static bool lessI64(const void *a, const void *b) { return INT_LESS((const int64_t *)a, (const int64_t *)b); }
+static bool lessU64(const void *a, const void *b) { return INT_LESS((const uint64_t *)a, (const uint64_t *)b); }
+
+// key 타입 정보 (파일은 호스트 바이트 순서의 고정 크기 정수 배열)
+typedef struct {
+    const char *name;
+    size_t size;
+    void (*sort)(void *keys, size_t n);
+    bool (*less)(const void *a, const void *b);
+} KeyOps;
+
+static const KeyOps KEY_TYPES[] = {
+    {"i32", 4, sortI32, lessI32},
+    {"u32", 4, sortU32, lessU32},
+    {"i64", 8, sortI64, lessI64},
+    {"u64", 8, sortU64, lessU64},
+};
+
+// 이름으로 key 타입 찾기 (없으면 NULL)
+const KeyOps *findKeyOps(const char *name) {
+    for (size_t i = 0; i < sizeof(KEY_TYPES) / sizeof(KEY_TYPES[0]); i++)
+        if (strcmp(KEY_TYPES[i].name, name) == 0)
+            return &KEY_TYPES[i];
+    return NULL;
+}
+
+// 외부 정렬 옵션
+typedef struct {
+    const KeyOps *keys;      // key 타입
+    size_t memoryBytes;      // 버퍼에 쓸 메모리 예산
+    const char *tempDir;     // 임시 파일 디렉터리
+} ExternalSortOptions;
+
+// 외부 정렬 통계
+typedef struct {
+    size_t runs;             // 생성된 초기 run 수
+    int mergePasses;         // 병합 단계 수 (0이면 메모리 안에서 정렬 완료)
+} ExternalSortStats;
+
+// 파일 안의 run 하나: [offset, offset + bytes)
+typedef struct {
+    off_t offset;
+    off_t bytes;
+} RunInfo;
+
+// 메모리 할당 (실패하면 종료)
+static void *xmalloc(size_t bytes) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        fprintf(stderr, "externalSort: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+static size_t alignDown(size_t value, size_t align) {
+    return value / align * align;
+}
+
+// 동기 입출력: 짧은 전송이 일어나도 끝까지 반복
+static bool preadFully(int fd, void *buf, size_t bytes, off_t offset) {
+    char *p = (char *)buf;
+    while (bytes > 0) {
+        ssize_t got = pread(fd, p, bytes, offset);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        p += got;
+        bytes -= (size_t)got;
+        offset += got;
+    }
+    return true;
+}
+
+static bool pwriteFully(int fd, const void *buf, size_t bytes, off_t offset) {
+    const char *p = (const char *)buf;
+    while (bytes > 0) {
+        ssize_t put = pwrite(fd, p, bytes, offset);
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return false;
+        p += put;
+        bytes -= (size_t)put;
+        offset += put;
+    }
+    return true;
+}
+
+/*
+ * 비동기 입출력 요청 하나 (POSIX AIO)
+ * aio 제출이 실패하면(EAGAIN 등) 완료를 기다리는 시점에 동기 입출력으로 대신 처리합니다.
+ */
+typedef struct {
+    struct aiocb cb;
+    bool pending;    // 제출되어 완료를 기다리는 중
+    bool deferred;   // 제출 실패: asyncFinish에서 동기로 처리
+    bool write;
+} AsyncOp;
+
+static void asyncStart(AsyncOp *op, bool write, int fd, void *buf, size_t bytes, off_t offset) {
+    memset(&op->cb, 0, sizeof(op->cb));
+    op->cb.aio_fildes = fd;
+    op->cb.aio_buf = buf;
+    op->cb.aio_nbytes = bytes;
+    op->cb.aio_offset = offset;
+    op->write = write;
+    op->pending = true;
+    op->deferred = (write ? aio_write(&op->cb) : aio_read(&op->cb)) != 0;
+}
+
+// 요청 완료 대기: 요청한 바이트를 모두 전송했으면 true
+static bool asyncFinish(AsyncOp *op) {
+    if (!op->pending)
+        return true;
+    op->pending = false;
+    char *buf = (char *)op->cb.aio_buf;
+    size_t bytes = op->cb.aio_nbytes;
+    off_t offset = op->cb.aio_offset;
+    size_t done = 0;
+    if (!op->deferred) {
+        const struct aiocb *list[1] = {&op->cb};
+        int err;
+        while ((err = aio_error(&op->cb)) == EINPROGRESS)
+            aio_suspend(list, 1, NULL);
+        ssize_t result = aio_return(&op->cb);
+        if (err != 0 || result < 0)
+            return false;
+        done = (size_t)result;
+    }
+    // 짧은 전송(또는 제출 실패)의 나머지는 동기로 마저 처리
+    if (done < bytes) {
+        return op->write ? pwriteFully(op->cb.aio_fildes, buf + done, bytes - done, offset + (off_t)done)
+                         : preadFully(op->cb.aio_fildes, buf + done, bytes - done, offset + (off_t)done);
+    }
+    return true;
+}
+
+// 임시 파일 생성: 만든 즉시 unlink하여 닫히면 자동으로 삭제되게 함
+static int openTempFile(const char *dir) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/extsort-XXXXXX", dir);
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        unlink(path);
+    return fd;
+}
+
+/* ---------- 병합: run 읽기(이중 버퍼)와 출력 쓰기(이중 버퍼) ---------- */
+
+typedef struct {
+    int fd;
+    off_t next, end;     // 다음에 읽을 위치, run의 끝
+    char *buf[2];        // 이중 버퍼
+    size_t len[2];       // 각 버퍼에 담긴(또는 읽는 중인) 바이트 수
+    int cur;             // 현재 소비 중인 버퍼
+    size_t pos;          // 현재 버퍼 안의 위치
+    size_t block, keySize;
+    AsyncOp op;          // 다른 버퍼로 진행 중인 읽기
+} RunReader;
+
+// 버퍼 which에 run의 다음 블록을 비동기로 읽기 시작
+static void readerRequest(RunReader *r, int which) {
+    off_t left = r->end - r->next;
+    size_t bytes = left < (off_t)r->block ? (size_t)left : r->block;
+    r->len[which] = bytes;
+    if (bytes == 0)
+        return;
+    asyncStart(&r->op, false, r->fd, r->buf[which], bytes, r->next);
+    r->next += (off_t)bytes;
+}
+
+static bool readerOpen(RunReader *r, int fd, RunInfo run, char *memory, size_t block, size_t keySize) {
+    r->fd = fd;
+    r->next = run.offset;
+    r->end = run.offset + run.bytes;
+    r->buf[0] = memory;
+    r->buf[1] = memory + block;
+    r->block = block;
+    r->keySize = keySize;
+    r->cur = 0;
+    r->pos = 0;
+    r->op.pending = false;
+    readerRequest(r, 0);
+    if (!asyncFinish(&r->op))
+        return false;
+    readerRequest(r, 1);
+    return true;
+}
+
+static inline const void *readerKey(const RunReader *r) {
+    return r->buf[r->cur] + r->pos;
+}
+
+// 다음 key로 이동: 1(성공), 0(run 끝), -1(입출력 오류)
+static int readerAdvance(RunReader *r) {
+    r->pos += r->keySize;
+    if (r->pos < r->len[r->cur])
+        return 1;
+    int other = r->cur ^ 1;
+    if (r->len[other] == 0)
+        return 0;
+    if (!asyncFinish(&r->op))
+        return -1;
+    r->cur = other;
+    r->pos = 0;
+    readerRequest(r, other ^ 1);   // 방금 다 쓴 버퍼로 그다음 블록 읽기
+    return 1;
+}
+
+typedef struct {
+    int fd;
+    off_t offset;        // 다음 블록을 기록할 파일 위치
+    char *buf[2];
+    size_t len, block;
+    int cur;
+    AsyncOp op;          // 다른 버퍼의 진행 중인 쓰기
+} RunWriter;
+
+static void writerOpen(RunWriter *w, int fd, off_t offset, char *memory, size_t block) {
+    w->fd = fd;
+    w->offset = offset;
+    w->buf[0] = memory;
+    w->buf[1] = memory + block;
+    w->len = 0;
+    w->block = block;
+    w->cur = 0;
+    w->op.pending = false;
+}
+
+// 현재 버퍼를 비동기로 기록하고 다른 버퍼로 전환 (그 버퍼의 이전 쓰기는 먼저 완료 대기)
+static bool writerFlush(RunWriter *w) {
+    if (w->len == 0)
+        return true;
+    if (!asyncFinish(&w->op))
+        return false;
+    asyncStart(&w->op, true, w->fd, w->buf[w->cur], w->len, w->offset);
+    w->offset += (off_t)w->len;
+    w->cur ^= 1;
+    w->len = 0;
+    return true;
+}
+
+static inline bool writerPut(RunWriter *w, const void *key, size_t keySize) {
+    memcpy(w->buf[w->cur] + w->len, key, keySize);
+    w->len += keySize;
+    return w->len < w->block || writerFlush(w);
+}
+
+static bool writerClose(RunWriter *w) {
+    return writerFlush(w) && asyncFinish(&w->op);
+}
+
+// 힙 비교: 현재 key가 작은 run이 우선 (같으면 앞 run 먼저)
+static inline bool readerLess(const KeyOps *ops, const RunReader *readers, size_t a, size_t b) {
+    if (ops->less(readerKey(&readers[a]), readerKey(&readers[b])))
+        return true;
+    return a < b && !ops->less(readerKey(&readers[b]), readerKey(&readers[a]));
+}
+
+static void heapSiftDown(const KeyOps *ops, const RunReader *readers, size_t *heap, size_t size, size_t i) {
+    size_t value = heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && readerLess(ops, readers, heap[child + 1], heap[child]))
+            child++;
+        if (!readerLess(ops, readers, heap[child], value))
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = value;
+}
+
+/*
+ * k-way 병합: inFd의 runs[0..count)를 outFd의 outOffset 위치에 하나의 정렬된 run으로 기록
+ * memory는 2 * (count + 1) * block 바이트 (run마다 이중 버퍼 + 출력 이중 버퍼)
+ */
+static bool mergeRuns(const KeyOps *ops, int inFd, const RunInfo *runs, size_t count,
+                      int outFd, off_t outOffset, char *memory, size_t block) {
+    RunReader *readers = (RunReader *)xmalloc(count * sizeof(RunReader));
+    memset(readers, 0, count * sizeof(RunReader));
+    size_t *heap = (size_t *)xmalloc(count * sizeof(size_t));
+    size_t heapSize = 0;
+    bool ok = true;
+
+    for (size_t i = 0; i < count && ok; i++) {
+        ok = readerOpen(&readers[i], inFd, runs[i], memory + 2 * i * block, block, ops->size);
+        if (ok && runs[i].bytes > 0)
+            heap[heapSize++] = i;
+    }
+    for (size_t i = heapSize / 2; ok && i-- > 0;)
+        heapSiftDown(ops, readers, heap, heapSize, i);
+
+    RunWriter writer;
+    writerOpen(&writer, outFd, outOffset, memory + 2 * count * block, block);
+    while (ok && heapSize > 0) {
+        RunReader *top = &readers[heap[0]];
+        ok = writerPut(&writer, readerKey(top), ops->size);
+        int status = readerAdvance(top);
+        if (status < 0)
+            ok = false;
+        else if (status == 0)
+            heap[0] = heap[--heapSize];
+        heapSiftDown(ops, readers, heap, heapSize, 0);
+    }
+    ok = writerClose(&writer) && ok;
+
+    // 오류로 중단했으면 진행 중인 읽기가 버퍼를 더 쓰지 않도록 완료를 기다림
+    for (size_t i = 0; i < count; i++)
+        asyncFinish(&readers[i].op);
+    free(readers);
+    free(heap);
+    return ok;
+}
+
+/* ---------- run 생성 ---------- */
+
+/*
+ * 입력을 chunk 크기씩 읽어 정렬한 뒤 runFd에 이어서 기록 (다음 청크는 비동기로 미리 읽음)
+ * 입력 전체가 청크 하나에 들어가면 outFd에 바로 기록하고 *count = 0
+ */
+static bool generateRuns(const KeyOps *ops, int inFd, off_t inBytes, int runFd, int outFd,
+                         size_t memoryBytes, RunInfo **runsOut, size_t *count) {
+    size_t chunk = alignDown(memoryBytes / 2, IO_ALIGN);
+    char *buf[2] = {(char *)xmalloc(chunk), (char *)xmalloc(chunk)};
+    size_t len[2] = {0, 0};
+    size_t capacity = 16;
+    RunInfo *runs = (RunInfo *)xmalloc(capacity * sizeof(RunInfo));
+    AsyncOp op = {.pending = false};
+    off_t next = 0, runOffset = 0;
+    int cur = 0;
+    bool ok = true;
+
+    *count = 0;
+    len[0] = inBytes < (off_t)chunk ? (size_t)inBytes : chunk;
+    if (len[0] > 0)
+        asyncStart(&op, false, inFd, buf[0], len[0], 0);
+    next = (off_t)len[0];
+
+    while (ok && len[cur] > 0) {
+        if (!asyncFinish(&op)) {
+            ok = false;
+            break;
+        }
+        // 다음 청크 읽기를 시작해 두고 현재 청크 정렬
+        int other = cur ^ 1;
+        off_t left = inBytes - next;
+        len[other] = left < (off_t)chunk ? (size_t)left : chunk;
+        if (len[other] > 0)
+            asyncStart(&op, false, inFd, buf[other], len[other], next);
+        next += (off_t)len[other];
+
+        ops->sort(buf[cur], len[cur] / ops->size);
+
+        if (*count == 0 && len[other] == 0) {
+            ok = pwriteFully(outFd, buf[cur], len[cur], 0);   // 메모리 안에서 정렬 완료
+            break;
+        }
+        if (*count == capacity) {
+            capacity *= 2;
+            RunInfo *grown = (RunInfo *)realloc(runs, capacity * sizeof(RunInfo));
+            if (grown == NULL) {
+                fprintf(stderr, "externalSort: 메모리 할당 실패\n");
+                exit(EXIT_FAILURE);
+            }
+            runs = grown;
+        }
+        ok = pwriteFully(runFd, buf[cur], len[cur], runOffset);
+        runs[*count].offset = runOffset;
+        runs[*count].bytes = (off_t)len[cur];
+        (*count)++;
+        runOffset += (off_t)len[cur];
+        cur = other;
+    }
+
+    asyncFinish(&op);
+    free(buf[0]);
+    free(buf[1]);
+    *runsOut = runs;
+    return ok;
+}
+
+/* ---------- 외부 정렬 인터페이스 ---------- */
+
+/*
+ * inputPath의 key 배열을 정렬하여 outputPath에 기록
+ * 성공하면 0, 실패하면 -1 (원인은 stderr에 출력)
+ */
+int externalSort(const char *inputPath, const char *outputPath, const ExternalSortOptions *options,
+                 ExternalSortStats *stats) {
+    const KeyOps *ops = options->keys;
+    size_t memoryBytes = options->memoryBytes;
+    ExternalSortStats local = {0, 0};
+    if (stats == NULL)
+        stats = &local;
+    if (memoryBytes < MIN_MEMORY) {
+        fprintf(stderr, "externalSort: 메모리 예산은 최소 %d바이트여야 합니다\n", MIN_MEMORY);
+        return -1;
+    }
+
+    int inFd = open(inputPath, O_RDONLY);
+    if (inFd < 0) {
+        fprintf(stderr, "externalSort: %s 열기 실패: %s\n", inputPath, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(inFd, &st) != 0 || st.st_size % (off_t)ops->size != 0) {
+        fprintf(stderr, "externalSort: %s의 크기가 key 크기(%zu바이트)의 배수가 아닙니다\n", inputPath, ops->size);
+        close(inFd);
+        return -1;
+    }
+    posix_fadvise(inFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    int outFd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int tempFd[2] = {openTempFile(options->tempDir), -1};
+    if (outFd < 0 || tempFd[0] < 0) {
+        fprintf(stderr, "externalSort: 출력/임시 파일 생성 실패: %s\n", strerror(errno));
+        close(inFd);
+        if (outFd >= 0)
+            close(outFd);
+        if (tempFd[0] >= 0)
+            close(tempFd[0]);
+        return -1;
+    }
+
+    RunInfo *runs = NULL;
+    size_t count = 0;
+    bool ok = generateRuns(ops, inFd, st.st_size, tempFd[0], outFd, memoryBytes, &runs, &count);
+    close(inFd);
+    stats->runs = count > 0 ? count : (st.st_size > 0 ? 1 : 0);
+    stats->mergePasses = 0;
+
+    // fan-in: run마다 MIN_MERGE_BLOCK 크기 이중 버퍼 + 출력 이중 버퍼가 메모리 예산에 들어가는 최대 run 수
+    size_t fanIn = memoryBytes / (2 * MIN_MERGE_BLOCK) - 1;
+    char *memory = count > 0 ? (char *)xmalloc(memoryBytes) : NULL;
+    int src = 0;
+
+    // 중간 병합 단계: fan-in개씩 묶어 다른 임시 파일로 병합
+    while (ok && count > fanIn) {
+        if (tempFd[1] < 0 && (tempFd[1] = openTempFile(options->tempDir)) < 0) {
+            ok = false;
+            break;
+        }
+        size_t block = alignDown(memoryBytes / (2 * (fanIn + 1)), IO_ALIGN);
+        size_t merged = 0;
+        off_t outOffset = 0;
+        for (size_t g = 0; ok && g < count; g += fanIn) {
+            size_t m = count - g < fanIn ? count - g : fanIn;
+            ok = mergeRuns(ops, tempFd[src], runs + g, m, tempFd[src ^ 1], outOffset, memory, block);
+            off_t bytes = 0;
+            for (size_t i = g; i < g + m; i++)
+                bytes += runs[i].bytes;
+            runs[merged].offset = outOffset;
+            runs[merged].bytes = bytes;
+            merged++;
+            outOffset += bytes;
+        }
+        count = merged;
+        src ^= 1;
+        stats->mergePasses++;
+    }
+
+    // 마지막 병합: 남은 run 전부를 출력 파일로
+    if (ok && count > 0) {
+        size_t block = alignDown(memoryBytes / (2 * (count + 1)), IO_ALIGN);
+        ok = mergeRuns(ops, tempFd[src], runs, count, outFd, 0, memory, block);
+        stats->mergePasses++;
+    }
+
+    if (!ok)
+        fprintf(stderr, "externalSort: 입출력 오류: %s\n", strerror(errno));
+    free(memory);
+    free(runs);
+    close(tempFd[0]);
+    if (tempFd[1] >= 0)
+        close(tempFd[1]);
+    if (close(outFd) != 0)
+        ok = false;
+    return ok ? 0 : -1;
+}
+
+/* ---------- 명령행 도구 / 데모 ---------- */
+
+static uint64_t nextRandom64(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 테스트용 무작위 key 파일 생성
+static bool generateFile(const char *path, size_t count, const KeyOps *ops) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+        return false;
+    uint64_t state = 88172645463325252ULL, block[4096];
+    for (size_t done = 0; done < count;) {
+        size_t n = count - done < 4096 ? count - done : 4096;
+        for (size_t i = 0; i < n; i++)
+            block[i] = nextRandom64(&state);
+        if (ops->size == 4) {
+            uint32_t *narrow = (uint32_t *)block;
+            for (size_t i = 0; i < n; i++)
+                narrow[i] = (uint32_t)block[i];
+        }
+        if (fwrite(block, ops->size, n, fp) != n) {
+            fclose(fp);
+            return false;
+        }
+        done += n;
+    }
+    return fclose(fp) == 0;
+}
+
+// 출력 파일 검증: 오름차순이고, key 합(mod 2^64)이 입력과 같은지
+static uint64_t keyBits(const KeyOps *ops, const char *p) {
+    if (ops->size == 4) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static bool checksumFile(const char *path, const KeyOps *ops, bool checkOrder, uint64_t *sum, size_t *count) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return false;
+    char buf[1 << 16], prev[8];
+    bool sorted = true, first = true;
+    size_t got;
+    *sum = 0;
+    *count = 0;
+    while ((got = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        for (size_t i = 0; i + ops->size <= got; i += ops->size) {
+            if (checkOrder && !first && ops->less(buf + i, prev))
+                sorted = false;
+            memcpy(prev, buf + i, ops->size);
+            first = false;
+            *sum += keyBits(ops, buf + i);
+            (*count)++;
+        }
+    }
+    fclose(fp);
+    return sorted;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "사용법: %s <입력> <출력> [-t i32|u32|i64|u64] [-m 메모리MiB] [-d 임시디렉터리]\n"
+            "        %s --generate <파일> <key 수> [-t 타입]\n"
+            "        %s                (데모)\n",
+            prog, prog, prog);
+}
+
+// 데모: 32MiB 파일을 1MiB 메모리로 정렬 (run 64개, 다단계 병합)
+static int demo(void) {
+    const char *dir = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp";
+    char input[4096], output[4096];
+    snprintf(input, sizeof(input), "%s/external-demo-in.bin", dir);
+    snprintf(output, sizeof(output), "%s/external-demo-out.bin", dir);
+    const KeyOps *ops = findKeyOps("u64");
+    size_t keys = 4 * 1024 * 1024;
+
+    if (!generateFile(input, keys, ops)) {
+        fprintf(stderr, "테스트 파일 생성 실패: %s\n", input);
+        return EXIT_FAILURE;
+    }
+    ExternalSortOptions options = {ops, MIN_MEMORY, dir};
+    ExternalSortStats stats;
+    printf("%zu개 u64 key (%zu MiB) 파일을 메모리 %zu KiB로 정렬\n", keys, keys * 8 >> 20, options.memoryBytes >> 10);
+    if (externalSort(input, output, &options, &stats) != 0)
+        return EXIT_FAILURE;
+
+    uint64_t inSum, outSum;
+    size_t inCount, outCount;
+    checksumFile(input, ops, false, &inSum, &inCount);
+    bool sorted = checksumFile(output, ops, true, &outSum, &outCount);
+    printf("run %zu개, 병합 단계 %d번: %s\n", stats.runs, stats.mergePasses,
+           sorted && inSum == outSum && inCount == outCount ? "정렬 확인" : "정렬 실패!");
+    unlink(input);
+    unlink(output);
+    return EXIT_SUCCESS;
+}
+
+// main 함수: 외부 정렬 명령행 도구
+int main(int argc, char *argv[]) {
+    if (argc == 1)
+        return demo();
+
+    const KeyOps *ops = findKeyOps("u64");
+    ExternalSortOptions options = {ops, DEFAULT_MEMORY, getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp"};
+    const char *positional[3];
+    int npos = 0;
+    bool generate = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--generate") == 0) {
+            generate = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            if ((options.keys = findKeyOps(argv[++i])) == NULL) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            options.memoryBytes = (size_t)strtoull(argv[++i], NULL, 10) << 20;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            options.tempDir = argv[++i];
+        } else if (npos < 3) {
+            positional[npos++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (npos != 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (generate) {
+        size_t count = (size_t)strtoull(positional[1], NULL, 10);
+        if (!generateFile(positional[0], count, options.keys)) {
+            fprintf(stderr, "%s 생성 실패\n", positional[0]);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    ExternalSortStats stats;
+    if (externalSort(positional[0], positional[1], &options, &stats) != 0)
+        return EXIT_FAILURE;
+    printf("정렬 완료: run %zu개, 병합 단계 %d번\n", stats.runs, stats.mergePasses);
+    return EXIT_SUCCESS;
+}
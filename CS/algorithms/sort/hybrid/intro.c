@@ -1,115 +1,521 @@
 /**
  * intro.c
  *
- * 최적화된 Introsort 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
- * - 초기에는 퀵 정렬을 사용하다가, 재귀 깊이가 한계에 도달하면 힙 정렬로 전환합니다.
+ * 최적화된 Introsort 구현 예제 (pattern-defeating quicksort, pdqsort 방식)
+ * - 배열의 요소를 오름차순으로 정렬합니다. (불안정 정렬)
+ * - 초기에는 퀵 정렬을 사용하다가, 분할이 한쪽으로 심하게 치우치는 일이 반복되면 힙 정렬로 전환합니다.
+ *   (깊이 제한 대신 "나쁜 분할" 횟수를 log2(n)번까지 허용 → 최악의 경우에도 O(n log n))
  * - 작은 구간에 대해서는 삽입 정렬을 적용하여 오버헤드를 줄입니다.
+ *
+ * 최적화:
+ * - 분기 없는 블록 분할 (BlockQuicksort): 왼쪽/오른쪽에서 BLOCK_SIZE개씩 원소를 피벗과 비교하여
+ *   "잘못된 쪽에 있는 원소의 오프셋"을 num += (비교 결과) 형태로 버퍼에 기록한 뒤, 모아서 교환합니다.
+ *   비교 결과가 분기가 아니라 덧셈으로 쓰이므로 무작위 데이터에서도 분기 예측 실패가 거의 없습니다.
+ * - 피벗 선택: 큰 구간은 ninther(세 중앙값의 중앙값), 작은 구간은 세 값의 중앙값
+ * - 대비책 힙 정렬은 4진 bottom-up 힙 정렬(heap.c 참고)로, 큰 구간에서도 레벨마다의 캐시 미스와 비교 횟수가 적습니다.
+ * - 패턴 감지:
+ *   - 배열 전체가 이미 정렬되어 있거나 역순이면 O(n)에 끝냅니다.
+ *   - 분할 중 교환이 하나도 없었으면 양쪽을 "제한된 삽입 정렬"로 마무리해 봅니다. (거의 정렬된 입력)
+ *   - 왼쪽 이웃(이전 피벗)과 같은 피벗을 고르면 피벗과 같은 원소를 한꺼번에 걸러냅니다. (중복이 많은 입력)
+ *   - 치우친 분할 뒤에는 몇 개 원소를 섞어 적대적 패턴을 깹니다.
+ * - 일반화된 인터페이스: DEFINE_INTRO_SORT(이름, 타입, 비교 매크로)로 원하는 타입(구조체 포함)에 대해
+ *   비교가 인라인된 정렬 함수를 생성합니다. (C++ 템플릿에 해당) key를 따로 뽑아 정렬할 필요가 없습니다.
+ *
+ * 컴파일 예시: gcc -O2 intro.c -o intro
+ * 실행 예시: ./intro 10000000   (1000만 개 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
 
-#define SIZE_THRESHOLD 16  // 작은 배열 구간에 대한 임계값
+#define SIZE_THRESHOLD 24           // 이보다 작은 구간은 삽입 정렬
+#define NINTHER_THRESHOLD 128       // 이보다 큰 구간은 ninther로 피벗 선택
+#define PARTIAL_INSERTION_LIMIT 8   // 제한된 삽입 정렬에서 허용하는 원소 이동 수
+#define BLOCK_SIZE 64               // 분기 없는 분할의 오프셋 버퍼 크기 (unsigned char 오프셋)
+#define INTRO_HEAP_ARITY 4          // 대비책 힙 정렬의 자식 수 (4진 힙: 이진 힙보다 레벨 수가 절반)
 
-// 두 정수의 값을 교환하는 유틸리티 함수
-static inline void swap(int *a, int *b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+// floor(log2(n)): 허용할 나쁜 분할 횟수
+static int floorLog2(size_t n) {
+    int log = 0;
+    while (n >>= 1)
+        log++;
+    return log;
 }
 
-// 삽입 정렬: arr[left..right] 구간을 오름차순으로 정렬
-void insertionSort(int arr[], int left, int right) {
-    for (int i = left + 1; i <= right; i++) {
-        int key = arr[i];
-        int j = i - 1;
-        while (j >= left && arr[j] > key) {
-            arr[j + 1] = arr[j];
-            j--;
-        }
-        arr[j + 1] = key;
-    }
+/*
+ * 정렬 함수 생성 매크로
+ * - NAME: 생성할 정렬 함수 이름, void NAME(T *arr, size_t n)
+ * - T: 원소 타입
+ * - LESS(a, b): 원소 포인터 a, b에 대해 *a < *b이면 참인 식 (구조체 전체를 복사하지 않도록 포인터로 비교)
+ *   인자를 여러 번 평가해도 되도록, 생성된 코드는 LESS에 부작용 있는 식을 넘기지 않습니다.
+ */
+#define DEFINE_INTRO_SORT(NAME, T, LESS)                                                          \
+static inline void NAME##Swap(T *a, T *b) {                                                       \
+    T temp = *a;                                                                                  \
+    *a = *b;                                                                                      \
+    *b = temp;                                                                                    \
+}                                                                                                 \
+                                                                                                  \
+static inline void NAME##Sort2(T *a, T *b) {                                                      \
+    if (LESS(b, a))                                                                               \
+        NAME##Swap(a, b);                                                                         \
+}                                                                                                 \
+                                                                                                  \
+/* 세 원소를 정렬: 가운데(b)가 중앙값이 됨 */                                                                    \
+static inline void NAME##Sort3(T *a, T *b, T *c) {                                                \
+    NAME##Sort2(a, b);                                                                            \
+    NAME##Sort2(b, c);                                                                            \
+    NAME##Sort2(a, b);                                                                            \
+}                                                                                                 \
+                                                                                                  \
+/* 삽입 정렬: [begin, end) */                                                                         \
+static void NAME##InsertionSort(T *begin, T *end) {                                               \
+    if (begin == end)                                                                             \
+        return;                                                                                   \
+    for (T *cur = begin + 1; cur != end; cur++) {                                                 \
+        T *sift = cur, *sift_1 = cur - 1;                                                         \
+        if (LESS(sift, sift_1)) {                                                                 \
+            T key = *sift;                                                                        \
+            do {                                                                                  \
+                *sift-- = *sift_1;                                                                \
+            } while (sift != begin && (--sift_1, LESS(&key, sift_1)));                            \
+            *sift = key;                                                                          \
+        }                                                                                         \
+    }                                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/* 경계 검사 없는 삽입 정렬: begin[-1]이 구간의 모든 원소 이하일 때만 사용 */                                              \
+static void NAME##UnguardedInsertionSort(T *begin, T *end) {                                      \
+    if (begin == end)                                                                             \
+        return;                                                                                   \
+    for (T *cur = begin + 1; cur != end; cur++) {                                                 \
+        T *sift = cur, *sift_1 = cur - 1;                                                         \
+        if (LESS(sift, sift_1)) {                                                                 \
+            T key = *sift;                                                                        \
+            do {                                                                                  \
+                *sift-- = *sift_1;                                                                \
+            } while (--sift_1, LESS(&key, sift_1));                                               \
+            *sift = key;                                                                          \
+        }                                                                                         \
+    }                                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/* 제한된 삽입 정렬: 이동이 PARTIAL_INSERTION_LIMIT를 넘으면 중단하고 false (거의 정렬된 구간 처리) */                       \
+static bool NAME##PartialInsertionSort(T *begin, T *end) {                                        \
+    if (begin == end)                                                                             \
+        return true;                                                                              \
+    size_t moved = 0;                                                                             \
+    for (T *cur = begin + 1; cur != end; cur++) {                                                 \
+        T *sift = cur, *sift_1 = cur - 1;                                                         \
+        if (LESS(sift, sift_1)) {                                                                 \
+            T key = *sift;                                                                        \
+            do {                                                                                  \
+                *sift-- = *sift_1;                                                                \
+            } while (sift != begin && (--sift_1, LESS(&key, sift_1)));                            \
+            *sift = key;                                                                          \
+            moved += (size_t)(cur - sift);                                                        \
+        }                                                                                         \
+        if (moved > PARTIAL_INSERTION_LIMIT)                                                      \
+            return false;                                                                         \
+    }                                                                                             \
+    return true;                                                                                  \
+}                                                                                                 \
+                                                                                                  \
+/* 4진 bottom-up sift: a[hole]을 빈 자리로 보고 value를 a[hole..n) 서브트리에 넣음 */                             \
+/* 빈 자리를 가장 큰 자식 쪽으로 잎까지 내린 뒤 value를 위로 올려 자리를 찾음 (heap.c와 같은 방식) */                              \
+static void NAME##SiftDown(T *a, size_t hole, size_t n, T value) {                                \
+    size_t top = hole, child;                                                                     \
+    while ((child = INTRO_HEAP_ARITY * hole + 1) < n) {                                           \
+        size_t grand = INTRO_HEAP_ARITY * child + 1, best;                                        \
+        if (grand < n)                                                                            \
+            __builtin_prefetch(&a[grand]);  /* 다음 레벨 자식 묶음을 미리 읽음 */                              \
+        if (child + INTRO_HEAP_ARITY <= n) {                                                      \
+            size_t m01 = LESS(&a[child], &a[child + 1]) ? child + 1 : child;                      \
+            size_t m23 = LESS(&a[child + 2], &a[child + 3]) ? child + 3 : child + 2;              \
+            best = LESS(&a[m01], &a[m23]) ? m23 : m01;                                            \
+        } else {                                                                                  \
+            best = child;                                                                         \
+            for (size_t k = child + 1; k < n; k++)                                                \
+                if (LESS(&a[best], &a[k]))                                                        \
+                    best = k;                                                                     \
+        }                                                                                         \
+        a[hole] = a[best];                                                                        \
+        hole = best;                                                                              \
+    }                                                                                             \
+    while (hole != top) {                                                                         \
+        size_t parent = (hole - 1) / INTRO_HEAP_ARITY;                                            \
+        if (!LESS(&a[parent], &value))                                                            \
+            break;                                                                                \
+        a[hole] = a[parent];                                                                      \
+        hole = parent;                                                                            \
+    }                                                                                             \
+    a[hole] = value;                                                                              \
+}                                                                                                 \
+                                                                                                  \
+/* 힙 정렬: [begin, end) (나쁜 분할이 너무 많을 때의 대비책, 최악 O(n log n)) */                                     \
+static void NAME##HeapSort(T *begin, T *end) {                                                    \
+    size_t n = (size_t)(end - begin);                                                             \
+    if (n < 2)                                                                                    \
+        return;                                                                                   \
+    for (size_t i = (n - 2) / INTRO_HEAP_ARITY + 1; i-- > 0;)                                     \
+        NAME##SiftDown(begin, i, n, begin[i]);                                                    \
+    for (size_t i = n; i-- > 1;) {                                                                \
+        T value = begin[i];                                                                       \
+        begin[i] = begin[0];                                                                      \
+        NAME##SiftDown(begin, 0, i, value);                                                       \
+    }                                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/* 오프셋 버퍼에 모인 잘못된 쪽 원소들을 교환 (개수가 같으면 일반 교환, 아니면 순환 이동으로 대입 횟수 절약) */                              \
+static inline void NAME##SwapOffsets(T *first, T *last, const unsigned char *offsets_l,           \
+                                     const unsigned char *offsets_r, size_t num, bool use_swaps) { \
+    if (use_swaps) {                                                                              \
+        /* 역순 입력에서 O(n)을 유지하려면 짝지어 교환해야 함 */                                                      \
+        for (size_t i = 0; i < num; i++)                                                          \
+            NAME##Swap(first + offsets_l[i], last - offsets_r[i]);                                \
+    } else if (num > 0) {                                                                         \
+        T *l = first + offsets_l[0], *r = last - offsets_r[0];                                    \
+        T temp = *l;                                                                              \
+        *l = *r;                                                                                  \
+        for (size_t i = 1; i < num; i++) {                                                        \
+            l = first + offsets_l[i];                                                             \
+            *r = *l;                                                                              \
+            r = last - offsets_r[i];                                                              \
+            *l = *r;                                                                              \
+        }                                                                                         \
+        *r = temp;                                                                                \
+    }                                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/*                                                                                                \
+ * 분기 없는 블록 분할: 피벗 *begin 기준으로 [begin, end)를 (< 피벗) | 피벗 | (>= 피벗)으로 나눔                           \
+ * 반환값은 피벗의 최종 위치, *already_partitioned는 교환이 전혀 없었는지 여부                                           \
+ */                                                                                               \
+static T *NAME##PartitionRight(T *begin, T *end, bool *already_partitioned) {                     \
+    T pivot = *begin;                                                                             \
+    T *first = begin, *last = end;                                                                \
+                                                                                                  \
+    /* 이미 제자리에 있는 양 끝 원소 건너뛰기 (중앙값 선택 덕분에 경계 검사가 필요 없음) */                                        \
+    while (++first, LESS(first, &pivot))                                                          \
+        ;                                                                                         \
+    if (first - 1 == begin)                                                                       \
+        while (first < last && (--last, !LESS(last, &pivot)))                                     \
+            ;                                                                                     \
+    else                                                                                          \
+        while (--last, !LESS(last, &pivot))                                                       \
+            ;                                                                                     \
+                                                                                                  \
+    *already_partitioned = first >= last;                                                         \
+    if (!*already_partitioned) {                                                                  \
+        NAME##Swap(first, last);                                                                  \
+        first++;                                                                                  \
+                                                                                                  \
+        _Alignas(64) unsigned char offsets_l[BLOCK_SIZE];                                         \
+        _Alignas(64) unsigned char offsets_r[BLOCK_SIZE];                                         \
+        T *offsets_l_base = first, *offsets_r_base = last;                                        \
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;                                    \
+                                                                                                  \
+        while (first < last) {                                                                    \
+            /* 비어 있는 쪽 버퍼만 채움: 남은 구간을 양쪽에 나눠 줌 */                                                 \
+            size_t num_unknown = (size_t)(last - first);                                          \
+            size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;    \
+            size_t right_split = num_r == 0 ? num_unknown - left_split : 0;                       \
+            if (left_split > BLOCK_SIZE)                                                          \
+                left_split = BLOCK_SIZE;                                                          \
+            if (right_split > BLOCK_SIZE)                                                         \
+                right_split = BLOCK_SIZE;                                                         \
+                                                                                                  \
+            /* 분기 없이 오프셋 기록: 조건이 참일 때만 num이 증가해 다음 칸으로 넘어감 */                                     \
+            for (size_t i = 0; i < left_split; i++) {                                             \
+                offsets_l[num_l] = (unsigned char)i;                                              \
+                num_l += !LESS(first, &pivot);                                                    \
+                first++;                                                                          \
+            }                                                                                     \
+            for (size_t i = 0; i < right_split; i++) {                                            \
+                offsets_r[num_r] = (unsigned char)(i + 1);                                        \
+                last--;                                                                           \
+                num_r += LESS(last, &pivot);                                                      \
+            }                                                                                     \
+                                                                                                  \
+            size_t num = num_l < num_r ? num_l : num_r;                                           \
+            NAME##SwapOffsets(offsets_l_base, offsets_r_base, offsets_l + start_l,                \
+                              offsets_r + start_r, num, num_l == num_r);                          \
+            num_l -= num;                                                                         \
+            num_r -= num;                                                                         \
+            start_l += num;                                                                       \
+            start_r += num;                                                                       \
+            if (num_l == 0) {                                                                     \
+                start_l = 0;                                                                      \
+                offsets_l_base = first;                                                           \
+            }                                                                                     \
+            if (num_r == 0) {                                                                     \
+                start_r = 0;                                                                      \
+                offsets_r_base = last;                                                            \
+            }                                                                                     \
+        }                                                                                         \
+                                                                                                  \
+        /* 한쪽 버퍼에 남은 원소들을 경계 쪽으로 옮김 */                                                            \
+        if (num_l) {                                                                              \
+            while (num_l--)                                                                       \
+                NAME##Swap(offsets_l_base + offsets_l[start_l + num_l], --last);                  \
+            first = last;                                                                         \
+        }                                                                                         \
+        if (num_r) {                                                                              \
+            while (num_r--) {                                                                     \
+                NAME##Swap(offsets_r_base - offsets_r[start_r + num_r], first);                   \
+                first++;                                                                          \
+            }                                                                                     \
+            last = first;                                                                         \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    T *pivot_pos = first - 1;                                                                     \
+    *begin = *pivot_pos;                                                                          \
+    *pivot_pos = pivot;                                                                           \
+    return pivot_pos;                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/* 피벗과 같은 원소를 왼쪽에 모으는 분할: (<= 피벗) | 피벗 | (> 피벗), 중복이 많은 구간용 */                                    \
+static T *NAME##PartitionLeft(T *begin, T *end) {                                                 \
+    T pivot = *begin;                                                                             \
+    T *first = begin, *last = end;                                                                \
+    while (--last, LESS(&pivot, last))                                                            \
+        ;                                                                                         \
+    if (last + 1 == end)                                                                          \
+        while (first < last && (++first, !LESS(&pivot, first)))                                   \
+            ;                                                                                     \
+    else                                                                                          \
+        while (++first, !LESS(&pivot, first))                                                     \
+            ;                                                                                     \
+    while (first < last) {                                                                        \
+        NAME##Swap(first, last);                                                                  \
+        while (--last, LESS(&pivot, last))                                                        \
+            ;                                                                                     \
+        while (++first, !LESS(&pivot, first))                                                     \
+            ;                                                                                     \
+    }                                                                                             \
+    *begin = *last;                                                                               \
+    *last = pivot;                                                                                \
+    return last;                                                                                  \
+}                                                                                                 \
+                                                                                                  \
+/* Introsort의 재귀적 유틸리티 함수: 왼쪽은 재귀, 오른쪽은 반복 */                                                     \
+static void NAME##Loop(T *begin, T *end, int bad_allowed, bool leftmost) {                        \
+    for (;;) {                                                                                    \
+        size_t size = (size_t)(end - begin);                                                      \
+        if (size < SIZE_THRESHOLD) {                                                              \
+            if (leftmost)                                                                         \
+                NAME##InsertionSort(begin, end);                                                  \
+            else                                                                                  \
+                NAME##UnguardedInsertionSort(begin, end);                                         \
+            return;                                                                               \
+        }                                                                                         \
+                                                                                                  \
+        /* 피벗 선택: 결과 피벗은 *begin에 놓임 */                                                            \
+        size_t s2 = size / 2;                                                                     \
+        if (size > NINTHER_THRESHOLD) {                                                           \
+            NAME##Sort3(begin, begin + s2, end - 1);                                              \
+            NAME##Sort3(begin + 1, begin + (s2 - 1), end - 2);                                    \
+            NAME##Sort3(begin + 2, begin + (s2 + 1), end - 3);                                    \
+            NAME##Sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));                          \
+            NAME##Swap(begin, begin + s2);                                                        \
+        } else {                                                                                  \
+            NAME##Sort3(begin + s2, begin, end - 1);                                              \
+        }                                                                                         \
+                                                                                                  \
+        /* 왼쪽 이웃(이전 피벗)과 같은 피벗이면 이 구간에 피벗보다 작은 원소가 없음 → 같은 값들 제거 */                               \
+        if (!leftmost && !LESS(begin - 1, begin)) {                                               \
+            begin = NAME##PartitionLeft(begin, end) + 1;                                          \
+            continue;                                                                             \
+        }                                                                                         \
+                                                                                                  \
+        bool already_partitioned;                                                                 \
+        T *pivot_pos = NAME##PartitionRight(begin, end, &already_partitioned);                    \
+        size_t l_size = (size_t)(pivot_pos - begin);                                              \
+        size_t r_size = (size_t)(end - (pivot_pos + 1));                                          \
+                                                                                                  \
+        if (l_size < size / 8 || r_size < size / 8) {                                             \
+            /* 치우친 분할: 횟수가 한도를 넘으면 힙 정렬, 아니면 원소를 섞어 패턴을 깸 */                                      \
+            if (--bad_allowed == 0) {                                                             \
+                NAME##HeapSort(begin, end);                                                       \
+                return;                                                                           \
+            }                                                                                     \
+            if (l_size >= SIZE_THRESHOLD) {                                                       \
+                NAME##Swap(begin, begin + l_size / 4);                                            \
+                NAME##Swap(pivot_pos - 1, pivot_pos - l_size / 4);                                \
+                if (l_size > NINTHER_THRESHOLD) {                                                 \
+                    NAME##Swap(begin + 1, begin + (l_size / 4 + 1));                              \
+                    NAME##Swap(begin + 2, begin + (l_size / 4 + 2));                              \
+                    NAME##Swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));                      \
+                    NAME##Swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));                      \
+                }                                                                                 \
+            }                                                                                     \
+            if (r_size >= SIZE_THRESHOLD) {                                                       \
+                NAME##Swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));                          \
+                NAME##Swap(end - 1, end - r_size / 4);                                            \
+                if (r_size > NINTHER_THRESHOLD) {                                                 \
+                    NAME##Swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));                      \
+                    NAME##Swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));                      \
+                    NAME##Swap(end - 2, end - (1 + r_size / 4));                                  \
+                    NAME##Swap(end - 3, end - (2 + r_size / 4));                                  \
+                }                                                                                 \
+            }                                                                                     \
+        } else if (already_partitioned && NAME##PartialInsertionSort(begin, pivot_pos) &&         \
+                   NAME##PartialInsertionSort(pivot_pos + 1, end)) {                              \
+            /* 교환 없이 분할되었고 양쪽이 거의 정렬되어 있었음 */                                                     \
+            return;                                                                               \
+        }                                                                                         \
+                                                                                                  \
+        NAME##Loop(begin, pivot_pos, bad_allowed, leftmost);                                      \
+        begin = pivot_pos + 1;                                                                    \
+        leftmost = false;                                                                         \
+    }                                                                                             \
+}                                                                                                 \
+                                                                                                  \
+/* 정렬 인터페이스: arr[0..n)을 정렬 */                                                                     \
+void NAME(T *arr, size_t n) {                                                                     \
+    if (n < 2)                                                                                    \
+        return;                                                                                   \
+    /* 첫 run 감지: 전체가 오름차순이면 끝, 전체가 엄격한 내림차순이면 뒤집고 끝 */                                            \
+    size_t run = 1;                                                                               \
+    if (LESS(&arr[1], &arr[0])) {                                                                 \
+        while (run < n && LESS(&arr[run], &arr[run - 1]))                                         \
+            run++;                                                                                \
+        if (run == n) {                                                                           \
+            for (size_t i = 0, j = n - 1; i < j; i++, j--)                                        \
+                NAME##Swap(&arr[i], &arr[j]);                                                     \
+            return;                                                                               \
+        }                                                                                         \
+    } else {                                                                                      \
+        while (run < n && !LESS(&arr[run], &arr[run - 1]))                                        \
+            run++;                                                                                \
+        if (run == n)                                                                             \
+            return;                                                                               \
+    }                                                                                             \
+    NAME##Loop(arr, arr + n, floorLog2(n), true);                                                 \
 }
 
-// 퀵 정렬에서 사용하는 partition 함수: 피벗을 기준으로 배열을 분할
-int partition(int arr[], int low, int high) {
-    int pivot = arr[high];
-    int i = low - 1;
-    for (int j = low; j < high; j++) {
-        if (arr[j] <= pivot) {
-            i++;
-            swap(&arr[i], &arr[j]);
-        }
-    }
-    swap(&arr[i + 1], &arr[high]);
-    return i + 1;
+// int 정렬 (비교가 인라인되므로 블록 분할의 내부 루프에 분기가 없음)
+#define INT_LESS(a, b) (*(a) < *(b))
+DEFINE_INTRO_SORT(introSortInt, int, INT_LESS)
+
+// Introsort 인터페이스: 배열 arr를 n 크기 기준으로 정렬
+void introSort(int arr[], int n) {
+    introSortInt(arr, n > 0 ? (size_t)n : 0);
 }
 
-// 힙 정렬을 위한 max-heapify 함수: arr 배열에서 인덱스 i를 루트로 하는 서브트리를 힙화 (n은 배열 크기)
-void maxHeapify(int arr[], int n, int i, int start) {
-    int largest = i;
-    int left = 2 * (i - start) + 1 + start;
-    int right = 2 * (i - start) + 2 + start;
-
-    if (left < n && arr[left] > arr[largest])
-        largest = left;
-    if (right < n && arr[right] > arr[largest])
-        largest = right;
-    if (largest != i) {
-        swap(&arr[i], &arr[largest]);
-        maxHeapify(arr, n, largest, start);
+// 구조체 정렬 예시: key를 따로 뽑지 않고 레코드를 직접 정렬 (key가 같으면 id 순)
+typedef struct {
+    int64_t key;
+    uint32_t id;
+    char tag[4];
+} Record;
+
+#define RECORD_LESS(a, b) ((a)->key < (b)->key || ((a)->key == (b)->key && (a)->id < (b)->id))
+DEFINE_INTRO_SORT(introSortRecords, Record, RECORD_LESS)
+
+// 배열의 요소를 출력하는 유틸리티 함수
+void printArray(int arr[], int n) {
+    for (int i = 0; i < n; i++) {
+         printf("%d ", arr[i]);
     }
+    printf("\n");
 }
 
-// 힙 정렬: arr[start..end] 구간을 힙 정렬로 정렬
-void heapSort(int arr[], int start, int end) {
-    int n = end + 1;
-    // 최대 힙 구축: 내부 노드에서부터 시작
-    for (int i = (start + n) / 2 - 1; i >= start; i--) {
-        maxHeapify(arr, n, i, start);
-    }
-    // 힙 정렬: 루트(최대값)를 맨 뒤로 보내고 힙 재구성
-    for (int i = end; i > start; i--) {
-        swap(&arr[start], &arr[i]);
-        maxHeapify(arr, i, start, start);
-    }
+// 다른 예제(external.c 등)에서 #include "intro.c"로 정렬 함수만 가져다 쓸 때는 INTRO_SORT_LIBRARY를 정의하여 데모를 제외
+#ifndef INTRO_SORT_LIBRARY
+
+// 벤치마크용 비교 함수 (qsort)
+static int compareInt(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
 }
 
-// Introsort의 재귀적 유틸리티 함수
-void introsortUtil(int arr[], int start, int end, int depthLimit) {
-    int size = end - start + 1;
-    if (size < SIZE_THRESHOLD) {
-        insertionSort(arr, start, end);
-        return;
-    }
-    if (depthLimit == 0) {
-        // 깊이 제한에 도달하면 힙 정렬로 전환
-        heapSort(arr, start, end);
-        return;
-    }
-    int pivotIndex = partition(arr, start, end);
-    introsortUtil(arr, start, pivotIndex - 1, depthLimit - 1);
-    introsortUtil(arr, pivotIndex + 1, end, depthLimit - 1);
+static int compareRecord(const void *a, const void *b) {
+    const Record *x = (const Record *)a, *y = (const Record *)b;
+    return RECORD_LESS(y, x) - RECORD_LESS(x, y);
 }
 
-// Introsort 인터페이스: 배열 arr를 n 크기 기준으로 정렬
-void introSort(int arr[], int n) {
-    int depthLimit = 2 * (int)log(n);
-    introsortUtil(arr, 0, n - 1, depthLimit);
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
 }
 
-// 배열의 요소를 출력하는 유틸리티 함수
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; i++) {
-         printf("%d ", arr[i]);
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 대용량 벤치마크: 입력 패턴별로 introSort와 qsort 비교
+static void benchmark(size_t n) {
+    int *original = (int *)malloc(n * sizeof(int));
+    int *arr = (int *)malloc(n * sizeof(int));
+    int *expected = (int *)malloc(n * sizeof(int));
+    Record *records = (Record *)malloc(n * sizeof(Record));
+    Record *records_expected = (Record *)malloc(n * sizeof(Record));
+    if (original == NULL || arr == NULL || expected == NULL || records == NULL || records_expected == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
     }
-    printf("\n");
+
+    const char *patterns[] = {"무작위", "정렬됨", "역순", "중복 많음(16종)", "산 모양", "끝만 흐트러짐"};
+    printf("\n%zu개 정수 정렬 (introSort / qsort):\n", n);
+    for (int p = 0; p < 6; p++) {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < n; i++) {
+            switch (p) {
+            case 0: original[i] = (int)nextRandom(&state); break;
+            case 1: original[i] = (int)i; break;
+            case 2: original[i] = (int)(n - i); break;
+            case 3: original[i] = (int)(nextRandom(&state) % 16); break;
+            case 4: original[i] = (int)(i < n / 2 ? i : n - i); break;
+            default: original[i] = i + 16 < n ? (int)i : (int)nextRandom(&state); break;
+            }
+        }
+        memcpy(arr, original, n * sizeof(int));
+        memcpy(expected, original, n * sizeof(int));
+        double start = nowSeconds();
+        introSort(arr, (int)n);
+        double intro_time = nowSeconds() - start;
+        start = nowSeconds();
+        qsort(expected, n, sizeof(int), compareInt);
+        double qsort_time = nowSeconds() - start;
+        bool ok = memcmp(arr, expected, n * sizeof(int)) == 0;
+        printf("  %-22s %.3f초 / %.3f초 %s\n", patterns[p], intro_time, qsort_time, ok ? "" : "(정렬 실패!)");
+    }
+
+    uint64_t state = 2463534242ULL;
+    for (size_t i = 0; i < n; i++) {
+        records[i].key = (int64_t)(nextRandom(&state) % (n / 4 + 1));
+        records[i].id = (uint32_t)i;
+        memcpy(records[i].tag, "rec", 4);
+    }
+    memcpy(records_expected, records, n * sizeof(Record));
+    double start = nowSeconds();
+    introSortRecords(records, n);
+    double intro_time = nowSeconds() - start;
+    start = nowSeconds();
+    qsort(records_expected, n, sizeof(Record), compareRecord);
+    double qsort_time = nowSeconds() - start;
+    bool ok = memcmp(records, records_expected, n * sizeof(Record)) == 0;
+    printf("  %-22s %.3f초 / %.3f초 %s\n", "레코드(16바이트)", intro_time, qsort_time, ok ? "" : "(정렬 실패!)");
+
+    free(original);
+    free(arr);
+    free(expected);
+    free(records);
+    free(records_expected);
 }
 
 // main 함수: Introsort 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {24, 97, 40, 67, 88, 85, 15, 66, 53, 44, 26, 48, 16};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -121,5 +527,17 @@ int main(void) {
     printf("정렬된 배열:\n");
     printArray(arr, n);
 
+    Record records[] = {{42, 0, "c"}, {-7, 1, "a"}, {42, 2, "d"}, {3, 3, "b"}, {-7, 4, "a2"}};
+    size_t count = sizeof(records) / sizeof(records[0]);
+    introSortRecords(records, count);
+    printf("\n레코드 정렬 (key, id):\n");
+    for (size_t i = 0; i < count; i++)
+        printf("(%lld, %u, %s) ", (long long)records[i].key, records[i].id, records[i].tag);
+    printf("\n");
+
+    benchmark(argc > 1 ? (size_t)atol(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
+
+#endif /* INTRO_SORT_LIBRARY */
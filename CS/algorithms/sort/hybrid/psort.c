@@ -2,19 +2,34 @@
  * psort.c
  *
  * 최적화된 PSort 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
+ * - 배열의 요소를 오름차순으로 정렬합니다. (안정 정렬)
  * - 본 예제에서는 병렬 병합 정렬(parallel merge sort)을 활용하여,
  *   여러 코어를 활용한 병렬 정렬을 구현합니다.
  *
+ * 병렬화 구조:
+ * - 정렬: 두 절반을 OpenMP 태스크로 나누어 동시에 정렬합니다.
+ *   (OpenMP 런타임의 태스크 큐가 유휴 스레드에 남은 태스크를 나눠 주는 작업 풀 역할을 합니다.)
+ * - 병합도 병렬: 출력 배열을 MERGE_CHUNK 크기 구간으로 나누고, 각 구간의 시작 위치가
+ *   두 입력의 어디에 대응하는지를 co-rank(이진 탐색)로 구한 뒤 구간별로 독립적인 태스크로 병합합니다.
+ *   따라서 최상위 병합(n개)도 한 스레드가 혼자 처리하지 않습니다.
+ * - 메모리: 정렬 시작 시 n 크기의 보조 버퍼를 한 번만 할당하고, 재귀 단계마다 원본 ↔ 보조 버퍼 방향을
+ *   번갈아(ping-pong) 병합합니다. 병합 과정에서 malloc/복사가 없습니다.
+ *
  * 참고: 이 구현은 OpenMP를 사용하여 병렬 태스크를 생성합니다.
  *       컴파일 시 -fopenmp 옵션을 사용해야 합니다.
+ *       컴파일 예시: gcc -O2 -fopenmp psort.c -o psort
+ *       실행 예시: ./psort 100000000   (1억 개 정수 정렬 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 #include <omp.h>
 
-#define THRESHOLD 32  // 배열 구간의 크기가 THRESHOLD 이하이면 삽입 정렬을 사용
+#define THRESHOLD 32           // 배열 구간의 크기가 THRESHOLD 이하이면 삽입 정렬을 사용
+#define SORT_TASK_CUTOFF 8192  // 이보다 작은 구간은 태스크를 만들지 않고 현재 스레드에서 정렬
+#define MERGE_CHUNK 65536      // 병렬 병합에서 태스크 하나가 만드는 출력 원소 수
 
 // 삽입 정렬: arr[left..right] 구간을 오름차순으로 정렬
 void insertionSort(int arr[], int left, int right) {
@@ -29,70 +44,114 @@ void insertionSort(int arr[], int left, int right) {
     }
 }
 
-// 두 정렬된 구간을 병합하는 함수: arr[left..mid]와 arr[mid+1..right] 병합
-void merge(int arr[], int left, int mid, int right) {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-    
-    int *leftArr = (int *)malloc(n1 * sizeof(int));
-    int *rightArr = (int *)malloc(n2 * sizeof(int));
-    
-    for (int i = 0; i < n1; i++) {
-        leftArr[i] = arr[left + i];
-    }
-    for (int j = 0; j < n2; j++) {
-        rightArr[j] = arr[mid + 1 + j];
+// 두 정렬된 배열 a[0..na), b[0..nb)를 out으로 병합 (같은 값이면 a를 먼저: 안정)
+static void mergeSerial(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] <= b[j])
+            out[k++] = a[i++];
+        else
+            out[k++] = b[j++];
     }
-    
-    int i = 0, j = 0, k = left;
-    while (i < n1 && j < n2) {
-        if (leftArr[i] <= rightArr[j])
-            arr[k++] = leftArr[i++];
+    if (i < na)
+        memcpy(out + k, a + i, (na - i) * sizeof(int));
+    if (j < nb)
+        memcpy(out + k, b + j, (nb - j) * sizeof(int));
+}
+
+/*
+ * co-rank: 병합 결과의 앞 k개가 a[0..i)와 b[0..k-i)로 이루어지는 i를 이진 탐색으로 찾음
+ * "a[i] <= b[k-i-1]이면 a[i]도 앞 k개에 들어가야 하므로 i가 너무 작다"는 조건이 i에 대해 단조이므로,
+ * 이 조건이 거짓이 되는 가장 작은 i가 답입니다. (같은 값은 a 쪽이 먼저 → mergeSerial과 같은 안정 순서)
+ */
+static size_t coRank(size_t k, const int *a, size_t na, const int *b, size_t nb) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = k < na ? k : na;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        if (j > 0 && a[i] <= b[j - 1])
+            lo = i + 1;
         else
-            arr[k++] = rightArr[j++];
+            hi = i;
     }
-    while (i < n1) {
-        arr[k++] = leftArr[i++];
+    return lo;
+}
+
+/*
+ * 병렬 병합: 출력 out[0..na+nb)를 MERGE_CHUNK 크기 구간으로 나누어 구간마다 태스크 하나
+ * 구간 [begin, end)의 입력 범위는 coRank(begin), coRank(end)로 정해지므로 태스크끼리 겹치지 않음
+ */
+static void parallelMerge(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    size_t n = na + nb;
+    if (n <= MERGE_CHUNK) {
+        mergeSerial(a, na, b, nb, out);
+        return;
     }
-    while (j < n2) {
-        arr[k++] = rightArr[j++];
+    for (size_t begin = 0; begin < n; begin += MERGE_CHUNK) {
+        #pragma omp task firstprivate(begin)
+        {
+            size_t end = begin + MERGE_CHUNK < n ? begin + MERGE_CHUNK : n;
+            size_t i0 = coRank(begin, a, na, b, nb);
+            size_t i1 = coRank(end, a, na, b, nb);
+            mergeSerial(a + i0, i1 - i0, b + (begin - i0), (end - i1) - (begin - i0), out + begin);
+        }
     }
-    
-    free(leftArr);
-    free(rightArr);
+    #pragma omp taskwait
 }
 
-// 병렬 병합 정렬 함수: arr[left..right] 구간을 정렬
-void parallelMergeSort(int arr[], int left, int right) {
-    if (right - left + 1 <= THRESHOLD) {
-        insertionSort(arr, left, right);
+/*
+ * 병렬 병합 정렬 함수: src[0..n) 구간을 정렬
+ * 결과는 toDst가 true이면 dst에, false이면 src에 놓입니다. (dst는 같은 위치의 보조 버퍼)
+ * 두 절반은 반대 방향으로 정렬해 두고, 그 둘을 원하는 쪽으로 병합하므로 단계마다 복사가 없습니다.
+ */
+void parallelMergeSort(int *src, int *dst, size_t n, bool toDst) {
+    if (n <= THRESHOLD) {
+        insertionSort(src, 0, (int)n - 1);
+        if (toDst)
+            memcpy(dst, src, n * sizeof(int));
         return;
     }
-    
-    int mid = left + (right - left) / 2;
-    
-    // 병렬 태스크 생성: 두 부분을 동시에 정렬
-    #pragma omp task shared(arr) if (right - left > THRESHOLD)
-    {
-        parallelMergeSort(arr, left, mid);
-    }
-    #pragma omp task shared(arr) if (right - left > THRESHOLD)
-    {
-        parallelMergeSort(arr, mid + 1, right);
+
+    size_t half = n / 2;
+
+    // 병렬 태스크 생성: 두 부분을 동시에 정렬 (작은 구간은 태스크 생성 비용이 더 크므로 직접 호출)
+    if (n > SORT_TASK_CUTOFF) {
+        #pragma omp task
+        parallelMergeSort(src, dst, half, !toDst);
+        #pragma omp task
+        parallelMergeSort(src + half, dst + half, n - half, !toDst);
+        #pragma omp taskwait
+    } else {
+        parallelMergeSort(src, dst, half, !toDst);
+        parallelMergeSort(src + half, dst + half, n - half, !toDst);
     }
-    #pragma omp taskwait
-    merge(arr, left, mid, right);
+
+    const int *from = toDst ? src : dst;
+    int *to = toDst ? dst : src;
+    if (n > SORT_TASK_CUTOFF)
+        parallelMerge(from, half, from + half, n - half, to);
+    else
+        mergeSerial(from, half, from + half, n - half, to);
 }
 
-// PSort 인터페이스 함수: 전체 배열을 정렬
+// PSort 인터페이스 함수: 전체 배열을 정렬 (보조 버퍼는 여기서 한 번만 할당)
 void pSort(int arr[], int n) {
+    if (n <= 1)
+        return;
+    int *buffer = (int *)malloc((size_t)n * sizeof(int));
+    if (buffer == NULL) {
+        fprintf(stderr, "pSort: 보조 버퍼 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
     #pragma omp parallel
     {
         #pragma omp single
         {
-            parallelMergeSort(arr, 0, n - 1);
+            parallelMergeSort(arr, buffer, (size_t)n, false);
         }
     }
+    free(buffer);
 }
 
 // 배열의 요소를 출력하는 유틸리티 함수
@@ -103,8 +162,41 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 대용량 벤치마크: 스레드 수를 바꿔 가며 n개의 난수 정수를 정렬
+static void benchmark(int n) {
+    int *original = (int *)malloc((size_t)n * sizeof(int));
+    int *arr = (int *)malloc((size_t)n * sizeof(int));
+    if (original == NULL || arr == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        original[i] = (int)(seed >> 1);
+    }
+
+    int max_threads = omp_get_max_threads();
+    printf("\n%d개 정수 정렬 (최대 스레드 %d개):\n", n, max_threads);
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        memcpy(arr, original, (size_t)n * sizeof(int));
+        omp_set_num_threads(threads);
+        double start = omp_get_wtime();
+        pSort(arr, n);
+        double elapsed = omp_get_wtime() - start;
+        bool sorted = true;
+        for (int i = 1; i < n && sorted; i++)
+            sorted = arr[i - 1] <= arr[i];
+        printf("  스레드 %2d개: %.3f초 %s\n", threads, elapsed, sorted ? "" : "(정렬 실패!)");
+        if (threads == max_threads)   // 1, 2, 4, ... 마지막은 최대 스레드 수
+            break;
+    }
+    free(original);
+    free(arr);
+}
+
 // main 함수: PSort 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {45, 23, 53, 12, 87, 34, 9, 76, 41, 3, 68, 29, 100, 56};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -116,5 +208,7 @@ int main(void) {
     printf("정렬된 배열:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? atoi(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
@@ -8,12 +8,35 @@
  * - 작은 구간(THRESHOLD 이하)은 삽입 정렬로 처리하여 오버헤드를 줄입니다.
  *
  * 이 구현은 추가 메모리를 사용하지만, 안정성과 성능을 동시에 고려한 하이브리드 정렬 기법의 한 예입니다.
+ *
+ * 병렬 샘플 정렬 모드 (quickMergeSortParallel):
+ * - 표본 추출: 구간(bucket) 수 k(스레드 수의 8배 이상, 2의 거듭제곱)에 대해 k * OVERSAMPLING개의 표본을 뽑아 정렬하고,
+ *   k-1개의 분할값(splitter)을 고릅니다. 표본을 넉넉히 뽑으므로 구간 크기가 고르게 나옵니다.
+ * - 분류: 분할값을 BFS 순서의 암묵적 이진 트리로 배치하고 j = 2j + (x > tree[j])를 log k번 반복하여
+ *   분기 없이 구간 번호를 구합니다. 원소 4개를 번갈아 분류하여 메모리 지연과 의존성을 겹칩니다.
+ * - 같은 값 구간: 분할값과 같은 원소는 별도의 구간(2i+1)으로 보내며, 이 구간은 정렬할 필요가 없습니다.
+ *   한 값이 매우 많은 치우친 입력도 한 구간에 몰리지 않습니다.
+ * - 분배: 스레드마다 같은 개수의 원소를 분류하며 구간별 개수를 세고, 전역 prefix sum으로 스레드별 쓰기 위치를 정해
+ *   보조 배열로 흩뿌립니다. (입력 순서를 유지하므로 안정 정렬)
+ * - 구간 정렬: 큰 구간부터 동적 스케줄로 여러 스레드가 동시에 기존 quickMergeSort로 정렬합니다.
+ *   병합 단계가 없으므로 병렬 병합 정렬(psort.c)의 직렬화되는 상위 병합 단계가 없습니다.
+ *
+ * 컴파일 예시: gcc -O2 -fopenmp quick_merge.c -o quick_merge
+ * 실행 예시: ./quick_merge 100000000   (1억 개 정수 정렬 벤치마크)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <omp.h>
 
 #define THRESHOLD 16
+#define PARALLEL_THRESHOLD 65536   // 이보다 작은 배열은 순차 quickMergeSort로 정렬
+#define MAX_LOG_BUCKETS 9          // 분할 트리 깊이 상한 (일반 구간 최대 512개)
+#define OVERSAMPLING 16            // 구간당 표본 수
 
 // 삽입 정렬 함수: arr[left..right] 구간을 오름차순 정렬
 void insertionSort(int arr[], int left, int right) {
@@ -97,6 +120,157 @@ void quickMergeSort(int arr[], int n) {
     free(rightArr);
 }
 
+// 분할값 splitters[0..k-2]를 암묵적 이진 트리 tree[1..k-1] (BFS 순서)로 배치
+static void buildTree(int tree[], const int splitters[], int logBuckets) {
+    for (int level = 0; level < logBuckets; level++) {
+        for (int j = 1 << level; j < 2 << level; j++) {
+            int index = (2 * (j - (1 << level)) + 1) << (logBuckets - level - 1);
+            tree[j] = splitters[index - 1];
+        }
+    }
+}
+
+/*
+ * arr[begin..end)의 구간 번호를 oracle에 기록하고 구간별 개수를 count에 더함
+ * 일반 구간 i: splitters[i-1] < x < splitters[i] → 2i, 같은 값 구간: x == splitters[i] → 2i+1
+ */
+static void classifyRange(const int arr[], uint16_t oracle[], size_t begin, size_t end,
+                          const int tree[], const int splitters[], int logBuckets, size_t count[]) {
+    int buckets = 1 << logBuckets;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        int x0 = arr[i], x1 = arr[i + 1], x2 = arr[i + 2], x3 = arr[i + 3];
+        int j0 = 1, j1 = 1, j2 = 1, j3 = 1;
+        for (int level = 0; level < logBuckets; level++) {
+            j0 = 2 * j0 + (x0 > tree[j0]);
+            j1 = 2 * j1 + (x1 > tree[j1]);
+            j2 = 2 * j2 + (x2 > tree[j2]);
+            j3 = 2 * j3 + (x3 > tree[j3]);
+        }
+        j0 -= buckets; j1 -= buckets; j2 -= buckets; j3 -= buckets;
+        int b0 = 2 * j0 + (x0 == splitters[j0]);
+        int b1 = 2 * j1 + (x1 == splitters[j1]);
+        int b2 = 2 * j2 + (x2 == splitters[j2]);
+        int b3 = 2 * j3 + (x3 == splitters[j3]);
+        oracle[i] = (uint16_t)b0;
+        oracle[i + 1] = (uint16_t)b1;
+        oracle[i + 2] = (uint16_t)b2;
+        oracle[i + 3] = (uint16_t)b3;
+        count[b0]++;
+        count[b1]++;
+        count[b2]++;
+        count[b3]++;
+    }
+    for (; i < end; i++) {
+        int x = arr[i], j = 1;
+        for (int level = 0; level < logBuckets; level++)
+            j = 2 * j + (x > tree[j]);
+        j -= buckets;
+        int b = 2 * j + (x == splitters[j]);
+        oracle[i] = (uint16_t)b;
+        count[b]++;
+    }
+}
+
+// 병렬 샘플 정렬: 작거나 스레드가 하나면 순차 quickMergeSort
+void quickMergeSortParallel(int arr[], int n) {
+    int threads = omp_get_max_threads();
+    if (n < PARALLEL_THRESHOLD || threads < 2) {
+        quickMergeSort(arr, n);
+        return;
+    }
+
+    int logBuckets = 1;
+    while ((1 << logBuckets) < 8 * threads && logBuckets < MAX_LOG_BUCKETS)
+        logBuckets++;
+    int buckets = 1 << logBuckets, classes = 2 * buckets;
+
+    // 1) 표본을 정렬해 분할값 선택 (마지막 분할값 INT_MAX는 같은 값 비교용 보초)
+    int sampleSize = buckets * OVERSAMPLING;
+    int *sample = (int *)malloc((size_t)sampleSize * sizeof(int));
+    int *tmp = (int *)malloc((size_t)n * sizeof(int));
+    uint16_t *oracle = (uint16_t *)malloc((size_t)n * sizeof(uint16_t));
+    size_t *counts = (size_t *)calloc((size_t)threads * classes, sizeof(size_t));
+    size_t *bucketStart = (size_t *)malloc(((size_t)classes + 1) * sizeof(size_t));
+    int *order = (int *)malloc((size_t)classes * sizeof(int));
+    if (!sample || !tmp || !oracle || !counts || !bucketStart || !order) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ (uint64_t)n;
+    for (int i = 0; i < sampleSize; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sample[i] = arr[state % (uint64_t)n];
+    }
+    quickMergeSort(sample, sampleSize);
+
+    int splitters[1 << MAX_LOG_BUCKETS], tree[1 << MAX_LOG_BUCKETS];
+    for (int i = 0; i < buckets - 1; i++)
+        splitters[i] = sample[(i + 1) * OVERSAMPLING - 1];
+    splitters[buckets - 1] = INT_MAX;
+    buildTree(tree, splitters, logBuckets);
+    free(sample);
+
+    // 2) 스레드마다 같은 개수의 원소를 분류하고, prefix sum으로 정한 위치에 흩뿌림
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        size_t begin = (size_t)n * t / nt, end = (size_t)n * (t + 1) / nt;
+        size_t *count = counts + (size_t)t * classes;
+        classifyRange(arr, oracle, begin, end, tree, splitters, logBuckets, count);
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            // 구간 순서대로, 같은 구간 안에서는 스레드 순서대로 시작 위치 배정
+            size_t offset = 0;
+            for (int b = 0; b < classes; b++) {
+                bucketStart[b] = offset;
+                for (int u = 0; u < nt; u++) {
+                    size_t c = counts[(size_t)u * classes + b];
+                    counts[(size_t)u * classes + b] = offset;
+                    offset += c;
+                }
+            }
+            bucketStart[classes] = offset;
+        }
+
+        for (size_t i = begin; i < end; i++)
+            tmp[count[oracle[i]]++] = arr[i];
+    }
+
+    // 3) 되돌려 복사한 뒤, 정렬이 필요한 일반 구간을 큰 것부터 동시에 정렬
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (int i = 0; i < n; i++)
+        arr[i] = tmp[i];
+
+    int sortable = 0;
+    for (int b = 0; b < classes; b += 2) {
+        size_t size = bucketStart[b + 1] - bucketStart[b];
+        if (size < 2)
+            continue;
+        int k = sortable++;
+        while (k > 0 && bucketStart[order[k - 1] + 1] - bucketStart[order[k - 1]] < size) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = b;
+    }
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+    for (int r = 0; r < sortable; r++) {
+        int b = order[r];
+        quickMergeSort(arr + bucketStart[b], (int)(bucketStart[b + 1] - bucketStart[b]));
+    }
+
+    free(tmp);
+    free(oracle);
+    free(counts);
+    free(bucketStart);
+    free(order);
+}
+
 // 배열의 요소를 출력하는 함수
 void printArray(int arr[], int n) {
     for (int i = 0; i < n; i++) {
@@ -105,8 +279,51 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 대용량 벤치마크: 순차 quickMergeSort와 스레드 수별 병렬 샘플 정렬 비교 (무작위, 중복 많은 입력)
+static void benchmark(int n) {
+    int *original = (int *)malloc((size_t)n * sizeof(int));
+    int *arr = (int *)malloc((size_t)n * sizeof(int));
+    if (original == NULL || arr == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *names[] = {"무작위", "중복 많음(16종)"};
+    int max_threads = omp_get_max_threads();
+    printf("\n%d개 정수 정렬 (최대 스레드 %d개):\n", n, max_threads);
+    for (int p = 0; p < 2; p++) {
+        unsigned int seed = 12345;
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            original[i] = p == 0 ? (int)(seed >> 1) : (int)((seed >> 16) % 16);
+        }
+        printf(" %s\n", names[p]);
+        for (int threads = 0;; threads = threads * 2 < max_threads ? (threads ? threads * 2 : 1) : max_threads) {
+            memcpy(arr, original, (size_t)n * sizeof(int));
+            double start = omp_get_wtime();
+            if (threads == 0) {
+                quickMergeSort(arr, n);
+            } else {
+                omp_set_num_threads(threads);
+                quickMergeSortParallel(arr, n);
+            }
+            double elapsed = omp_get_wtime() - start;
+            bool sorted = true;
+            for (int i = 1; i < n && sorted; i++)
+                sorted = arr[i - 1] <= arr[i];
+            if (threads == 0)
+                printf("  순차:          %.3f초 %s\n", elapsed, sorted ? "" : "(정렬 실패!)");
+            else
+                printf("  병렬 스레드 %2d개: %.3f초 %s\n", threads, elapsed, sorted ? "" : "(정렬 실패!)");
+            if (threads == max_threads)
+                break;
+        }
+    }
+    free(original);
+    free(arr);
+}
+
 // main 함수: Quick Merge Sort 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {34, 7, 23, 32, 5, 62, 32, 12, 9, 45, 28, 19, 41, 50, 3, 17, 29, 8};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -118,5 +335,7 @@ int main(void) {
     printf("정렬된 배열:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? atoi(argv[1]) : 10000000);
+
     return 0;
 }
\ No newline at end of file
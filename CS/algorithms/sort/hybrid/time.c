@@ -2,82 +2,479 @@
  * time.c
  *
  * 최적화된 하이브리드 정렬(TimSort) 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
- * - 작은 구간은 삽입 정렬로 정렬하고, 이후 병합 정렬 방식으로 구간을 합칩니다.
- * - 최소 구간 길이(MIN_RUN)는 데이터 특성에 따라 조정할 수 있습니다.
+ * - 배열의 요소를 오름차순으로 정렬합니다. (안정 정렬)
+ * - 입력에 이미 존재하는 정렬 구간(run)을 찾아 그대로 활용하고, run들을 병합 정렬 방식으로 합칩니다.
+ * - 짧은 run은 이진 삽입 정렬로 최소 길이(minrun)까지 늘립니다.
  *
- * 참고: 이 구현은 Python의 TimSort 알고리즘의 기본 아이디어를 단순화하여 구현한 예제입니다.
+ * 구성:
+ * - 자연 run 감지: 오름차순(a[i] <= a[i+1]) run은 그대로, 엄격한 내림차순 run은 뒤집어서 사용합니다.
+ *   (엄격한 내림차순만 뒤집으므로 안정성이 유지됩니다.)
+ * - minrun: n을 2의 거듭제곱에 가까운 개수의 run으로 나누도록 n의 상위 6비트 + 나머지 비트 여부로 계산합니다.
+ * - run 스택과 병합 불변식: 스택 위쪽 run 길이 A, B, C(C가 맨 위)에 대해
+ *   A > B + C, B > C가 항상 성립하도록 병합하여 병합 비용이 균형을 이루고 스택 깊이가 O(log n)이 됩니다.
+ *   (바로 아래 run까지 검사하는 수정된 불변식 검사를 사용합니다.)
+ * - 병합 전처리: 두 run 중 이미 제자리에 있는 앞/뒤 부분을 갤러핑(지수 탐색 + 이진 탐색)으로 건너뜁니다.
+ * - 갤러핑 병합: 한쪽 run이 연속으로 MIN_GALLOP번 이상 이기면 갤러핑 모드로 전환해 한 번에 구간 단위로 복사합니다.
+ *   갤러핑이 잘 통하면 기준(minGallop)을 낮추고, 통하지 않으면 높여 적응합니다.
+ * - 임시 버퍼: 두 run 중 짧은 쪽만 복사하며(mergeLo/mergeHi), 정렬 전체에서 버퍼 하나를 필요할 때만 키워 재사용합니다.
+ *
+ * 이미 정렬된 구간들이 이어 붙은 입력(예: 로그 세그먼트)은 run 수를 r이라 할 때 O(n log r)에 가깝게,
+ * 완전히 정렬된 입력은 O(n)에 정렬됩니다.
+ *
+ * 컴파일 예시: gcc -O2 time.c -o time
+ * 실행 예시: ./time 10000000   (1000만 개 벤치마크)
+ *
+ * 참고: 이 구현은 Python(listsort)과 Java의 TimSort 알고리즘을 따릅니다.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
 
-#define MIN_RUN 32
+#define MIN_MERGE 64     // 이보다 짧은 배열은 병합 없이 이진 삽입 정렬
+#define MIN_GALLOP 7     // 갤러핑 모드로 전환하는 초기 연속 승리 횟수
+#define MAX_RUNS 85      // run 스택 최대 깊이 (불변식에 의해 2^64개 원소까지 충분)
 
-// 삽입 정렬 함수: arr[left..right] 구간을 오름차순 정렬
-void insertionSort(int arr[], int left, int right) {
-    for (int i = left + 1; i <= right; i++) {
-        int temp = arr[i];
-        int j = i - 1;
-        while (j >= left && arr[j] > temp) {
-            arr[j + 1] = arr[j];
-            j--;
+// TimSort 상태: 임시 버퍼와 run 스택
+typedef struct {
+    int *a;                  // 정렬 대상 배열
+    int *tmp;                // 병합용 임시 버퍼 (정렬 전체에서 재사용)
+    int tmpCapacity;
+    int minGallop;           // 현재 갤러핑 전환 기준
+    int stackSize;
+    int runBase[MAX_RUNS];   // run 시작 위치
+    int runLen[MAX_RUNS];    // run 길이
+} TimSortState;
+
+// 임시 버퍼를 최소 need 크기로 확보 (부족할 때만 2배씩 키움)
+static int *ensureCapacity(TimSortState *ts, int need) {
+    if (ts->tmpCapacity < need) {
+        int capacity = ts->tmpCapacity > 0 ? ts->tmpCapacity : 256;
+        while (capacity < need)
+            capacity = capacity > 0x3fffffff ? need : capacity * 2;
+        int *grown = (int *)realloc(ts->tmp, (size_t)capacity * sizeof(int));
+        if (grown == NULL) {
+            fprintf(stderr, "timSort: 임시 버퍼 메모리 할당 실패\n");
+            exit(EXIT_FAILURE);
         }
-        arr[j + 1] = temp;
+        ts->tmp = grown;
+        ts->tmpCapacity = capacity;
     }
+    return ts->tmp;
 }
 
-// 병합 함수: arr[l..m]와 arr[m+1..r] 두 개의 정렬된 구간을 병합
-void merge(int arr[], int l, int m, int r) {
-    int len1 = m - l + 1, len2 = r - m;
-    int *leftArr = (int *)malloc(len1 * sizeof(int));
-    int *rightArr = (int *)malloc(len2 * sizeof(int));
+// 이진 삽입 정렬: arr[lo..start)는 이미 정렬되어 있고, arr[start..hi)를 하나씩 삽입 (같은 값은 뒤에: 안정)
+static void binaryInsertionSort(int arr[], int lo, int hi, int start) {
+    if (start == lo)
+        start++;
+    for (; start < hi; start++) {
+        int pivot = arr[start];
+        int left = lo, right = start;
+        while (left < right) {
+            int mid = (left + right) >> 1;
+            if (pivot < arr[mid])
+                right = mid;
+            else
+                left = mid + 1;
+        }
+        memmove(&arr[left + 1], &arr[left], (size_t)(start - left) * sizeof(int));
+        arr[left] = pivot;
+    }
+}
 
-    for (int i = 0; i < len1; i++) {
-        leftArr[i] = arr[l + i];
+// arr[lo..hi)의 앞에서 시작하는 run의 길이를 구하고, 엄격한 내림차순이면 뒤집어 오름차순으로 만듦
+static int countRunAndMakeAscending(int arr[], int lo, int hi) {
+    int runHi = lo + 1;
+    if (runHi == hi)
+        return 1;
+    if (arr[runHi++] < arr[lo]) {
+        while (runHi < hi && arr[runHi] < arr[runHi - 1])
+            runHi++;
+        for (int i = lo, j = runHi - 1; i < j; i++, j--) {
+            int temp = arr[i];
+            arr[i] = arr[j];
+            arr[j] = temp;
+        }
+    } else {
+        while (runHi < hi && arr[runHi] >= arr[runHi - 1])
+            runHi++;
     }
-    for (int j = 0; j < len2; j++) {
-        rightArr[j] = arr[m + 1 + j];
+    return runHi - lo;
+}
+
+// minrun 계산: n < MIN_MERGE가 될 때까지 오른쪽으로 밀면서, 밀려난 비트 중 1이 있으면 1을 더함
+static int computeMinRun(int n) {
+    int r = 0;
+    while (n >= MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
     }
+    return n + r;
+}
 
-    int i = 0, j = 0, k = l;
-    while (i < len1 && j < len2) {
-        if (leftArr[i] <= rightArr[j])
-            arr[k++] = leftArr[i++];
+/*
+ * gallopLeft: 정렬된 a[0..len)에서 key가 들어갈 가장 왼쪽 위치 k (a[k-1] < key <= a[k])
+ * hint 위치부터 1, 3, 7, ... 간격으로 범위를 넓힌 뒤 그 안에서 이진 탐색합니다.
+ */
+static int gallopLeft(int key, const int *a, int len, int hint) {
+    int lastOfs = 0, ofs = 1;
+    if (key > a[hint]) {
+        // 오른쪽으로 갤러핑: a[hint + lastOfs] < key <= a[hint + ofs]
+        int maxOfs = len - hint;
+        while (ofs < maxOfs && key > a[hint + ofs]) {
+            lastOfs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)   // 오버플로
+                ofs = maxOfs;
+        }
+        if (ofs > maxOfs)
+            ofs = maxOfs;
+        lastOfs += hint;
+        ofs += hint;
+    } else {
+        // 왼쪽으로 갤러핑: a[hint - ofs] < key <= a[hint - lastOfs]
+        int maxOfs = hint + 1;
+        while (ofs < maxOfs && key <= a[hint - ofs]) {
+            lastOfs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+                ofs = maxOfs;
+        }
+        if (ofs > maxOfs)
+            ofs = maxOfs;
+        int temp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - temp;
+    }
+    // a[lastOfs] < key <= a[ofs] 범위에서 이진 탐색
+    lastOfs++;
+    while (lastOfs < ofs) {
+        int m = lastOfs + ((ofs - lastOfs) >> 1);
+        if (key > a[m])
+            lastOfs = m + 1;
         else
-            arr[k++] = rightArr[j++];
+            ofs = m;
+    }
+    return ofs;
+}
+
+// gallopRight: 정렬된 a[0..len)에서 key가 들어갈 가장 오른쪽 위치 k (a[k-1] <= key < a[k])
+static int gallopRight(int key, const int *a, int len, int hint) {
+    int lastOfs = 0, ofs = 1;
+    if (key < a[hint]) {
+        // 왼쪽으로 갤러핑: a[hint - ofs] <= key < a[hint - lastOfs]
+        int maxOfs = hint + 1;
+        while (ofs < maxOfs && key < a[hint - ofs]) {
+            lastOfs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+                ofs = maxOfs;
+        }
+        if (ofs > maxOfs)
+            ofs = maxOfs;
+        int temp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - temp;
+    } else {
+        // 오른쪽으로 갤러핑: a[hint + lastOfs] <= key < a[hint + ofs]
+        int maxOfs = len - hint;
+        while (ofs < maxOfs && key >= a[hint + ofs]) {
+            lastOfs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0)
+                ofs = maxOfs;
+        }
+        if (ofs > maxOfs)
+            ofs = maxOfs;
+        lastOfs += hint;
+        ofs += hint;
+    }
+    lastOfs++;
+    while (lastOfs < ofs) {
+        int m = lastOfs + ((ofs - lastOfs) >> 1);
+        if (key < a[m])
+            ofs = m;
+        else
+            lastOfs = m + 1;
+    }
+    return ofs;
+}
+
+/*
+ * mergeLo: 인접한 run a[base1..base1+len1)과 a[base2..base2+len2)를 앞에서부터 병합 (len1 <= len2)
+ * 전제: a[base2] < a[base1] (첫 원소는 run2에서 나옴), run1의 마지막 원소 > run2의 모든 원소 (마지막 원소는 run1에서 나옴)
+ * 짧은 run1만 임시 버퍼로 복사합니다.
+ */
+static void mergeLo(TimSortState *ts, int base1, int len1, int base2, int len2) {
+    int *a = ts->a;
+    int *tmp = ensureCapacity(ts, len1);
+    memcpy(tmp, a + base1, (size_t)len1 * sizeof(int));
+
+    int cursor1 = 0, cursor2 = base2, dest = base1;
+    a[dest++] = a[cursor2++];
+    if (--len2 == 0) {
+        memcpy(a + dest, tmp + cursor1, (size_t)len1 * sizeof(int));
+        return;
+    }
+    if (len1 == 1) {
+        memmove(a + dest, a + cursor2, (size_t)len2 * sizeof(int));
+        a[dest + len2] = tmp[cursor1];
+        return;
+    }
+
+    int minGallop = ts->minGallop;
+    for (;;) {
+        int count1 = 0, count2 = 0;   // 각 run이 연속으로 이긴 횟수
+
+        // 한 원소씩 병합하다가 한쪽이 계속 이기면 갤러핑으로 전환
+        do {
+            if (a[cursor2] < tmp[cursor1]) {
+                a[dest++] = a[cursor2++];
+                count2++;
+                count1 = 0;
+                if (--len2 == 0)
+                    goto done;
+            } else {
+                a[dest++] = tmp[cursor1++];
+                count1++;
+                count2 = 0;
+                if (--len1 == 1)
+                    goto done;
+            }
+        } while ((count1 | count2) < minGallop);
+
+        // 갤러핑 모드: 상대 run의 다음 원소가 들어갈 위치까지 한 번에 복사
+        do {
+            count1 = gallopRight(a[cursor2], tmp + cursor1, len1, 0);
+            if (count1 != 0) {
+                memcpy(a + dest, tmp + cursor1, (size_t)count1 * sizeof(int));
+                dest += count1;
+                cursor1 += count1;
+                len1 -= count1;
+                if (len1 <= 1)
+                    goto done;
+            }
+            a[dest++] = a[cursor2++];
+            if (--len2 == 0)
+                goto done;
+
+            count2 = gallopLeft(tmp[cursor1], a + cursor2, len2, 0);
+            if (count2 != 0) {
+                memmove(a + dest, a + cursor2, (size_t)count2 * sizeof(int));
+                dest += count2;
+                cursor2 += count2;
+                len2 -= count2;
+                if (len2 == 0)
+                    goto done;
+            }
+            a[dest++] = tmp[cursor1++];
+            if (--len1 == 1)
+                goto done;
+            minGallop--;
+        } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+        if (minGallop < 0)
+            minGallop = 0;
+        minGallop += 2;   // 갤러핑에서 빠져나오면 다시 들어가기 어렵게
+    }
+
+done:
+    ts->minGallop = minGallop < 1 ? 1 : minGallop;
+    if (len1 == 1) {
+        // run1의 마지막 원소가 가장 크므로 run2 나머지를 옮긴 뒤 맨 끝에 둠
+        memmove(a + dest, a + cursor2, (size_t)len2 * sizeof(int));
+        a[dest + len2] = tmp[cursor1];
+    } else {
+        memcpy(a + dest, tmp + cursor1, (size_t)len1 * sizeof(int));
+    }
+}
+
+/*
+ * mergeHi: mergeLo와 대칭으로 뒤에서부터 병합 (len1 >= len2)
+ * 짧은 run2만 임시 버퍼로 복사합니다.
+ */
+static void mergeHi(TimSortState *ts, int base1, int len1, int base2, int len2) {
+    int *a = ts->a;
+    int *tmp = ensureCapacity(ts, len2);
+    memcpy(tmp, a + base2, (size_t)len2 * sizeof(int));
+
+    int cursor1 = base1 + len1 - 1, cursor2 = len2 - 1, dest = base2 + len2 - 1;
+    a[dest--] = a[cursor1--];
+    if (--len1 == 0) {
+        memcpy(a + dest - (len2 - 1), tmp, (size_t)len2 * sizeof(int));
+        return;
+    }
+    if (len2 == 1) {
+        dest -= len1;
+        cursor1 -= len1;
+        memmove(a + dest + 1, a + cursor1 + 1, (size_t)len1 * sizeof(int));
+        a[dest] = tmp[cursor2];
+        return;
     }
-    while (i < len1) {
-        arr[k++] = leftArr[i++];
+
+    int minGallop = ts->minGallop;
+    for (;;) {
+        int count1 = 0, count2 = 0;
+
+        do {
+            if (tmp[cursor2] < a[cursor1]) {
+                a[dest--] = a[cursor1--];
+                count1++;
+                count2 = 0;
+                if (--len1 == 0)
+                    goto done;
+            } else {
+                a[dest--] = tmp[cursor2--];
+                count2++;
+                count1 = 0;
+                if (--len2 == 1)
+                    goto done;
+            }
+        } while ((count1 | count2) < minGallop);
+
+        do {
+            count1 = len1 - gallopRight(tmp[cursor2], a + base1, len1, len1 - 1);
+            if (count1 != 0) {
+                dest -= count1;
+                cursor1 -= count1;
+                len1 -= count1;
+                memmove(a + dest + 1, a + cursor1 + 1, (size_t)count1 * sizeof(int));
+                if (len1 == 0)
+                    goto done;
+            }
+            a[dest--] = tmp[cursor2--];
+            if (--len2 == 1)
+                goto done;
+
+            count2 = len2 - gallopLeft(a[cursor1], tmp, len2, len2 - 1);
+            if (count2 != 0) {
+                dest -= count2;
+                cursor2 -= count2;
+                len2 -= count2;
+                memcpy(a + dest + 1, tmp + cursor2 + 1, (size_t)count2 * sizeof(int));
+                if (len2 <= 1)
+                    goto done;
+            }
+            a[dest--] = a[cursor1--];
+            if (--len1 == 0)
+                goto done;
+            minGallop--;
+        } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+        if (minGallop < 0)
+            minGallop = 0;
+        minGallop += 2;
     }
-    while (j < len2) {
-        arr[k++] = rightArr[j++];
+
+done:
+    ts->minGallop = minGallop < 1 ? 1 : minGallop;
+    if (len2 == 1) {
+        // run2의 첫 원소가 가장 작으므로 run1 나머지를 옮긴 뒤 맨 앞에 둠
+        dest -= len1;
+        cursor1 -= len1;
+        memmove(a + dest + 1, a + cursor1 + 1, (size_t)len1 * sizeof(int));
+        a[dest] = tmp[cursor2];
+    } else {
+        memcpy(a + dest - (len2 - 1), tmp, (size_t)len2 * sizeof(int));
     }
+}
+
+// 스택의 i번째와 i+1번째 run을 병합 (i는 맨 위에서 두 번째 또는 세 번째)
+static void mergeAt(TimSortState *ts, int i) {
+    int *a = ts->a;
+    int base1 = ts->runBase[i], len1 = ts->runLen[i];
+    int base2 = ts->runBase[i + 1], len2 = ts->runLen[i + 1];
+
+    ts->runLen[i] = len1 + len2;
+    if (i == ts->stackSize - 3) {
+        ts->runBase[i + 1] = ts->runBase[i + 2];
+        ts->runLen[i + 1] = ts->runLen[i + 2];
+    }
+    ts->stackSize--;
+
+    // run2의 첫 원소보다 작거나 같은 run1의 앞부분은 이미 제자리
+    int k = gallopRight(a[base2], a + base1, len1, 0);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0)
+        return;
+
+    // run1의 마지막 원소보다 크거나 같은 run2의 뒷부분도 이미 제자리
+    len2 = gallopLeft(a[base1 + len1 - 1], a + base2, len2, len2 - 1);
+    if (len2 == 0)
+        return;
 
-    free(leftArr);
-    free(rightArr);
+    if (len1 <= len2)
+        mergeLo(ts, base1, len1, base2, len2);
+    else
+        mergeHi(ts, base1, len1, base2, len2);
+}
+
+/*
+ * 병합 불변식 유지: 스택 위쪽 run 길이 X, Y, Z, W(W가 맨 위)에 대해
+ * Y > Z + W, X > Y + Z, Z > W가 성립할 때까지 병합 (길이가 비슷한 run끼리 병합되도록 작은 쪽 이웃과 병합)
+ */
+static void mergeCollapse(TimSortState *ts) {
+    while (ts->stackSize > 1) {
+        int n = ts->stackSize - 2;
+        if ((n > 0 && ts->runLen[n - 1] <= ts->runLen[n] + ts->runLen[n + 1]) ||
+            (n > 1 && ts->runLen[n - 2] <= ts->runLen[n - 1] + ts->runLen[n])) {
+            if (ts->runLen[n - 1] < ts->runLen[n + 1])
+                n--;
+        } else if (ts->runLen[n] > ts->runLen[n + 1]) {
+            break;   // 불변식 성립
+        }
+        mergeAt(ts, n);
+    }
+}
+
+// 남은 run을 모두 병합
+static void mergeForceCollapse(TimSortState *ts) {
+    while (ts->stackSize > 1) {
+        int n = ts->stackSize - 2;
+        if (n > 0 && ts->runLen[n - 1] < ts->runLen[n + 1])
+            n--;
+        mergeAt(ts, n);
+    }
 }
 
 // TimSort 함수: 배열 전체를 정렬
 void timSort(int arr[], int n) {
-    // 1단계: MIN_RUN 크기의 작은 구간들에 대해 삽입 정렬 수행
-    for (int i = 0; i < n; i += MIN_RUN) {
-        int right = i + MIN_RUN - 1;
-        if (right >= n)
-            right = n - 1;
-        insertionSort(arr, i, right);
-    }
-
-    // 2단계: 정렬된 구간들을 병합하여 전체 정렬을 완성
-    for (int size = MIN_RUN; size < n; size *= 2) {
-        for (int left = 0; left < n; left += 2 * size) {
-            int mid = left + size - 1;
-            if (mid >= n - 1)
-                continue;
-            int right = (left + 2 * size - 1 < n) ? left + 2 * size - 1 : n - 1;
-            merge(arr, left, mid, right);
-        }
+    if (n < 2)
+        return;
+
+    // 짧은 배열: 첫 run을 찾은 뒤 나머지를 이진 삽입 정렬
+    if (n < MIN_MERGE) {
+        int initRunLen = countRunAndMakeAscending(arr, 0, n);
+        binaryInsertionSort(arr, 0, n, initRunLen);
+        return;
     }
+
+    TimSortState ts = {.a = arr, .tmp = NULL, .tmpCapacity = 0, .minGallop = MIN_GALLOP, .stackSize = 0};
+    int minRun = computeMinRun(n);
+    int lo = 0, remaining = n;
+    do {
+        // 다음 자연 run을 찾고, minRun보다 짧으면 이진 삽입 정렬로 늘림
+        int runLen = countRunAndMakeAscending(arr, lo, n);
+        if (runLen < minRun) {
+            int force = remaining <= minRun ? remaining : minRun;
+            binaryInsertionSort(arr, lo, lo + force, lo + runLen);
+            runLen = force;
+        }
+
+        // run을 스택에 넣고 불변식이 깨졌으면 병합
+        ts.runBase[ts.stackSize] = lo;
+        ts.runLen[ts.stackSize] = runLen;
+        ts.stackSize++;
+        mergeCollapse(&ts);
+
+        lo += runLen;
+        remaining -= runLen;
+    } while (remaining != 0);
+
+    mergeForceCollapse(&ts);
+    free(ts.tmp);
 }
 
 // 배열의 요소를 출력하는 유틸리티 함수
@@ -88,8 +485,75 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 벤치마크용 비교 함수 (qsort)
+static int compareInt(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 대용량 벤치마크: 입력 패턴별로 timSort와 qsort 비교
+static void benchmark(int n) {
+    int *arr = (int *)malloc((size_t)n * sizeof(int));
+    int *expected = (int *)malloc((size_t)n * sizeof(int));
+    if (arr == NULL || expected == NULL) {
+        fprintf(stderr, "benchmark: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const char *patterns[] = {"무작위", "정렬됨", "역순", "정렬된 세그먼트 64개", "거의 정렬됨(0.1% 교환)"};
+    printf("\n%d개 정수 정렬 (timSort / qsort):\n", n);
+    for (int p = 0; p < 5; p++) {
+        uint64_t state = 88172645463325252ULL;
+        int segment = n / 64 > 0 ? n / 64 : 1;
+        for (int i = 0; i < n; i++) {
+            switch (p) {
+            case 0: arr[i] = (int)nextRandom(&state); break;
+            case 1: arr[i] = i; break;
+            case 2: arr[i] = n - i; break;
+            case 3: arr[i] = (i % segment) * 64 + (int)(nextRandom(&state) % 64); // 세그먼트마다 시각이 증가하는 로그
+                    if (i % segment != 0 && arr[i] < arr[i - 1])
+                        arr[i] = arr[i - 1];
+                    break;
+            default: arr[i] = i; break;
+            }
+        }
+        if (p == 4) {
+            for (int k = 0; k < n / 1000; k++) {
+                int i = (int)(nextRandom(&state) % (uint64_t)n), j = (int)(nextRandom(&state) % (uint64_t)n);
+                int temp = arr[i];
+                arr[i] = arr[j];
+                arr[j] = temp;
+            }
+        }
+        memcpy(expected, arr, (size_t)n * sizeof(int));
+        double start = nowSeconds();
+        timSort(arr, n);
+        double tim_time = nowSeconds() - start;
+        start = nowSeconds();
+        qsort(expected, (size_t)n, sizeof(int), compareInt);
+        double qsort_time = nowSeconds() - start;
+        bool ok = memcmp(arr, expected, (size_t)n * sizeof(int)) == 0;
+        printf("  %-26s %.3f초 / %.3f초 %s\n", patterns[p], tim_time, qsort_time, ok ? "" : "(정렬 실패!)");
+    }
+    free(arr);
+    free(expected);
+}
+
 // main 함수: TimSort 데모
-int main(void) {
+int main(int argc, char *argv[]) {
     int arr[] = {5, 21, 7, 23, 19, 10, 15, 3, 8, 12, 2, 18};
     int n = sizeof(arr) / sizeof(arr[0]);
 
@@ -101,5 +565,7 @@ int main(void) {
     printf("정렬된 배열:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? atoi(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
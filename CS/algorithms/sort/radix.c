@@ -2,65 +2,220 @@
  * radix.c
  *
  * 최적화된 기수 정렬 (Radix Sort) 구현 예제
- * - 배열의 요소를 오름차순으로 정렬합니다.
- * - 각 자릿수별로 안정적인 계수 정렬(Counting Sort)을 활용하여 전체 정렬을 수행합니다.
+ * - 배열의 요소를 오름차순으로 정렬합니다. (음수 포함, 부호 있는 32/64비트 정수)
+ * - 각 자릿수별로 안정적인 계수 정렬(Counting Sort)을 활용하여 전체 정렬을 수행합니다. (LSD 방식)
+ *
+ * 최적화:
+ * - 10진수 대신 2진 자릿수 사용: 32비트 key는 11비트 자릿수 3번, 64비트 key는 8비트 자릿수 8번 패스.
+ *   (10진수로는 32비트 정수에 최대 10번 패스가 필요합니다.)
+ * - 부호 처리: 최상위 비트를 뒤집으면(k ^ 0x80000000) 부호 있는 정수의 순서가 부호 없는 순서와 같아지므로,
+ *   자릿수를 뽑을 때 XOR 한 번으로 처리합니다. (별도 패스 없음)
+ * - 첫 패스에서 모든 자릿수의 전체 빈도를 한 번에 세고, 모든 key가 같은 값을 갖는 자릿수 패스는 건너뜁니다.
+ * - 병렬화 (OpenMP): 스레드마다 자기 구간의 히스토그램을 만들고, 자릿수별로 "앞 자릿수의 총합 +
+ *   앞 스레드들의 빈도"를 병렬로 누적하여 스레드별 쓰기 시작 위치를 구합니다. 같은 자릿수 안에서
+ *   앞 스레드의 원소가 먼저 놓이므로 정렬은 안정적입니다.
+ * - 쓰기 결합(write-combining) 버퍼: 자릿수마다 캐시 라인(64바이트) 하나 크기의 버퍼에 모았다가
+ *   가득 차면 한 번에 복사합니다. 흩어진 위치에 원소를 하나씩 쓰는 것보다 캐시/TLB 미스가 크게 줄어듭니다.
+ * - key/value 쌍 정렬 지원: 정렬된 key 순서대로 value(예: 행 번호)도 함께 이동합니다.
+ * - 보조 버퍼는 정렬마다 한 번만 할당하고, 패스마다 원본 ↔ 보조 버퍼를 번갈아 사용합니다.
+ *
+ * 컴파일 예시: gcc -O2 -fopenmp radix.c -o radix
+ * 실행 예시: ./radix 10000000   (1000만 개 벤치마크)
+ *
+ * 다른 예제에서 정렬 함수만 쓰려면 RADIX_SORT_LIBRARY를 정의하고 포함합니다. (counting.c, bucket.c의 대체 경로)
+ * 여러 번 포함되어도 정렬 함수는 한 번만 정의됩니다.
  */
 
+#ifndef RADIX_SORT_C
+#define RADIX_SORT_C
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <omp.h>
+
+#define RADIX_BITS_32 11            // 32비트 key: 2048개 버킷 × 3패스
+#define RADIX_BITS_64 8             // 64비트 key: 256개 버킷 × 8패스 (쓰기 결합 버퍼가 L1/L2에 들어가도록)
+#define WC_BYTES 64                 // 쓰기 결합 버퍼 하나의 크기 (캐시 라인)
+#define RADIX_PARALLEL_MIN 65536    // 이보다 작은 배열은 한 스레드로 정렬
 
-// 배열에서 최대 값을 찾아 반환하는 함수
-int getMax(int arr[], int n) {
-    int max = arr[0];
-    for (int i = 1; i < n; i++) {
-        if (arr[i] > max)
-            max = arr[i];
+// 메모리 할당 (실패하면 종료)
+static void *radixAlloc(size_t bytes) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        fprintf(stderr, "radixSort: 메모리 할당 실패\n");
+        exit(EXIT_FAILURE);
     }
-    return max;
+    return p;
 }
 
-// exp는 10^i (i번째 자릿수)를 의미하며, 해당 자릿수를 기준으로 배열을 정렬합니다.
-void countSort(int arr[], int n, int exp) {
-    int *output = (int *)malloc(n * sizeof(int));
-    int count[10] = {0};
+/*
+ * 정렬 함수 생성 매크로: key/value 타입마다 같은 알고리즘을 인스턴스화합니다.
+ * values가 NULL이면 key만 정렬합니다.
+ *
+ * 각 패스:
+ *  1) 스레드별 히스토그램: hist[t][d] = 스레드 t 구간에서 자릿수가 d인 원소 수
+ *  2) 시작 위치: base[d] = 자릿수 d보다 작은 원소 수 (전체 빈도의 배타적 누적합),
+ *     hist[t][d] ← base[d] + Σ(t' < t) hist[t'][d]   (자릿수별로 병렬)
+ *  3) 분배: 쓰기 결합 버퍼를 거쳐 dst[hist[t][d]...]에 순서대로 기록
+ */
+#define DEFINE_RADIX_SORT(NAME, KEY_T, VAL_T, KEY_BITS, DIGIT_BITS)                                   \
+static void NAME(KEY_T *keys, VAL_T *values, size_t n) {                                               \
+    enum { RADIX = 1 << (DIGIT_BITS), LINE = WC_BYTES / sizeof(KEY_T),                                 \
+           PASSES = ((KEY_BITS) + (DIGIT_BITS) - 1) / (DIGIT_BITS) };                                  \
+    const KEY_T sign = (KEY_T)1 << ((KEY_BITS) - 1);                                                   \
+    if (n < 2)                                                                                         \
+        return;                                                                                        \
+    int max_threads = n >= RADIX_PARALLEL_MIN ? omp_get_max_threads() : 1;                             \
+    KEY_T *key_buf = (KEY_T *)radixAlloc(n * sizeof(KEY_T));                                           \
+    VAL_T *val_buf = values ? (VAL_T *)radixAlloc(n * sizeof(VAL_T)) : NULL;                           \
+    size_t *global = (size_t *)calloc((size_t)PASSES * RADIX, sizeof(size_t));                         \
+    size_t *local = (size_t *)radixAlloc(sizeof(size_t) * max_threads * PASSES * RADIX);               \
+    size_t *hist = (size_t *)radixAlloc(sizeof(size_t) * max_threads * RADIX);                         \
+    size_t *base = (size_t *)radixAlloc(sizeof(size_t) * RADIX);                                       \
+    if (global == NULL) {                                                                              \
+        fprintf(stderr, "radixSort: 메모리 할당 실패\n");                                               \
+        exit(EXIT_FAILURE);                                                                            \
+    }                                                                                                  \
+    KEY_T *src = keys, *dst = key_buf;                                                                 \
+    VAL_T *vsrc = values, *vdst = val_buf;                                                             \
+                                                                                                       \
+    _Pragma("omp parallel num_threads(max_threads)")                                                   \
+    {                                                                                                  \
+        int t = omp_get_thread_num(), threads = omp_get_num_threads();                                 \
+        size_t lo = n * t / threads, hi = n * (t + 1) / threads;                                       \
+        KEY_T *wc_key = (KEY_T *)radixAlloc(sizeof(KEY_T) * RADIX * LINE);                             \
+        VAL_T *wc_val = values ? (VAL_T *)radixAlloc(sizeof(VAL_T) * RADIX * LINE) : NULL;             \
+        int *wc_count = (int *)radixAlloc(sizeof(int) * RADIX);                                        \
+                                                                                                       \
+        /* 모든 패스의 전체 빈도를 한 번의 읽기로 계산 (건너뛸 패스 판단용) */                         \
+        size_t *mine = local + (size_t)t * PASSES * RADIX;                                             \
+        memset(mine, 0, sizeof(size_t) * PASSES * RADIX);                                              \
+        for (size_t i = lo; i < hi; i++) {                                                             \
+            KEY_T k = src[i] ^ sign;                                                                   \
+            for (int p = 0; p < PASSES; p++)                                                           \
+                mine[p * RADIX + ((k >> (p * (DIGIT_BITS))) & (RADIX - 1))]++;                         \
+        }                                                                                              \
+        _Pragma("omp barrier")                                                                         \
+        _Pragma("omp for")                                                                             \
+        for (size_t j = 0; j < (size_t)PASSES * RADIX; j++)                                            \
+            for (int u = 0; u < threads; u++)                                                          \
+                global[j] += local[(size_t)u * PASSES * RADIX + j];                                    \
+                                                                                                       \
+        for (int p = 0; p < PASSES; p++) {                                                             \
+            const int shift = p * (DIGIT_BITS);                                                        \
+            const size_t *total = global + (size_t)p * RADIX;                                          \
+            /* 모든 key의 자릿수가 같으면 순서가 바뀌지 않으므로 건너뜀 (모든 스레드가 같은 판단) */     \
+            if (total[((src[0] ^ sign) >> shift) & (RADIX - 1)] == n)                                  \
+                continue;                                                                              \
+                                                                                                       \
+            size_t *off = hist + (size_t)t * RADIX;                                                    \
+            memset(off, 0, sizeof(size_t) * RADIX);                                                    \
+            for (size_t i = lo; i < hi; i++)                                                           \
+                off[((src[i] ^ sign) >> shift) & (RADIX - 1)]++;                                       \
+            _Pragma("omp single")                                                                      \
+            {                                                                                          \
+                size_t sum = 0;                                                                        \
+                for (int d = 0; d < RADIX; d++) {                                                      \
+                    base[d] = sum;                                                                     \
+                    sum += total[d];                                                                   \
+                }                                                                                      \
+            }                                                                                          \
+            _Pragma("omp for")                                                                         \
+            for (int d = 0; d < RADIX; d++) {                                                          \
+                size_t pos = base[d];                                                                  \
+                for (int u = 0; u < threads; u++) {                                                    \
+                    size_t count = hist[(size_t)u * RADIX + d];                                        \
+                    hist[(size_t)u * RADIX + d] = pos;                                                 \
+                    pos += count;                                                                      \
+                }                                                                                      \
+            }                                                                                          \
+                                                                                                       \
+            memset(wc_count, 0, sizeof(int) * RADIX);                                                  \
+            for (size_t i = lo; i < hi; i++) {                                                         \
+                KEY_T k = src[i];                                                                      \
+                int d = (int)(((k ^ sign) >> shift) & (RADIX - 1));                                    \
+                int c = wc_count[d];                                                                   \
+                wc_key[d * LINE + c] = k;                                                              \
+                if (vsrc)                                                                              \
+                    wc_val[d * LINE + c] = vsrc[i];                                                    \
+                if (++c == LINE) {                                                                     \
+                    memcpy(dst + off[d], wc_key + d * LINE, sizeof(KEY_T) * LINE);                     \
+                    if (vsrc)                                                                          \
+                        memcpy(vdst + off[d], wc_val + d * LINE, sizeof(VAL_T) * LINE);                \
+                    off[d] += LINE;                                                                    \
+                    c = 0;                                                                             \
+                }                                                                                      \
+                wc_count[d] = c;                                                                       \
+            }                                                                                          \
+            for (int d = 0; d < RADIX; d++) {                                                          \
+                if (wc_count[d] == 0)                                                                  \
+                    continue;                                                                          \
+                memcpy(dst + off[d], wc_key + d * LINE, sizeof(KEY_T) * wc_count[d]);                  \
+                if (vsrc)                                                                              \
+                    memcpy(vdst + off[d], wc_val + d * LINE, sizeof(VAL_T) * wc_count[d]);             \
+            }                                                                                          \
+            _Pragma("omp barrier")                                                                     \
+            _Pragma("omp single")                                                                      \
+            {                                                                                          \
+                KEY_T *tk = src; src = dst; dst = tk;                                                  \
+                VAL_T *tv = vsrc; vsrc = vdst; vdst = tv;                                              \
+            }                                                                                          \
+        }                                                                                              \
+                                                                                                       \
+        /* 홀수 번 분배했으면 결과가 보조 버퍼에 있으므로 원래 배열로 복사 */                            \
+        if (src != keys) {                                                                             \
+            memcpy(keys + lo, src + lo, sizeof(KEY_T) * (hi - lo));                                    \
+            if (values)                                                                                \
+                memcpy(values + lo, vsrc + lo, sizeof(VAL_T) * (hi - lo));                             \
+        }                                                                                              \
+        free(wc_key);                                                                                  \
+        free(wc_val);                                                                                  \
+        free(wc_count);                                                                                \
+    }                                                                                                  \
+    free(key_buf);                                                                                     \
+    free(val_buf);                                                                                     \
+    free(global);                                                                                      \
+    free(local);                                                                                       \
+    free(hist);                                                                                        \
+    free(base);                                                                                        \
+}
 
-    // 각 자릿수의 발생 빈도 계산
-    for (int i = 0; i < n; i++) {
-        int digit = (arr[i] / exp) % 10;
-        count[digit]++;
-    }
+DEFINE_RADIX_SORT(radixSortU32, uint32_t, uint32_t, 32, RADIX_BITS_32)
+DEFINE_RADIX_SORT(radixSortU64, uint64_t, uint64_t, 64, RADIX_BITS_64)
 
-    // count 배열을 누적 합으로 변환하여 실제 위치 계산
-    for (int i = 1; i < 10; i++) {
-        count[i] += count[i - 1];
-    }
+// 부호 있는 32비트 정수 정렬
+void radixSortInt32(int32_t keys[], size_t n) {
+    radixSortU32((uint32_t *)keys, NULL, n);
+}
 
-    // 안정적인 정렬을 위해 뒤에서부터 순회하면서 출력 배열 구성
-    for (int i = n - 1; i >= 0; i--) {
-        int digit = (arr[i] / exp) % 10;
-        output[count[digit] - 1] = arr[i];
-        count[digit]--;
-    }
+// 부호 있는 32비트 key와 value 쌍 정렬 (같은 key는 원래 순서 유지)
+void radixSortPairsInt32(int32_t keys[], uint32_t values[], size_t n) {
+    radixSortU32((uint32_t *)keys, values, n);
+}
 
-    // 정렬된 결과를 원본 배열에 복사
-    for (int i = 0; i < n; i++) {
-        arr[i] = output[i];
-    }
+// 부호 있는 64비트 정수 정렬
+void radixSortInt64(int64_t keys[], size_t n) {
+    radixSortU64((uint64_t *)keys, NULL, n);
+}
 
-    free(output);
+// 부호 있는 64비트 key와 value 쌍 정렬
+void radixSortPairsInt64(int64_t keys[], uint64_t values[], size_t n) {
+    radixSortU64((uint64_t *)keys, values, n);
 }
 
-// 기수 정렬 함수: 배열의 모든 자릿수에 대해 계수 정렬을 수행합니다.
+// 기수 정렬 함수: int 배열 전체를 정렬합니다. (음수 포함)
 void radixSort(int arr[], int n) {
-    // 배열의 최대값을 구하여, 정렬할 자릿수 범위를 결정합니다.
-    int max = getMax(arr, n);
-
-    // 1의 자리부터 시작해 자릿수가 있을 때까지 계수 정렬 수행
-    for (int exp = 1; max / exp > 0; exp *= 10) {
-        countSort(arr, n, exp);
-    }
+    if (n <= 0) return;
+    radixSortInt32((int32_t *)arr, (size_t)n);
 }
 
+#endif /* RADIX_SORT_C */
+
+#ifndef RADIX_SORT_LIBRARY
+
 // 배열의 요소를 출력하는 유틸리티 함수
 void printArray(int arr[], int n) {
     for (int i = 0; i < n; i++) {
@@ -69,9 +224,67 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
+// 벤치마크용 비교 함수 (qsort)
+static int compareInt32(const void *a, const void *b) {
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 대용량 벤치마크: n개의 난수(음수 포함)를 기수 정렬과 qsort로 정렬해 비교
+static void benchmark(size_t n) {
+    int32_t *keys = (int32_t *)radixAlloc(n * sizeof(int32_t));
+    int32_t *expected = (int32_t *)radixAlloc(n * sizeof(int32_t));
+    uint32_t *rows = (uint32_t *)radixAlloc(n * sizeof(uint32_t));
+    int64_t *keys64 = (int64_t *)radixAlloc(n * sizeof(int64_t));
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = expected[i] = (int32_t)nextRandom(&state);
+        keys64[i] = (int64_t)nextRandom(&state);
+        rows[i] = (uint32_t)i;
+    }
+
+    printf("\n%zu개 정렬 (스레드 %d개):\n", n, omp_get_max_threads());
+    double start = omp_get_wtime();
+    qsort(expected, n, sizeof(int32_t), compareInt32);
+    double qsort_time = omp_get_wtime() - start;
+
+    // key/value 쌍: 행 번호가 key를 따라 이동했는지로 정렬 결과를 함께 검증
+    int32_t *original = (int32_t *)radixAlloc(n * sizeof(int32_t));
+    memcpy(original, keys, n * sizeof(int32_t));
+    start = omp_get_wtime();
+    radixSortPairsInt32(keys, rows, n);
+    double radix_time = omp_get_wtime() - start;
+    bool ok = memcmp(keys, expected, n * sizeof(int32_t)) == 0;
+    for (size_t i = 0; i < n && ok; i++)
+        ok = original[rows[i]] == keys[i] && (i == 0 || keys[i - 1] != keys[i] || rows[i - 1] < rows[i]);
+    printf("  int32 key/value: 기수 정렬 %.3f초, qsort(key만) %.3f초 %s\n",
+           radix_time, qsort_time, ok ? "" : "(정렬 실패!)");
+
+    start = omp_get_wtime();
+    radixSortInt64(keys64, n);
+    radix_time = omp_get_wtime() - start;
+    ok = true;
+    for (size_t i = 1; i < n && ok; i++)
+        ok = keys64[i - 1] <= keys64[i];
+    printf("  int64: 기수 정렬 %.3f초 %s\n", radix_time, ok ? "" : "(정렬 실패!)");
+
+    free(keys);
+    free(expected);
+    free(rows);
+    free(keys64);
+    free(original);
+}
+
 // main 함수: 기수 정렬 데모
-int main(void) {
-    int arr[] = {170, 45, 75, 90, 802, 24, 2, 66};
+int main(int argc, char *argv[]) {
+    int arr[] = {170, 45, 75, 90, 802, 24, 2, 66, -13, -802, 0, 2147483647, -2147483647 - 1};
     int n = sizeof(arr) / sizeof(arr[0]);
 
     printf("Original array:\n");
@@ -82,5 +295,9 @@ int main(void) {
     printf("Sorted array:\n");
     printArray(arr, n);
 
+    benchmark(argc > 1 ? (size_t)atol(argv[1]) : 10000000);
+
     return 0;
-}
\ No newline at end of file
+}
+
+#endif /* RADIX_SORT_LIBRARY */